@@ -11,5 +11,8 @@ public class EscapeGameTarget : TargetRules
 		DefaultBuildSettings = BuildSettingsVersion.V5;
 		IncludeOrderVersion = EngineIncludeOrderVersion.Unreal5_6;
 		ExtraModuleNames.Add("EscapeGame");
+
+		// HP and other rarely changing state only replicate when marked dirty
+		bWithPushModel = true;
 	}
 }
@@ -0,0 +1,353 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "AIPlayerInfoSubsystem.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/World.h"
+#include "Math/VectorRegister.h"
+
+int32 UAIPlayerInfoSubsystem::RegisterAgent(const AActor* Agent)
+{
+	if (!IsValid(Agent))
+	{
+		return INDEX_NONE;
+	}
+
+	int32 Handle;
+
+	// reuse a free handle if we have one
+	if (FreeHandles.Num() > 0)
+	{
+		Handle = FreeHandles.Pop(EAllowShrinking::No);
+		Agents[Handle] = Agent;
+	}
+	else
+	{
+		Handle = Agents.Add(Agent);
+		RangeWatches.AddDefaulted();
+		Tracks.AddDefaulted();
+
+		// grow by a full set of lanes at a time, so loads never read past the end of the arrays
+		if (Handle % LaneWidth == 0)
+		{
+			AgentX.AddZeroed(LaneWidth);
+			AgentY.AddZeroed(LaneWidth);
+			AgentZ.AddZeroed(LaneWidth);
+			Distances.AddZeroed(LaneWidth);
+			NearestPlayers.AddZeroed(LaneWidth);
+		}
+	}
+
+	// fill in the agent's values right away so it doesn't read stale data until the next tick
+	const FVector Location = Agent->GetActorLocation();
+	StoreAgentLocation(Handle, Location);
+
+	const int32 NearestPlayer = FindNearestPlayer(Location);
+	NearestPlayers[Handle] = static_cast<float>(NearestPlayer);
+	Distances[Handle] = NearestPlayer != INDEX_NONE ? static_cast<float>(FVector::Distance(Location, PlayerLocations[NearestPlayer])) : UE_BIG_NUMBER;
+
+	return Handle;
+}
+
+void UAIPlayerInfoSubsystem::UnregisterAgent(int32 Handle)
+{
+	if (!Agents.IsValidIndex(Handle) || Agents[Handle].IsExplicitlyNull())
+	{
+		return;
+	}
+
+	Agents[Handle].Reset();
+	FreeHandles.Add(Handle);
+
+	// stop watching the agent's range
+	if (RangeWatches[Handle].OnRangeChanged.IsBound())
+	{
+		RangeWatches[Handle] = FAIPlayerRangeWatch();
+		WatchedHandles.RemoveSwap(Handle, EAllowShrinking::No);
+	}
+
+	// stop tracking the agent's player
+	if (Tracks[Handle].OnPlayerInfoChanged.IsBound())
+	{
+		Tracks[Handle] = FAIPlayerTrack();
+		TrackedHandles.RemoveSwap(Handle, EAllowShrinking::No);
+	}
+}
+
+int32 UAIPlayerInfoSubsystem::FindNearestPlayer(const FVector& Location) const
+{
+	int32 NearestPlayer = INDEX_NONE;
+	double NearestDistanceSquared = TNumericLimits<double>::Max();
+
+	for (int32 PlayerIndex = 0; PlayerIndex < PlayerLocations.Num(); ++PlayerIndex)
+	{
+		const double DistanceSquared = FVector::DistSquared(Location, PlayerLocations[PlayerIndex]);
+
+		if (DistanceSquared < NearestDistanceSquared)
+		{
+			NearestDistanceSquared = DistanceSquared;
+			NearestPlayer = PlayerIndex;
+		}
+	}
+
+	return NearestPlayer;
+}
+
+int32 UAIPlayerInfoSubsystem::GetNearestPlayer(int32 Handle) const
+{
+	return Agents.IsValidIndex(Handle) ? static_cast<int32>(NearestPlayers[Handle]) : INDEX_NONE;
+}
+
+float UAIPlayerInfoSubsystem::GetDistanceToPlayer(int32 Handle) const
+{
+	return Agents.IsValidIndex(Handle) ? Distances[Handle] : -1.0f;
+}
+
+bool UAIPlayerInfoSubsystem::WatchRange(int32 Handle, float Range, float Hysteresis, const FOnPlayerRangeChanged& OnRangeChanged)
+{
+	if (!Agents.IsValidIndex(Handle) || Agents[Handle].IsExplicitlyNull() || !OnRangeChanged.IsBound())
+	{
+		return false;
+	}
+
+	FAIPlayerRangeWatch& Watch = RangeWatches[Handle];
+
+	if (!Watch.OnRangeChanged.IsBound())
+	{
+		WatchedHandles.Add(Handle);
+	}
+
+	Watch.EnterRange = Range;
+	Watch.ExitRange = Range + FMath::Max(Hysteresis, 0.0f);
+	Watch.bInRange = false;
+	Watch.OnRangeChanged = OnRangeChanged;
+
+	// evaluate the initial state without notifying
+	UpdateRangeWatch(Handle);
+
+	return Watch.bInRange;
+}
+
+bool UAIPlayerInfoSubsystem::IsInRange(int32 Handle) const
+{
+	return RangeWatches.IsValidIndex(Handle) && RangeWatches[Handle].bInRange;
+}
+
+void UAIPlayerInfoSubsystem::TrackPlayer(int32 Handle, float Tolerance, const FOnPlayerInfoChanged& OnPlayerInfoChanged)
+{
+	if (!Agents.IsValidIndex(Handle) || Agents[Handle].IsExplicitlyNull() || !OnPlayerInfoChanged.IsBound())
+	{
+		return;
+	}
+
+	FAIPlayerTrack& Track = Tracks[Handle];
+
+	if (!Track.OnPlayerInfoChanged.IsBound())
+	{
+		TrackedHandles.Add(Handle);
+	}
+
+	Track.Tolerance = FMath::Max(Tolerance, 0.0f);
+	Track.Player = INDEX_NONE;
+	Track.OnPlayerInfoChanged = OnPlayerInfoChanged;
+
+	// record the initial state without notifying
+	UpdateTrack(Handle);
+}
+
+void UAIPlayerInfoSubsystem::Tick(float DeltaTime)
+{
+	// look up the players once for everybody
+	GatherPlayers();
+
+	if (Agents.Num() == 0)
+	{
+		return;
+	}
+
+	// gather the agent locations into the packed arrays
+	for (int32 Handle = 0; Handle < Agents.Num(); ++Handle)
+	{
+		if (const AActor* Agent = Agents[Handle].Get())
+		{
+			StoreAgentLocation(Handle, Agent->GetActorLocation());
+		}
+	}
+
+	// find every agent's nearest player, four agents at a time. Agents without any player are left at a huge distance
+	const int32 NumPlayers = PlayerPawns.Num();
+
+	for (int32 BaseIndex = 0; BaseIndex < Agents.Num(); BaseIndex += LaneWidth)
+	{
+		const VectorRegister4Float X = VectorLoadAligned(AgentX.GetData() + BaseIndex);
+		const VectorRegister4Float Y = VectorLoadAligned(AgentY.GetData() + BaseIndex);
+		const VectorRegister4Float Z = VectorLoadAligned(AgentZ.GetData() + BaseIndex);
+
+		VectorRegister4Float MinDistanceSquared = VectorSetFloat1(UE_BIG_NUMBER);
+		VectorRegister4Float NearestPlayer = VectorSetFloat1(static_cast<float>(INDEX_NONE));
+
+		for (int32 PlayerIndex = 0; PlayerIndex < NumPlayers; ++PlayerIndex)
+		{
+			const VectorRegister4Float DeltaX = VectorSubtract(X, VectorSetFloat1(PlayerX[PlayerIndex]));
+			const VectorRegister4Float DeltaY = VectorSubtract(Y, VectorSetFloat1(PlayerY[PlayerIndex]));
+			const VectorRegister4Float DeltaZ = VectorSubtract(Z, VectorSetFloat1(PlayerZ[PlayerIndex]));
+
+			const VectorRegister4Float DistanceSquared = VectorMultiplyAdd(DeltaX, DeltaX, VectorMultiplyAdd(DeltaY, DeltaY, VectorMultiply(DeltaZ, DeltaZ)));
+
+			// keep the closer player in each lane
+			const VectorRegister4Float Closer = VectorCompareLT(DistanceSquared, MinDistanceSquared);
+			MinDistanceSquared = VectorSelect(Closer, DistanceSquared, MinDistanceSquared);
+			NearestPlayer = VectorSelect(Closer, VectorSetFloat1(static_cast<float>(PlayerIndex)), NearestPlayer);
+		}
+
+		VectorStoreAligned(NumPlayers > 0 ? VectorSqrt(MinDistanceSquared) : MinDistanceSquared, Distances.GetData() + BaseIndex);
+		VectorStoreAligned(NearestPlayer, NearestPlayers.GetData() + BaseIndex);
+	}
+
+	// find the watched bands the nearest player crossed this frame
+	ChangedWatches.Reset();
+
+	for (const int32 Handle : WatchedHandles)
+	{
+		if (UpdateRangeWatch(Handle))
+		{
+			ChangedWatches.Add(Handle);
+		}
+	}
+
+	// notify after the pass, since watchers may register or unregister agents in response
+	for (const int32 Handle : ChangedWatches)
+	{
+		// copy the delegate, in case the watches array grows while it runs
+		const FOnPlayerRangeChanged OnRangeChanged = RangeWatches[Handle].OnRangeChanged;
+		OnRangeChanged.ExecuteIfBound(RangeWatches[Handle].bInRange);
+	}
+
+	// find the trackers whose nearest player changed enough this frame
+	ChangedTracks.Reset();
+
+	for (const int32 Handle : TrackedHandles)
+	{
+		if (UpdateTrack(Handle))
+		{
+			ChangedTracks.Add(Handle);
+		}
+	}
+
+	// notify after the pass, for the same reason as the range watches
+	for (const int32 Handle : ChangedTracks)
+	{
+		const FOnPlayerInfoChanged OnPlayerInfoChanged = Tracks[Handle].OnPlayerInfoChanged;
+		OnPlayerInfoChanged.ExecuteIfBound();
+	}
+}
+
+TStatId UAIPlayerInfoSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UAIPlayerInfoSubsystem, STATGROUP_Tickables);
+}
+
+void UAIPlayerInfoSubsystem::Deinitialize()
+{
+	// release all agents
+	Agents.Empty();
+	FreeHandles.Empty();
+	AgentX.Empty();
+	AgentY.Empty();
+	AgentZ.Empty();
+	Distances.Empty();
+	NearestPlayers.Empty();
+	RangeWatches.Empty();
+	WatchedHandles.Empty();
+	ChangedWatches.Empty();
+	Tracks.Empty();
+	TrackedHandles.Empty();
+	ChangedTracks.Empty();
+
+	PlayerPawns.Empty();
+	PlayerLocations.Empty();
+	PlayerVelocities.Empty();
+	PlayerX.Empty();
+	PlayerY.Empty();
+	PlayerZ.Empty();
+
+	Super::Deinitialize();
+}
+
+void UAIPlayerInfoSubsystem::StoreAgentLocation(int32 Handle, const FVector& Location)
+{
+	AgentX[Handle] = static_cast<float>(Location.X);
+	AgentY[Handle] = static_cast<float>(Location.Y);
+	AgentZ[Handle] = static_cast<float>(Location.Z);
+}
+
+void UAIPlayerInfoSubsystem::GatherPlayers()
+{
+	PlayerPawns.Reset();
+	PlayerLocations.Reset();
+	PlayerVelocities.Reset();
+	PlayerX.Reset();
+	PlayerY.Reset();
+	PlayerZ.Reset();
+
+	// on the server this includes the controllers of remote players
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController = It->Get();
+		APawn* Pawn = PlayerController ? PlayerController->GetPawn() : nullptr;
+
+		if (!Pawn)
+		{
+			continue;
+		}
+
+		const FVector Location = Pawn->GetActorLocation();
+
+		PlayerPawns.Add(Pawn);
+		PlayerLocations.Add(Location);
+		PlayerVelocities.Add(Pawn->GetVelocity());
+		PlayerX.Add(static_cast<float>(Location.X));
+		PlayerY.Add(static_cast<float>(Location.Y));
+		PlayerZ.Add(static_cast<float>(Location.Z));
+	}
+}
+
+bool UAIPlayerInfoSubsystem::UpdateRangeWatch(int32 Handle)
+{
+	FAIPlayerRangeWatch& Watch = RangeWatches[Handle];
+
+	// nobody is in range if there are no players. Otherwise use the band edge for our current state to avoid flickering
+	const float Threshold = Watch.bInRange ? Watch.ExitRange : Watch.EnterRange;
+	const bool bInRange = PlayerPawns.Num() > 0 && Distances[Handle] <= Threshold;
+
+	if (bInRange == Watch.bInRange)
+	{
+		return false;
+	}
+
+	Watch.bInRange = bInRange;
+	return true;
+}
+
+bool UAIPlayerInfoSubsystem::UpdateTrack(int32 Handle)
+{
+	FAIPlayerTrack& Track = Tracks[Handle];
+
+	const int32 Player = GetNearestPlayer(Handle);
+	const FVector Location = GetPlayerLocation(Player);
+	const float Distance = Distances[Handle];
+
+	// skip changes within the tolerance, so small movements don't wake the tree
+	if (Player == Track.Player
+		&& FVector::DistSquared(Location, Track.PlayerLocation) <= FMath::Square(Track.Tolerance)
+		&& FMath::Abs(Distance - Track.Distance) <= Track.Tolerance)
+	{
+		return false;
+	}
+
+	Track.Player = Player;
+	Track.PlayerLocation = Location;
+	Track.Distance = Distance;
+	return true;
+}
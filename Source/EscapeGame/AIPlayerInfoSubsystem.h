@@ -0,0 +1,196 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "AIPlayerInfoSubsystem.generated.h"
+
+class APawn;
+
+/** Notifies a range watcher that the nearest player crossed its distance band */
+DECLARE_DELEGATE_OneParam(FOnPlayerRangeChanged, bool /* bInRange */);
+
+/** Notifies a player tracker that its nearest player info changed by more than its tolerance */
+DECLARE_DELEGATE(FOnPlayerInfoChanged);
+
+/** A distance band with hysteresis, watched for a single agent handle */
+struct FAIPlayerRangeWatch
+{
+	/** A player enters the band when closer than this */
+	float EnterRange = 0.0f;
+
+	/** The nearest player leaves the band when further than this */
+	float ExitRange = 0.0f;
+
+	/** True while a player is inside the band */
+	bool bInRange = false;
+
+	/** Called when the nearest player crosses the band */
+	FOnPlayerRangeChanged OnRangeChanged;
+};
+
+/** The nearest player info last reported to a tracker, for a single agent handle */
+struct FAIPlayerTrack
+{
+	/** Minimum change in the player's location or distance that gets reported */
+	float Tolerance = 0.0f;
+
+	/** Nearest player index last reported */
+	int32 Player = INDEX_NONE;
+
+	/** Nearest player location last reported */
+	FVector PlayerLocation = FVector::ZeroVector;
+
+	/** Distance to the nearest player last reported */
+	float Distance = 0.0f;
+
+	/** Called when the nearest player info changes by more than the tolerance */
+	FOnPlayerInfoChanged OnPlayerInfoChanged;
+};
+
+/**
+ *  Shared player info cache for AI.
+ *  Looks up every player pawn's location and velocity once per frame, and finds the nearest player
+ *  to every registered AI agent in a single vectorized pass over packed arrays.
+ *  StateTree tasks read from here instead of querying the players and the agents individually.
+ *  Agents can also watch a distance band, and get notified only when the nearest player crosses it,
+ *  or track their nearest player, and get notified only when it changes by more than a tolerance.
+ *  Players are gathered from the player controllers, so on a server this includes remote players.
+ *  Values are refreshed after actors tick, so readers see the previous frame's state.
+ */
+UCLASS()
+class UAIPlayerInfoSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Number of agents processed per vector iteration */
+	static constexpr int32 LaneWidth = 4;
+
+	/** Player pawns found this frame, indexed by player index */
+	TArray<TWeakObjectPtr<APawn>> PlayerPawns;
+
+	/** Player pawn locations this frame, indexed by player index */
+	TArray<FVector> PlayerLocations;
+
+	/** Player pawn velocities this frame, indexed by player index */
+	TArray<FVector> PlayerVelocities;
+
+	/** Player pawn locations this frame, packed for the distance pass */
+	TArray<float> PlayerX;
+	TArray<float> PlayerY;
+	TArray<float> PlayerZ;
+
+	/** Registered agents, indexed by handle. Free slots are null */
+	TArray<TWeakObjectPtr<const AActor>> Agents;
+
+	/** Handles available for reuse */
+	TArray<int32> FreeHandles;
+
+	/** Agent locations, packed and padded to the lane width */
+	TArray<float, TAlignedHeapAllocator<16>> AgentX;
+	TArray<float, TAlignedHeapAllocator<16>> AgentY;
+	TArray<float, TAlignedHeapAllocator<16>> AgentZ;
+
+	/** Distance from each agent to its nearest player, packed and padded to the lane width */
+	TArray<float, TAlignedHeapAllocator<16>> Distances;
+
+	/** Index of each agent's nearest player, or -1 if there are no players. Stored as floats so the vectorized pass can select them */
+	TArray<float, TAlignedHeapAllocator<16>> NearestPlayers;
+
+	/** Distance band watched by each agent, indexed by handle */
+	TArray<FAIPlayerRangeWatch> RangeWatches;
+
+	/** Handles of agents with an active range watch */
+	TArray<int32> WatchedHandles;
+
+	/** Scratch list of watches that changed this frame */
+	TArray<int32> ChangedWatches;
+
+	/** Nearest player tracked by each agent, indexed by handle */
+	TArray<FAIPlayerTrack> Tracks;
+
+	/** Handles of agents with an active tracker */
+	TArray<int32> TrackedHandles;
+
+	/** Scratch list of trackers that changed this frame */
+	TArray<int32> ChangedTracks;
+
+public:
+
+	/** Registers an AI agent and returns its handle. Handles stay valid until unregistered */
+	int32 RegisterAgent(const AActor* Agent);
+
+	/** Unregisters an AI agent, freeing its handle for reuse */
+	void UnregisterAgent(int32 Handle);
+
+	/** Returns the number of players found this frame */
+	int32 GetNumPlayers() const { return PlayerPawns.Num(); }
+
+	/** Returns the pawn of the player at the provided index, if any */
+	APawn* GetPlayerPawn(int32 PlayerIndex) const { return PlayerPawns.IsValidIndex(PlayerIndex) ? PlayerPawns[PlayerIndex].Get() : nullptr; }
+
+	/** Returns the location of the player at the provided index */
+	FVector GetPlayerLocation(int32 PlayerIndex) const { return PlayerLocations.IsValidIndex(PlayerIndex) ? PlayerLocations[PlayerIndex] : FVector::ZeroVector; }
+
+	/** Returns the velocity of the player at the provided index */
+	FVector GetPlayerVelocity(int32 PlayerIndex) const { return PlayerVelocities.IsValidIndex(PlayerIndex) ? PlayerVelocities[PlayerIndex] : FVector::ZeroVector; }
+
+	/** Returns the index of the player nearest to a world location, or INDEX_NONE if there are no players */
+	int32 FindNearestPlayer(const FVector& Location) const;
+
+	/** Returns the index of the player nearest to a registered agent, or INDEX_NONE if there are no players or the handle isn't valid */
+	int32 GetNearestPlayer(int32 Handle) const;
+
+	/** Returns the distance from a registered agent to its nearest player, or -1 if the handle isn't valid */
+	float GetDistanceToPlayer(int32 Handle) const;
+
+	/**
+	 *  Starts watching a distance band around a registered agent.
+	 *  A player enters the band when closer than Range, and the nearest player leaves it when further than Range + Hysteresis.
+	 *  The delegate is only called when the nearest player crosses the band, never on the initial evaluation.
+	 *  Returns true if a player is initially in range.
+	 */
+	bool WatchRange(int32 Handle, float Range, float Hysteresis, const FOnPlayerRangeChanged& OnRangeChanged);
+
+	/** Returns true if a player is inside the agent's watched band */
+	bool IsInRange(int32 Handle) const;
+
+	/**
+	 *  Starts tracking the nearest player of a registered agent.
+	 *  The delegate is called when the nearest player changes, or when its location or distance
+	 *  moves more than Tolerance away from the values at the last call. Never called on the initial evaluation.
+	 */
+	void TrackPlayer(int32 Handle, float Tolerance, const FOnPlayerInfoChanged& OnPlayerInfoChanged);
+
+public:
+
+	// ~begin UTickableWorldSubsystem interface
+
+	/** Refreshes the player info and each agent's nearest player */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Returns the stat ID for the tickable */
+	virtual TStatId GetStatId() const override;
+
+	/** Cleanup */
+	virtual void Deinitialize() override;
+
+	// ~end UTickableWorldSubsystem interface
+
+protected:
+
+	/** Writes an agent's location into the packed arrays */
+	void StoreAgentLocation(int32 Handle, const FVector& Location);
+
+	/** Gathers every player pawn's location and velocity */
+	void GatherPlayers();
+
+	/** Evaluates a range watch against the agent's current distance. Returns true if the in range state changed */
+	bool UpdateRangeWatch(int32 Handle);
+
+	/** Evaluates a tracker against the agent's current nearest player. Returns true if it changed by more than the tolerance */
+	bool UpdateTrack(int32 Handle);
+};
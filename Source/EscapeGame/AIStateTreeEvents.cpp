@@ -0,0 +1,39 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "AIStateTreeEvents.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "AIController.h"
+#include "Components/StateTreeComponent.h"
+
+UE_DEFINE_GAMEPLAY_TAG_COMMENT(TAG_AI_Event_PlayerEnteredRange, "AI.Event.PlayerEnteredRange", "The player crossed into a watched distance band");
+UE_DEFINE_GAMEPLAY_TAG_COMMENT(TAG_AI_Event_PlayerLeftRange, "AI.Event.PlayerLeftRange", "The player crossed out of a watched distance band");
+UE_DEFINE_GAMEPLAY_TAG_COMMENT(TAG_AI_Event_PlayerInfoChanged, "AI.Event.PlayerInfoChanged", "The nearest player's tracked info changed by more than the tracking tolerance");
+UE_DEFINE_GAMEPLAY_TAG_COMMENT(TAG_AI_Event_Movement_Grounded, "AI.Event.Movement.Grounded", "The AI character started walking on the ground");
+UE_DEFINE_GAMEPLAY_TAG_COMMENT(TAG_AI_Event_Movement_Airborne, "AI.Event.Movement.Airborne", "The AI character left the ground");
+
+void FAIStateTreeEvents::SendEvent(const APawn* Pawn, FGameplayTag Tag)
+{
+	// find the StateTree running on the AI controller
+	const AAIController* Controller = Pawn ? Cast<AAIController>(Pawn->GetController()) : nullptr;
+
+	if (UStateTreeComponent* StateTree = Controller ? Cast<UStateTreeComponent>(Controller->GetBrainComponent()) : nullptr)
+	{
+		StateTree->SendStateTreeEvent(Tag);
+	}
+}
+
+void FAIStateTreeEvents::SendMovementModeEvent(const ACharacter* Character, EMovementMode PrevMovementMode)
+{
+	const UCharacterMovementComponent* Movement = Character->GetCharacterMovement();
+
+	// only notify when the grounded state actually flips
+	const bool bWasGrounded = PrevMovementMode == MOVE_Walking || PrevMovementMode == MOVE_NavWalking;
+	const bool bIsGrounded = Movement->IsMovingOnGround();
+
+	if (bWasGrounded != bIsGrounded)
+	{
+		SendEvent(Character, bIsGrounded ? TAG_AI_Event_Movement_Grounded : TAG_AI_Event_Movement_Airborne);
+	}
+}
@@ -0,0 +1,38 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "NativeGameplayTags.h"
+#include "Engine/EngineTypes.h"
+
+class APawn;
+class ACharacter;
+
+/** Sent when the player crosses into a watched distance band */
+UE_DECLARE_GAMEPLAY_TAG_EXTERN(TAG_AI_Event_PlayerEnteredRange);
+
+/** Sent when the player crosses out of a watched distance band */
+UE_DECLARE_GAMEPLAY_TAG_EXTERN(TAG_AI_Event_PlayerLeftRange);
+
+/** Sent when the nearest player's tracked info changed by more than the tracking tolerance */
+UE_DECLARE_GAMEPLAY_TAG_EXTERN(TAG_AI_Event_PlayerInfoChanged);
+
+/** Sent when an AI character starts walking on the ground */
+UE_DECLARE_GAMEPLAY_TAG_EXTERN(TAG_AI_Event_Movement_Grounded);
+
+/** Sent when an AI character leaves the ground */
+UE_DECLARE_GAMEPLAY_TAG_EXTERN(TAG_AI_Event_Movement_Airborne);
+
+/**
+ *  Helpers to push gameplay changes into AI StateTrees as events,
+ *  so trees can transition on them instead of polling every tick
+ */
+struct FAIStateTreeEvents
+{
+	/** Sends an event to the StateTree running on the pawn's AI controller, if any */
+	static void SendEvent(const APawn* Pawn, FGameplayTag Tag);
+
+	/** Sends a grounded or airborne event if the character's movement mode changed between the two */
+	static void SendMovementModeEvent(const ACharacter* Character, EMovementMode PrevMovementMode);
+};
@@ -0,0 +1,72 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "AIStateTreeUtility.h"
+#include "StateTreeExecutionContext.h"
+#include "StateTreeExecutionTypes.h"
+#include "StateTreeAsyncExecutionContext.h"
+#include "GameFramework/Pawn.h"
+#include "AIPlayerInfoSubsystem.h"
+#include "AIStateTreeEvents.h"
+
+FStateTreeWatchPlayerRangeTask::FStateTreeWatchPlayerRangeTask()
+{
+	// all work is done by the player info subsystem, so we never need to tick
+	bShouldCallTick = false;
+}
+
+EStateTreeRunStatus FStateTreeWatchPlayerRangeTask::EnterState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const
+{
+	// have we transitioned from another state?
+	if (Transition.ChangeType == EStateTreeStateChangeType::Changed)
+	{
+		// get the instance data
+		FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
+
+		if (UAIPlayerInfoSubsystem* PlayerInfo = Context.GetWorld()->GetSubsystem<UAIPlayerInfoSubsystem>())
+		{
+			// register the pawn and watch its range
+			InstanceData.PlayerInfoHandle = PlayerInfo->RegisterAgent(InstanceData.Pawn);
+
+			const bool bInRange = PlayerInfo->WatchRange(InstanceData.PlayerInfoHandle, InstanceData.Range, InstanceData.Hysteresis, FOnPlayerRangeChanged::CreateLambda(
+				[WeakContext = Context.MakeWeakExecutionContext()](bool bInRange)
+				{
+					WeakContext.SendEvent(bInRange ? TAG_AI_Event_PlayerEnteredRange : TAG_AI_Event_PlayerLeftRange);
+				}
+			));
+
+			// let the tree know if the player is already in range
+			if (bInRange)
+			{
+				Context.SendEvent(TAG_AI_Event_PlayerEnteredRange);
+			}
+		}
+	}
+
+	return EStateTreeRunStatus::Running;
+}
+
+void FStateTreeWatchPlayerRangeTask::ExitState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const
+{
+	// have we transitioned to another state?
+	if (Transition.ChangeType == EStateTreeStateChangeType::Changed)
+	{
+		// get the instance data
+		FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
+
+		// stop watching the range
+		if (UAIPlayerInfoSubsystem* PlayerInfo = Context.GetWorld()->GetSubsystem<UAIPlayerInfoSubsystem>())
+		{
+			PlayerInfo->UnregisterAgent(InstanceData.PlayerInfoHandle);
+		}
+
+		InstanceData.PlayerInfoHandle = INDEX_NONE;
+	}
+}
+
+#if WITH_EDITOR
+FText FStateTreeWatchPlayerRangeTask::GetDescription(const FGuid& ID, FStateTreeDataView InstanceDataView, const IStateTreeBindingLookup& BindingLookup, EStateTreeNodeFormatting Formatting /*= EStateTreeNodeFormatting::Text*/) const
+{
+	return FText::FromString("<b>Watch Player Range</b>");
+}
+#endif // WITH_EDITOR
@@ -0,0 +1,61 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "StateTreeTaskBase.h"
+
+#include "AIStateTreeUtility.generated.h"
+
+/**
+ *  Instance data struct for the Watch Player Range task
+ */
+USTRUCT()
+struct FStateTreeWatchPlayerRangeInstanceData
+{
+	GENERATED_BODY()
+
+	/** Pawn that owns this task */
+	UPROPERTY(EditAnywhere, Category = Context)
+	TObjectPtr<APawn> Pawn;
+
+	/** The player is considered in range when closer than this distance */
+	UPROPERTY(EditAnywhere, Category = Parameter, meta = (ClampMin = 0, ClampMax = 10000, Units = "cm"))
+	float Range = 500.0f;
+
+	/** Extra distance the player needs to move away before it's considered out of range again */
+	UPROPERTY(EditAnywhere, Category = Parameter, meta = (ClampMin = 0, ClampMax = 1000, Units = "cm"))
+	float Hysteresis = 50.0f;
+
+	/** Handle of the pawn in the AI player info subsystem */
+	int32 PlayerInfoHandle = INDEX_NONE;
+};
+
+/**
+ *  StateTree task that watches the distance to the player without ticking.
+ *  Sends AI.Event.PlayerEnteredRange and AI.Event.PlayerLeftRange when the player crosses the range,
+ *  so transitions only get evaluated when something relevant changes.
+ *  If the player is already in range when the state is entered, the entered event is sent right away.
+ */
+USTRUCT(meta=(DisplayName="Watch Player Range", Category="AI"))
+struct FStateTreeWatchPlayerRangeTask : public FStateTreeTaskCommonBase
+{
+	GENERATED_BODY()
+
+	/* Ensure we're using the correct instance data struct */
+	using FInstanceDataType = FStateTreeWatchPlayerRangeInstanceData;
+	virtual const UStruct* GetInstanceDataType() const override { return FInstanceDataType::StaticStruct(); }
+
+	/** Constructor */
+	FStateTreeWatchPlayerRangeTask();
+
+	/** Runs when the owning state is entered */
+	virtual EStateTreeRunStatus EnterState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const override;
+
+	/** Runs when the owning state is ended */
+	virtual void ExitState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const override;
+
+#if WITH_EDITOR
+	virtual FText GetDescription(const FGuid& ID, FStateTreeDataView InstanceDataView, const IStateTreeBindingLookup& BindingLookup, EStateTreeNodeFormatting Formatting = EStateTreeNodeFormatting::Text) const override;
+#endif // WITH_EDITOR
+};
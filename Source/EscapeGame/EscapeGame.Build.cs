@@ -12,9 +12,12 @@ public class EscapeGame : ModuleRules
 			"Core",
 			"CoreUObject",
 			"Engine",
+			"NetCore",
+			"ReplicationGraph",
 			"InputCore",
 			"EnhancedInput",
 			"AIModule",
+			"GameplayTags",
 			"StateTreeModule",
 			"GameplayStateTreeModule",
 			"UMG",
@@ -50,6 +53,7 @@ public class EscapeGame : ModuleRules
 			"EscapeGame/Variant_Combat/Animation",
 			"EscapeGame/Variant_Combat/Gameplay",
 			"EscapeGame/Variant_Combat/Interfaces",
+			"EscapeGame/Variant_Combat/Simulation",
 			"EscapeGame/Variant_Combat/UI",
 			"EscapeGame/Variant_SideScrolling",
 			"EscapeGame/Variant_SideScrolling/AI",
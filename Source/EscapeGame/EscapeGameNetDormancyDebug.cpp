@@ -0,0 +1,76 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "DrawDebugHelpers.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+#include "EscapeGame.h"
+
+#if !UE_BUILD_SHIPPING
+
+namespace EscapeGameNetDormancyDebug
+{
+	/** Height above an actor's bounds to draw its dormancy label */
+	constexpr float LabelOffset = 50.0f;
+
+	/** Logs a summary of replicated actors by dormancy state, and labels the dormancy aware ones in the world */
+	void Show(UWorld* World, float Duration)
+	{
+		int32 StateCounts[ENetDormancy::DORM_MAX] = {};
+
+		for (TActorIterator<AActor> It(World); It; ++It)
+		{
+			const AActor* Actor = *It;
+
+			if (!Actor->GetIsReplicated())
+			{
+				continue;
+			}
+
+			const ENetDormancy Dormancy = Actor->NetDormancy;
+			++StateCounts[Dormancy];
+
+			// skip actors that never go dormant, they'd just clutter the view
+			if (Dormancy == DORM_Never)
+			{
+				continue;
+			}
+
+			// label dormant actors green and awake actors red
+			const bool bDormant = Dormancy > DORM_Awake;
+			const FString Label = FString::Printf(TEXT("%s\n%s"), *Actor->GetName(), *UEnum::GetDisplayValueAsText(Dormancy).ToString());
+
+			FVector Origin, Extent;
+			Actor->GetActorBounds(true, Origin, Extent);
+
+			DrawDebugString(World, Origin + FVector(0.0f, 0.0f, Extent.Z + LabelOffset), Label, nullptr, bDormant ? FColor::Green : FColor::Red, Duration);
+		}
+
+		UE_LOG(LogEscapeGame, Log, TEXT("Net dormancy: %d never, %d awake, %d dormant all, %d dormant partial, %d initial"),
+			StateCounts[DORM_Never],
+			StateCounts[DORM_Awake],
+			StateCounts[DORM_DormantAll],
+			StateCounts[DORM_DormantPartial],
+			StateCounts[DORM_Initial]);
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs EscapeGameShowNetDormancyCommand(
+	TEXT("EscapeGame.ShowNetDormancy"),
+	TEXT("Logs replicated actor counts by net dormancy state and labels dormancy aware actors in the world. Optionally takes a label duration in seconds, defaults to 5. Run on the server for authoritative results."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (!World)
+		{
+			return;
+		}
+
+		const float Duration = Args.Num() > 0 ? FMath::Max(FCString::Atof(*Args[0]), 0.0f) : 5.0f;
+
+		EscapeGameNetDormancyDebug::Show(World, Duration);
+	})
+);
+
+#endif // !UE_BUILD_SHIPPING
@@ -0,0 +1,304 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "EscapeGameReplicationGraph.h"
+#include "Engine/LevelScriptActor.h"
+#include "GameFramework/GameModeBase.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "UObject/UObjectIterator.h"
+#include "CombatCharacter.h"
+#include "CombatEnemy.h"
+#include "CombatEnemySpawner.h"
+#include "CombatEnemyStateReplicator.h"
+#include "CombatDamageableBox.h"
+#include "CombatActivationVolume.h"
+#include "CombatCheckpointVolume.h"
+#include "SideScrollingCharacter.h"
+#include "SideScrollingNPC.h"
+#include "SideScrollingMovingPlatform.h"
+#include "SideScrollingPickup.h"
+
+UEscapeGameReplicationGraphNode_AxisX::UEscapeGameReplicationGraphNode_AxisX()
+{
+	// we re-bucket moving actors once per frame
+	bRequiresPrepareForReplicationCall = true;
+}
+
+void UEscapeGameReplicationGraphNode_AxisX::NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo)
+{
+	AActor* Actor = ActorInfo.Actor;
+
+	// ignore repeated registrations
+	if (ActorCells.Contains(Actor))
+	{
+		return;
+	}
+
+	const int32 Cell = GetCell(Actor->GetActorLocation().X);
+
+	Cells.FindOrAdd(Cell).Add(Actor);
+	ActorCells.Add(Actor, Cell);
+}
+
+bool UEscapeGameReplicationGraphNode_AxisX::NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound)
+{
+	int32 Cell;
+
+	if (!ActorCells.RemoveAndCopyValue(ActorInfo.Actor, Cell))
+	{
+		return false;
+	}
+
+	if (FActorRepListRefView* CellActors = Cells.Find(Cell))
+	{
+		CellActors->RemoveFast(ActorInfo.Actor);
+	}
+
+	return true;
+}
+
+void UEscapeGameReplicationGraphNode_AxisX::NotifyResetAllNetworkActors()
+{
+	Cells.Reset();
+	ActorCells.Reset();
+}
+
+void UEscapeGameReplicationGraphNode_AxisX::PrepareForReplication()
+{
+	for (TPair<FActorRepListType, int32>& ActorCell : ActorCells)
+	{
+		const int32 NewCell = GetCell(ActorCell.Key->GetActorLocation().X);
+
+		// move the actor to its new bucket
+		if (NewCell != ActorCell.Value)
+		{
+			Cells.FindChecked(ActorCell.Value).RemoveFast(ActorCell.Key);
+			Cells.FindOrAdd(NewCell).Add(ActorCell.Key);
+
+			ActorCell.Value = NewCell;
+		}
+	}
+}
+
+void UEscapeGameReplicationGraphNode_AxisX::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+	if (Params.Viewers.IsEmpty())
+	{
+		return;
+	}
+
+	// find the range of cells covered by all of the connection's viewers, so split screen doesn't gather a bucket twice
+	int32 MinCell = MAX_int32;
+	int32 MaxCell = MIN_int32;
+
+	for (const FNetViewer& Viewer : Params.Viewers)
+	{
+		MinCell = FMath::Min(MinCell, GetCell(Viewer.ViewLocation.X - CullDistance));
+		MaxCell = FMath::Max(MaxCell, GetCell(Viewer.ViewLocation.X + CullDistance));
+	}
+
+	for (int32 Cell = MinCell; Cell <= MaxCell; ++Cell)
+	{
+		const FActorRepListRefView* CellActors = Cells.Find(Cell);
+
+		if (CellActors && CellActors->Num() > 0)
+		{
+			Params.OutGatheredReplicationLists.AddReplicationActorList(*CellActors);
+		}
+	}
+}
+
+int32 UEscapeGameReplicationGraphNode_AxisX::GetCell(double X) const
+{
+	return FMath::FloorToInt32(X / CellSize);
+}
+
+////////////////////////////////////////////////////////////////////
+
+UEscapeGameReplicationGraph::UEscapeGameReplicationGraph()
+{
+	// stub
+}
+
+void UEscapeGameReplicationGraph::InitGlobalActorClassSettings()
+{
+	Super::InitGlobalActorClassSettings();
+
+	// game modes only exist on the server, but any subclass that replicates should be relevant everywhere
+	ClassRepNodePolicies.Set(AGameModeBase::StaticClass(), EEscapeGameRepNodeMapping::RelevantAllConnections);
+	ClassRepNodePolicies.Set(AGameStateBase::StaticClass(), EEscapeGameRepNodeMapping::RelevantAllConnections);
+	ClassRepNodePolicies.Set(APlayerState::StaticClass(), EEscapeGameRepNodeMapping::RelevantAllConnections);
+	ClassRepNodePolicies.Set(ALevelScriptActor::StaticClass(), EEscapeGameRepNodeMapping::RelevantAllConnections);
+	ClassRepNodePolicies.Set(ACombatEnemyStateReplicator::StaticClass(), EEscapeGameRepNodeMapping::RelevantAllConnections);
+
+	// player controllers are only relevant to their own connection
+	ClassRepNodePolicies.Set(APlayerController::StaticClass(), EEscapeGameRepNodeMapping::NotRouted);
+
+	// combat pawns move constantly
+	ClassRepNodePolicies.Set(ACombatCharacter::StaticClass(), EEscapeGameRepNodeMapping::Spatialize_Dynamic);
+	ClassRepNodePolicies.Set(ACombatEnemy::StaticClass(), EEscapeGameRepNodeMapping::Spatialize_Dynamic);
+
+	// boxes only move after being hit, and spawners and volumes only change state on activation
+	ClassRepNodePolicies.Set(ACombatDamageableBox::StaticClass(), EEscapeGameRepNodeMapping::Spatialize_Dormancy);
+	ClassRepNodePolicies.Set(ACombatEnemySpawner::StaticClass(), EEscapeGameRepNodeMapping::Spatialize_Dormancy);
+	ClassRepNodePolicies.Set(ACombatActivationVolume::StaticClass(), EEscapeGameRepNodeMapping::Spatialize_Dormancy);
+	ClassRepNodePolicies.Set(ACombatCheckpointVolume::StaticClass(), EEscapeGameRepNodeMapping::Spatialize_Dormancy);
+
+	// side-scrolling actors are locked to the XZ plane
+	ClassRepNodePolicies.Set(ASideScrollingCharacter::StaticClass(), EEscapeGameRepNodeMapping::Spatialize_AxisX);
+	ClassRepNodePolicies.Set(ASideScrollingNPC::StaticClass(), EEscapeGameRepNodeMapping::Spatialize_AxisX);
+	ClassRepNodePolicies.Set(ASideScrollingMovingPlatform::StaticClass(), EEscapeGameRepNodeMapping::Spatialize_AxisX);
+	ClassRepNodePolicies.Set(ASideScrollingPickup::StaticClass(), EEscapeGameRepNodeMapping::Spatialize_AxisX);
+
+	// set up the replication settings for every replicated class
+	for (TObjectIterator<UClass> It; It; ++It)
+	{
+		UClass* Class = *It;
+		const AActor* ActorCDO = Cast<AActor>(Class->GetDefaultObject(false));
+
+		// skip non actors, non replicated actors and intermediate blueprint classes
+		if (!ActorCDO || !ActorCDO->GetIsReplicated() || Class->GetName().StartsWith(TEXT("SKEL_")) || Class->GetName().StartsWith(TEXT("REINST_")))
+		{
+			continue;
+		}
+
+		const EEscapeGameRepNodeMapping Mapping = GetMappingPolicy(Class);
+
+		FClassReplicationInfo ClassInfo;
+		ClassInfo.ReplicationPeriodFrame = GetReplicationPeriodFrameForFrequency(ActorCDO->GetNetUpdateFrequency());
+
+		// grid actors are also distance culled. The X axis node does its own culling
+		if (IsGridSpatialized(Mapping))
+		{
+			ClassInfo.SetCullDistanceSquared(ActorCDO->GetNetCullDistanceSquared());
+		}
+
+		GlobalActorReplicationInfoMap.SetClassInfo(Class, ClassInfo);
+	}
+}
+
+void UEscapeGameReplicationGraph::InitGlobalGraphNodes()
+{
+	// create the spatialization grid
+	GridNode = CreateNewNode<UReplicationGraphNode_GridSpatialization2D>();
+	GridNode->CellSize = GridCellSize;
+	GridNode->SpatialBias = GridSpatialBias;
+	AddGlobalGraphNode(GridNode);
+
+	// create the side-scrolling axis
+	AxisXNode = CreateNewNode<UEscapeGameReplicationGraphNode_AxisX>();
+	AxisXNode->CellSize = SideScrollingCellSize;
+	AxisXNode->CullDistance = SideScrollingCullDistance;
+	AddGlobalGraphNode(AxisXNode);
+
+	// create the always relevant list
+	AlwaysRelevantNode = CreateNewNode<UReplicationGraphNode_ActorList>();
+	AddGlobalGraphNode(AlwaysRelevantNode);
+}
+
+void UEscapeGameReplicationGraph::InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection)
+{
+	Super::InitConnectionGraphNodes(RepGraphConnection);
+
+	// every connection always gets its own player controller, pawn and view target
+	UReplicationGraphNode_AlwaysRelevant_ForConnection* ConnectionNode = CreateNewNode<UReplicationGraphNode_AlwaysRelevant_ForConnection>();
+	AddConnectionGraphNode(ConnectionNode, RepGraphConnection);
+}
+
+void UEscapeGameReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo)
+{
+	switch (GetMappingPolicy(ActorInfo.Class))
+	{
+		case EEscapeGameRepNodeMapping::RelevantAllConnections:
+			AlwaysRelevantNode->NotifyAddNetworkActor(ActorInfo);
+			break;
+
+		case EEscapeGameRepNodeMapping::Spatialize_Static:
+			GridNode->AddActor_Static(ActorInfo, GlobalInfo);
+			break;
+
+		case EEscapeGameRepNodeMapping::Spatialize_Dynamic:
+			GridNode->AddActor_Dynamic(ActorInfo, GlobalInfo);
+			break;
+
+		case EEscapeGameRepNodeMapping::Spatialize_Dormancy:
+			GridNode->AddActor_Dormancy(ActorInfo, GlobalInfo);
+			break;
+
+		case EEscapeGameRepNodeMapping::Spatialize_AxisX:
+			AxisXNode->NotifyAddNetworkActor(ActorInfo);
+			break;
+
+		default:
+			break;
+	}
+}
+
+void UEscapeGameReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo)
+{
+	switch (GetMappingPolicy(ActorInfo.Class))
+	{
+		case EEscapeGameRepNodeMapping::RelevantAllConnections:
+			AlwaysRelevantNode->NotifyRemoveNetworkActor(ActorInfo);
+			break;
+
+		case EEscapeGameRepNodeMapping::Spatialize_Static:
+			GridNode->RemoveActor_Static(ActorInfo);
+			break;
+
+		case EEscapeGameRepNodeMapping::Spatialize_Dynamic:
+			GridNode->RemoveActor_Dynamic(ActorInfo);
+			break;
+
+		case EEscapeGameRepNodeMapping::Spatialize_Dormancy:
+			GridNode->RemoveActor_Dormancy(ActorInfo);
+			break;
+
+		case EEscapeGameRepNodeMapping::Spatialize_AxisX:
+			AxisXNode->NotifyRemoveNetworkActor(ActorInfo);
+			break;
+
+		default:
+			break;
+	}
+}
+
+EEscapeGameRepNodeMapping UEscapeGameReplicationGraph::GetMappingPolicy(UClass* Class)
+{
+	// use the explicit policy for the class or its closest parent
+	if (const EEscapeGameRepNodeMapping* Mapping = ClassRepNodePolicies.Get(Class))
+	{
+		return *Mapping;
+	}
+
+	// derive one from the class defaults and cache it
+	const EEscapeGameRepNodeMapping Mapping = GetDefaultMappingPolicy(Cast<AActor>(Class->GetDefaultObject()));
+	ClassRepNodePolicies.Set(Class, Mapping);
+
+	return Mapping;
+}
+
+EEscapeGameRepNodeMapping UEscapeGameReplicationGraph::GetDefaultMappingPolicy(const AActor* ActorCDO)
+{
+	if (!ActorCDO || ActorCDO->bOnlyRelevantToOwner)
+	{
+		return EEscapeGameRepNodeMapping::NotRouted;
+	}
+
+	if (ActorCDO->bAlwaysRelevant)
+	{
+		return EEscapeGameRepNodeMapping::RelevantAllConnections;
+	}
+
+	// actors that replicate movement may move every frame. Everything else only needs to be bucketed once
+	return ActorCDO->IsReplicatingMovement() ? EEscapeGameRepNodeMapping::Spatialize_Dynamic : EEscapeGameRepNodeMapping::Spatialize_Static;
+}
+
+bool UEscapeGameReplicationGraph::IsGridSpatialized(EEscapeGameRepNodeMapping Mapping)
+{
+	return Mapping == EEscapeGameRepNodeMapping::Spatialize_Static
+		|| Mapping == EEscapeGameRepNodeMapping::Spatialize_Dynamic
+		|| Mapping == EEscapeGameRepNodeMapping::Spatialize_Dormancy;
+}
@@ -0,0 +1,170 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ReplicationGraph.h"
+#include "EscapeGameReplicationGraph.generated.h"
+
+class UReplicationGraphNode_GridSpatialization2D;
+class UReplicationGraphNode_ActorList;
+class UEscapeGameReplicationGraphNode_AxisX;
+
+/** How the replication graph routes actors of a class */
+enum class EEscapeGameRepNodeMapping : uint8
+{
+	/** Not routed to any global node. Owner only actors like player controllers are handled per connection */
+	NotRouted,
+
+	/** Relevant to every connection */
+	RelevantAllConnections,
+
+	/** Spatialized on the grid. Never moves */
+	Spatialize_Static,
+
+	/** Spatialized on the grid. May move every frame */
+	Spatialize_Dynamic,
+
+	/** Spatialized on the grid. Treated as static while dormant and as dynamic while awake */
+	Spatialize_Dormancy,
+
+	/** Spatialized along the X axis only, for actors locked to the side-scrolling plane */
+	Spatialize_AxisX
+};
+
+/**
+ *  Replication graph node that spatializes actors along the world X axis only.
+ *  Side-scrolling actors all share the same plane, so a 1D bucketing is enough to cull them,
+ *  and each viewer only gathers the few buckets within reach of its X coordinate.
+ */
+UCLASS()
+class UEscapeGameReplicationGraphNode_AxisX : public UReplicationGraphNode
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Width of each bucket along X */
+	float CellSize = 2000.0f;
+
+	/** Max X distance from a viewer for an actor to be relevant */
+	float CullDistance = 6000.0f;
+
+protected:
+
+	/** Actors bucketed by X cell */
+	TMap<int32, FActorRepListRefView> Cells;
+
+	/** Cell each tracked actor is currently stored in */
+	TMap<FActorRepListType, int32> ActorCells;
+
+public:
+
+	/** Constructor */
+	UEscapeGameReplicationGraphNode_AxisX();
+
+	// ~begin UReplicationGraphNode interface
+
+	/** Starts tracking an actor */
+	virtual void NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo) override;
+
+	/** Stops tracking an actor */
+	virtual bool NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound = true) override;
+
+	/** Stops tracking all actors */
+	virtual void NotifyResetAllNetworkActors() override;
+
+	/** Re-buckets any actors that moved to a different cell */
+	virtual void PrepareForReplication() override;
+
+	/** Gathers the buckets within reach of the connection's viewers */
+	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+
+	// ~end UReplicationGraphNode interface
+
+protected:
+
+	/** Returns the cell containing a world X coordinate */
+	int32 GetCell(double X) const;
+};
+
+/**
+ *  Replication graph for both the combat and side-scrolling maps.
+ *  Replaces the default per-connection relevancy pass, which tests every actor against every connection:
+ *  - combat actors are spatialized on a 2D grid, with dormancy aware routing for mostly static gameplay actors
+ *  - side-scrolling actors are spatialized along the X axis only
+ *  - game state, player states and other always relevant actors go to a single shared list
+ */
+UCLASS(Transient, config=Engine)
+class UEscapeGameReplicationGraph : public UReplicationGraph
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Size of each spatialization grid cell */
+	UPROPERTY(Config)
+	float GridCellSize = 10000.0f;
+
+	/** Offset applied to world locations so grid cells start at zero. Should cover the most negative playable coordinates */
+	UPROPERTY(Config)
+	FVector2D GridSpatialBias = FVector2D(-200000.0f, -200000.0f);
+
+	/** Width of each side-scrolling bucket along X */
+	UPROPERTY(Config)
+	float SideScrollingCellSize = 2000.0f;
+
+	/** Max X distance from a viewer for a side-scrolling actor to be relevant */
+	UPROPERTY(Config)
+	float SideScrollingCullDistance = 6000.0f;
+
+	/** Grid node for spatialized actors */
+	UPROPERTY()
+	UReplicationGraphNode_GridSpatialization2D* GridNode;
+
+	/** X axis node for side-scrolling actors */
+	UPROPERTY()
+	UEscapeGameReplicationGraphNode_AxisX* AxisXNode;
+
+	/** Node for actors relevant to every connection */
+	UPROPERTY()
+	UReplicationGraphNode_ActorList* AlwaysRelevantNode;
+
+	/** Routing policy for each replicated class */
+	TClassMap<EEscapeGameRepNodeMapping> ClassRepNodePolicies;
+
+public:
+
+	/** Constructor */
+	UEscapeGameReplicationGraph();
+
+	// ~begin UReplicationGraph interface
+
+	/** Sets up routing policies and replication settings for every replicated class */
+	virtual void InitGlobalActorClassSettings() override;
+
+	/** Creates the global nodes */
+	virtual void InitGlobalGraphNodes() override;
+
+	/** Creates the per connection nodes */
+	virtual void InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection) override;
+
+	/** Adds a new replicated actor to the node chosen by its class policy */
+	virtual void RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo) override;
+
+	/** Removes a replicated actor from the node chosen by its class policy */
+	virtual void RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo) override;
+
+	// ~end UReplicationGraph interface
+
+protected:
+
+	/** Returns the routing policy for a class, deriving and caching one from its defaults if it wasn't set explicitly */
+	EEscapeGameRepNodeMapping GetMappingPolicy(UClass* Class);
+
+	/** Derives a routing policy from an actor class's default replication settings */
+	static EEscapeGameRepNodeMapping GetDefaultMappingPolicy(const AActor* ActorCDO);
+
+	/** Returns true if the policy spatializes actors on the grid */
+	static bool IsGridSpatialized(EEscapeGameRepNodeMapping Mapping);
+};
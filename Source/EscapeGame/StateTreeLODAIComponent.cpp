@@ -0,0 +1,139 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "StateTreeLODAIComponent.h"
+#include "AIController.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/World.h"
+#include "Engine/NetDriver.h"
+
+void UStateTreeLODAIComponent::NotifyCombatActivity()
+{
+	LastCombatActivityTime = GetWorld()->GetTimeSeconds();
+
+	// don't wait for the next idle update to react
+	TimeUntilUpdate = 0.0f;
+}
+
+UStateTreeLODAIComponent* UStateTreeLODAIComponent::FindForPawn(const APawn* Pawn)
+{
+	const AAIController* Controller = Pawn ? Cast<AAIController>(Pawn->GetController()) : nullptr;
+	return Controller ? Cast<UStateTreeLODAIComponent>(Controller->GetBrainComponent()) : nullptr;
+}
+
+void UStateTreeLODAIComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// spread idle updates across frames so agents spawned together don't all run on the same frame
+	TimeUntilUpdate = FMath::FRand() * IdleInterval;
+}
+
+void UStateTreeLODAIComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	AccumulatedDeltaTime += DeltaTime;
+	TimeUntilUpdate -= DeltaTime;
+
+	const float Interval = GetLODInterval();
+
+	// paused agents keep accumulating time until they resume
+	if (Interval < 0.0f)
+	{
+		return;
+	}
+
+	// wait for the next idle update
+	if (Interval > 0.0f && TimeUntilUpdate > 0.0f)
+	{
+		return;
+	}
+
+	TimeUntilUpdate = Interval;
+
+	// run the tree with all the time that passed since it last ran, clamped so a long pause doesn't become one huge step
+	const float TreeDeltaTime = FMath::Min(AccumulatedDeltaTime, MaxAccumulatedDeltaTime);
+	AccumulatedDeltaTime = 0.0f;
+
+	Super::TickComponent(TreeDeltaTime, TickType, ThisTickFunction);
+}
+
+void UStateTreeLODAIComponent::StartLogic()
+{
+	// a fresh tree shouldn't inherit time from a previous run
+	AccumulatedDeltaTime = 0.0f;
+	TimeUntilUpdate = 0.0f;
+
+	Super::StartLogic();
+}
+
+float UStateTreeLODAIComponent::GetLODInterval() const
+{
+	const UWorld* World = GetWorld();
+
+	// recently in combat?
+	if (World->GetTimeSeconds() - LastCombatActivityTime < EngagedTimeout)
+	{
+		return 0.0f;
+	}
+
+	const AAIController* Controller = GetAIOwner();
+	const APawn* Pawn = Controller ? Controller->GetPawn() : nullptr;
+
+	if (!Pawn)
+	{
+		return IdleInterval;
+	}
+
+	// close to any player?
+	if (IsNearAnyPlayer(Pawn->GetActorLocation()))
+	{
+		return 0.0f;
+	}
+
+	// off screen?
+	if (CanPauseWhenOffscreen() && !Pawn->WasRecentlyRendered(OffscreenGracePeriod))
+	{
+		return -1.0f;
+	}
+
+	return IdleInterval;
+}
+
+bool UStateTreeLODAIComponent::IsNearAnyPlayer(const FVector& Location) const
+{
+	const float EngagedDistanceSquared = FMath::Square(EngagedDistance);
+
+	// check every player, including remote ones on the server
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController = It->Get();
+		const APawn* PlayerPawn = PlayerController ? PlayerController->GetPawn() : nullptr;
+
+		if (PlayerPawn && FVector::DistSquared(PlayerPawn->GetActorLocation(), Location) < EngagedDistanceSquared)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool UStateTreeLODAIComponent::CanPauseWhenOffscreen() const
+{
+	if (!bPauseWhenOffscreen)
+	{
+		return false;
+	}
+
+	// dedicated servers never render, so they always treat agents as idle instead
+	if (IsNetMode(NM_DedicatedServer))
+	{
+		return false;
+	}
+
+	// rendering only reflects our local viewports, so don't pause agents remote players may be fighting
+	const UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+
+	return !NetDriver || NetDriver->ClientConnections.Num() == 0;
+}
@@ -0,0 +1,85 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/StateTreeAIComponent.h"
+#include "StateTreeLODAIComponent.generated.h"
+
+/**
+ *  A StateTree AI component that lowers its tick rate based on how relevant the agent currently is.
+ *  Engaged agents, either close to any player or recently in combat, run every frame.
+ *  Idle agents run at a reduced rate, and agents that haven't been rendered recently are paused.
+ *  Rendering only reflects local viewports, so agents are never paused while remote clients are connected.
+ *  Skipped frames are accumulated, so the tree receives the real elapsed time when it runs, up to a clamp.
+ */
+UCLASS(ClassGroup=(AI), meta=(BlueprintSpawnableComponent))
+class UStateTreeLODAIComponent : public UStateTreeAIComponent
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Agents closer than this distance to any player pawn run every frame */
+	UPROPERTY(EditAnywhere, Category="LOD", meta = (ClampMin = 0, ClampMax = 10000, Units = "cm"))
+	float EngagedDistance = 1500.0f;
+
+	/** Agents keep running every frame for this long after their last combat activity */
+	UPROPERTY(EditAnywhere, Category="LOD", meta = (ClampMin = 0, ClampMax = 30, Units = "s"))
+	float EngagedTimeout = 3.0f;
+
+	/** Time between StateTree updates for idle agents */
+	UPROPERTY(EditAnywhere, Category="LOD", meta = (ClampMin = 0, ClampMax = 1, Units = "s"))
+	float IdleInterval = 0.15f;
+
+	/** If true, idle agents that haven't been rendered recently are paused until they come back into view. Ignored while remote clients are connected */
+	UPROPERTY(EditAnywhere, Category="LOD")
+	bool bPauseWhenOffscreen = true;
+
+	/** Time since the agent was last rendered before it's considered off screen */
+	UPROPERTY(EditAnywhere, Category="LOD", meta = (ClampMin = 0, ClampMax = 5, Units = "s", EditCondition = "bPauseWhenOffscreen"))
+	float OffscreenGracePeriod = 0.5f;
+
+	/** Largest delta time passed to the tree in a single update, so resuming after a long pause doesn't feed it one huge step */
+	UPROPERTY(EditAnywhere, Category="LOD", meta = (ClampMin = 0.01, ClampMax = 5, Units = "s"))
+	float MaxAccumulatedDeltaTime = 0.5f;
+
+	/** Time that passed since the StateTree last ran */
+	float AccumulatedDeltaTime = 0.0f;
+
+	/** Time left until the next idle update */
+	float TimeUntilUpdate = 0.0f;
+
+	/** Game time of the last combat activity */
+	float LastCombatActivityTime = -1000.0f;
+
+public:
+
+	/** Flags the agent as engaged in combat, so it runs at full rate for a while */
+	void NotifyCombatActivity();
+
+	/** Finds the LOD StateTree component running on a pawn's AI controller, if any */
+	static UStateTreeLODAIComponent* FindForPawn(const APawn* Pawn);
+
+public:
+
+	/** Initialization */
+	virtual void BeginPlay() override;
+
+	/** Runs the StateTree at the interval chosen for the agent's current LOD */
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	/** Restarts the StateTree on the next tick */
+	virtual void StartLogic() override;
+
+protected:
+
+	/** Returns the time between StateTree updates for the agent's current LOD. 0 runs every frame, negative values pause the tree */
+	float GetLODInterval() const;
+
+	/** Returns true if the location is within the engaged distance of any player pawn */
+	bool IsNearAnyPlayer(const FVector& Location) const;
+
+	/** Returns true if the agent can be paused when it's not rendered locally */
+	bool CanPauseWhenOffscreen() const;
+};
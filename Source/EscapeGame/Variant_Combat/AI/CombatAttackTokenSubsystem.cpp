@@ -0,0 +1,115 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatAttackTokenSubsystem.h"
+#include "GameFramework/Actor.h"
+
+bool UCombatAttackTokenSubsystem::AcquireToken(AActor* Attacker, AActor* Target, int32 Cost)
+{
+	if (!CanAcquireToken(Attacker, Target, Cost))
+	{
+		return false;
+	}
+
+	TArray<FCombatAttackToken>& TargetTokens = Tokens.FindOrAdd(Target);
+
+	// do we already hold a token on this target?
+	for (const FCombatAttackToken& Token : TargetTokens)
+	{
+		if (Token.Attacker.Get() == Attacker)
+		{
+			return true;
+		}
+	}
+
+	// an attacker can only hold one token at a time
+	ReleaseToken(Attacker);
+
+	// forget targets that went away, so their entries don't pile up
+	PruneTargets();
+
+	FCombatAttackToken& Token = Tokens.FindOrAdd(Target).AddDefaulted_GetRef();
+	Token.Attacker = Attacker;
+	Token.Cost = ClampCost(Cost);
+
+	return true;
+}
+
+void UCombatAttackTokenSubsystem::ReleaseToken(const AActor* Attacker)
+{
+	for (auto It = Tokens.CreateIterator(); It; ++It)
+	{
+		TArray<FCombatAttackToken>& TargetTokens = It.Value();
+
+		if (TargetTokens.RemoveAllSwap([Attacker](const FCombatAttackToken& Token) { return Token.Attacker.Get() == Attacker; }) == 0)
+		{
+			continue;
+		}
+
+		// forget targets nobody is attacking
+		if (TargetTokens.Num() == 0)
+		{
+			It.RemoveCurrent();
+		}
+
+		return;
+	}
+}
+
+bool UCombatAttackTokenSubsystem::CanAcquireToken(const AActor* Attacker, AActor* Target, int32 Cost)
+{
+	if (!IsValid(Attacker) || !IsValid(Target))
+	{
+		return false;
+	}
+
+	TArray<FCombatAttackToken>* TargetTokens = Tokens.Find(Target);
+
+	if (!TargetTokens)
+	{
+		return true;
+	}
+
+	// attackers that already hold a token can keep attacking
+	for (const FCombatAttackToken& Token : *TargetTokens)
+	{
+		if (Token.Attacker.Get() == Attacker)
+		{
+			return true;
+		}
+	}
+
+	return GetUsedSlots(*TargetTokens) + ClampCost(Cost) <= MaxTokensPerTarget;
+}
+
+int32 UCombatAttackTokenSubsystem::GetUsedSlots(TArray<FCombatAttackToken>& TargetTokens) const
+{
+	// attackers that were destroyed without releasing their token don't count
+	TargetTokens.RemoveAllSwap([](const FCombatAttackToken& Token) { return !Token.Attacker.IsValid(); });
+
+	int32 UsedSlots = 0;
+
+	for (const FCombatAttackToken& Token : TargetTokens)
+	{
+		UsedSlots += Token.Cost;
+	}
+
+	return UsedSlots;
+}
+
+int32 UCombatAttackTokenSubsystem::ClampCost(int32 Cost) const
+{
+	// costs above the slot count would never fit, so take up the whole target instead
+	return FMath::Clamp(Cost, 0, FMath::Max(MaxTokensPerTarget, 0));
+}
+
+void UCombatAttackTokenSubsystem::PruneTargets()
+{
+	for (auto It = Tokens.CreateIterator(); It; ++It)
+	{
+		if (!It.Key().IsValid() || It.Value().Num() == 0)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
@@ -0,0 +1,60 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CombatAttackTokenSubsystem.generated.h"
+
+/** An attack token held by an attacker */
+struct FCombatAttackToken
+{
+	/** Actor holding the token */
+	TWeakObjectPtr<AActor> Attacker;
+
+	/** Number of slots this token takes up */
+	int32 Cost = 1;
+};
+
+/**
+ *  Limits how many enemies can attack the same target at once.
+ *  Each target has a fixed number of attack slots. Attackers must acquire a token before attacking and release it when done.
+ *  Enemies that can't get a token are expected to wait in cheaper idle or strafing states.
+ *  Token costs are clamped to the slot count, so an expensive attacker takes up the whole target instead of never attacking.
+ */
+UCLASS(config=Game)
+class UCombatAttackTokenSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Number of attack slots available on each target */
+	UPROPERTY(Config)
+	int32 MaxTokensPerTarget = 2;
+
+	/** Tokens currently granted, per target. Targets that went away are pruned when tokens are acquired */
+	TMap<TWeakObjectPtr<AActor>, TArray<FCombatAttackToken>> Tokens;
+
+public:
+
+	/** Tries to acquire an attack token on the target. Returns true if the attacker holds a token afterwards */
+	bool AcquireToken(AActor* Attacker, AActor* Target, int32 Cost);
+
+	/** Releases any token held by the attacker */
+	void ReleaseToken(const AActor* Attacker);
+
+	/** Returns true if the attacker could acquire a token on the target right now */
+	bool CanAcquireToken(const AActor* Attacker, AActor* Target, int32 Cost);
+
+protected:
+
+	/** Drops tokens from attackers that have gone away and returns the slots used on the target */
+	int32 GetUsedSlots(TArray<FCombatAttackToken>& TargetTokens) const;
+
+	/** Clamps a token cost to the number of slots available on a target */
+	int32 ClampCost(int32 Cost) const;
+
+	/** Forgets targets that have gone away or have no tokens left */
+	void PruneTargets();
+};
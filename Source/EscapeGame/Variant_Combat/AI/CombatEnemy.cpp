@@ -5,17 +5,33 @@
 #include "Components/CapsuleComponent.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "CombatAIController.h"
-#include "Components/WidgetComponent.h"
+#include "CombatLifeBarComponent.h"
 #include "Engine/DamageEvents.h"
-#include "CombatLifeBar.h"
 #include "TimerManager.h"
 #include "Components/SkeletalMeshComponent.h"
 #include "Animation/AnimInstance.h"
+#include "CombatTargetGridSubsystem.h"
+#include "CombatHitReactionComponent.h"
+#include "CombatHurtboxHistoryComponent.h"
+#include "CombatRagdollSubsystem.h"
+#include "AIController.h"
+#include "BrainComponent.h"
+#include "AIStateTreeEvents.h"
+#include "StateTreeLODAIComponent.h"
+#include "CombatAttackTokenSubsystem.h"
+#include "CombatEnemyArchetypeSubsystem.h"
+#include "CombatSimulation.h"
+#include "CombatEnemyStateSubsystem.h"
 
 ACombatEnemy::ACombatEnemy()
 {
 	PrimaryActorTick.bCanEverTick = true;
 
+	// enemies are numerous, so replicate them less often than players
+	bReplicates = true;
+	SetNetUpdateFrequency(20.0f);
+	SetMinNetUpdateFrequency(5.0f);
+
 	// bind the attack montage ended delegate
 	OnAttackMontageEnded.BindUObject(this, &ACombatEnemy::AttackMontageEnded);
 
@@ -29,9 +45,15 @@ ACombatEnemy::ACombatEnemy()
 	bUseControllerRotationYaw = false;
 
 	// create the life bar
-	LifeBar = CreateDefaultSubobject<UWidgetComponent>(TEXT("LifeBar"));
+	LifeBar = CreateDefaultSubobject<UCombatLifeBarComponent>(TEXT("LifeBar"));
 	LifeBar->SetupAttachment(RootComponent);
 
+	// create the hit reaction component
+	HitReaction = CreateDefaultSubobject<UCombatHitReactionComponent>(TEXT("HitReaction"));
+
+	// create the hurtbox history component so player attacks can be lag compensated against us
+	HurtboxHistory = CreateDefaultSubobject<UCombatHurtboxHistoryComponent>(TEXT("HurtboxHistory"));
+
 	// set the collision capsule size
 	GetCapsuleComponent()->SetCapsuleSize(35.0f, 90.0f);
 
@@ -39,7 +61,7 @@ ACombatEnemy::ACombatEnemy()
 	GetCharacterMovement()->bUseControllerDesiredRotation = true;
 
 	// reset HP to maximum
-	CurrentHP = MaxHP;
+	CurrentHP = GetArchetypeData().MaxHP;
 }
 
 void ACombatEnemy::DoAIComboAttack()
@@ -53,8 +75,14 @@ void ACombatEnemy::DoAIComboAttack()
 	// raise the attacking flag
 	bIsAttacking = true;
 
+	// keep our StateTree at full rate while attacking
+	if (UStateTreeLODAIComponent* StateTreeLOD = UStateTreeLODAIComponent::FindForPawn(this))
+	{
+		StateTreeLOD->NotifyCombatActivity();
+	}
+
 	// choose how many times we're going to attack
-	TargetComboCount = FMath::RandRange(1, ComboSectionNames.Num() - 1);
+	TargetComboCount = FCombatRules::RollComboCount(AttackRandom, GetArchetypeData().ComboSectionNames.Num());
 
 	// reset the attack counter
 	CurrentComboAttack = 0;
@@ -71,6 +99,10 @@ void ACombatEnemy::DoAIComboAttack()
 			AnimInstance->Montage_SetEndDelegate(OnAttackMontageEnded, ComboAttackMontage);
 		}
 	}
+
+	// show the attack to clients
+	MulticastAttackMontage(ComboAttackMontage, NAME_None);
+	UpdateReplicatedState();
 }
 
 void ACombatEnemy::DoAIChargedAttack()
@@ -84,8 +116,15 @@ void ACombatEnemy::DoAIChargedAttack()
 	// raise the attacking flag
 	bIsAttacking = true;
 
+	// keep our StateTree at full rate while attacking
+	if (UStateTreeLODAIComponent* StateTreeLOD = UStateTreeLODAIComponent::FindForPawn(this))
+	{
+		StateTreeLOD->NotifyCombatActivity();
+	}
+
 	// choose how many loops are we going to charge for
-	TargetChargeLoops = FMath::RandRange(MinChargeLoops, MaxChargeLoops);
+	const FCombatEnemyArchetypeData& ArchetypeData = GetArchetypeData();
+	TargetChargeLoops = FCombatRules::RollChargeLoops(AttackRandom, ArchetypeData.MinChargeLoops, ArchetypeData.MaxChargeLoops);
 
 	// reset the charge loop counter
 	CurrentChargeLoop = 0;
@@ -102,25 +141,256 @@ void ACombatEnemy::DoAIChargedAttack()
 			AnimInstance->Montage_SetEndDelegate(OnAttackMontageEnded, ChargedAttackMontage);
 		}
 	}
+
+	// show the attack to clients
+	MulticastAttackMontage(ChargedAttackMontage, NAME_None);
+	UpdateReplicatedState();
 }
 
 void ACombatEnemy::AttackMontageEnded(UAnimMontage* Montage, bool bInterrupted)
 {
 	// reset the attacking flag
 	bIsAttacking = false;
+	UpdateReplicatedState();
 
 	// call the attack completed delegate so the StateTree can continue execution
 	OnAttackCompleted.ExecuteIfBound();
 }
 
+bool ACombatEnemy::AcquireAttackToken(AActor* Target)
+{
+	// attack freely if there's no token subsystem
+	if (UCombatAttackTokenSubsystem* AttackTokens = GetWorld()->GetSubsystem<UCombatAttackTokenSubsystem>())
+	{
+		return AttackTokens->AcquireToken(this, Target, GetArchetypeData().AttackTokenCost);
+	}
+
+	return true;
+}
+
+bool ACombatEnemy::CanAcquireAttackToken(AActor* Target) const
+{
+	if (UCombatAttackTokenSubsystem* AttackTokens = GetWorld()->GetSubsystem<UCombatAttackTokenSubsystem>())
+	{
+		return AttackTokens->CanAcquireToken(this, Target, GetArchetypeData().AttackTokenCost);
+	}
+
+	return true;
+}
+
+void ACombatEnemy::ReleaseAttackToken()
+{
+	if (UCombatAttackTokenSubsystem* AttackTokens = GetWorld()->GetSubsystem<UCombatAttackTokenSubsystem>())
+	{
+		AttackTokens->ReleaseToken(this);
+	}
+}
+
+const FCombatEnemyArchetypeData& ACombatEnemy::GetArchetypeData() const
+{
+	return ArchetypeRegistry ? ArchetypeRegistry->GetArchetype(ArchetypeIndex) : UCombatEnemyArchetypeSubsystem::GetDefaultArchetype();
+}
+
+float ACombatEnemy::GetLifeFraction() const
+{
+	const float MaxHP = GetArchetypeData().MaxHP;
+
+	return MaxHP > 0.0f ? FMath::Clamp(CurrentHP / MaxHP, 0.0f, 1.0f) : 0.0f;
+}
+
+ECombatEnemyStateFlags ACombatEnemy::GetStateFlags() const
+{
+	ECombatEnemyStateFlags Flags = ECombatEnemyStateFlags::None;
+
+	if (FCombatRules::IsDead(CurrentHP))
+	{
+		Flags |= ECombatEnemyStateFlags::Dead;
+	}
+
+	if (bIsAttacking)
+	{
+		Flags |= ECombatEnemyStateFlags::Attacking;
+	}
+
+	return Flags;
+}
+
+void ACombatEnemy::ApplyReplicatedState(float LifeFraction, ECombatEnemyStateFlags Flags)
+{
+	// keep the latest state so we can apply it once we've begun play
+	ReplicatedLifeFraction = LifeFraction;
+	ReplicatedFlags = Flags;
+
+	if (HasActorBegunPlay())
+	{
+		RefreshReplicatedState();
+	}
+}
+
+void ACombatEnemy::DeactivateForPool()
+{
+	// raise the pooled flag
+	bIsPooled = true;
+
+	// clear the death timer in case we're being pooled early
+	GetWorld()->GetTimerManager().ClearTimer(DeathTimer);
+
+	// free up our attack slot
+	ReleaseAttackToken();
+
+	// pause the StateTree
+	if (AAIController* AIController = Cast<AAIController>(GetController()))
+	{
+		AIController->StopMovement();
+
+		if (UBrainComponent* Brain = AIController->GetBrainComponent())
+		{
+			Brain->StopLogic(TEXT("Pooled"));
+		}
+	}
+
+	// stop any montages and hit reactions
+	if (UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance())
+	{
+		AnimInstance->StopAllMontages(0.0f);
+	}
+
+	HitReaction->StopHitReaction();
+
+	// remove ourselves from the combat target grid
+	if (UCombatTargetGridSubsystem* TargetGrid = GetWorld()->GetSubsystem<UCombatTargetGridSubsystem>())
+	{
+		TargetGrid->UnregisterTarget(this);
+	}
+
+	// stop any ragdoll physics and free up our budget slot
+	GetMesh()->SetSimulatePhysics(false);
+
+	if (UCombatRagdollSubsystem* Ragdolls = GetWorld()->GetSubsystem<UCombatRagdollSubsystem>())
+	{
+		Ragdolls->ReleaseRagdoll(GetMesh());
+	}
+
+	// disable movement
+	GetCharacterMovement()->DisableMovement();
+
+	// hide the actor and turn off collision
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+
+	// stop ticking the actor and its most expensive components
+	SetActorTickEnabled(false);
+	GetMesh()->SetComponentTickEnabled(false);
+	GetCharacterMovement()->SetComponentTickEnabled(false);
+	LifeBar->SetComponentTickEnabled(false);
+	HurtboxHistory->SetComponentTickEnabled(false);
+}
+
+void ACombatEnemy::ActivateFromPool(const FTransform& SpawnTransform)
+{
+	// lower the pooled flag
+	bIsPooled = false;
+
+	// reset the attack state
+	bIsAttacking = false;
+	TargetComboCount = 0;
+	CurrentComboAttack = 0;
+	TargetChargeLoops = 0;
+	CurrentChargeLoop = 0;
+
+	// reset the mesh from any ragdoll or frozen state
+	ResetMesh();
+
+	// move to the spawn transform
+	SetActorLocationAndRotation(SpawnTransform.GetLocation(), SpawnTransform.GetRotation(), false, nullptr, ETeleportType::ResetPhysics);
+
+	// don't let attacks rewind to where we were before the teleport
+	HurtboxHistory->ClearHistory();
+
+	// restore the collision capsule
+	GetCapsuleComponent()->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
+
+	// show the actor and turn collision back on
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+
+	// resume ticking
+	SetActorTickEnabled(true);
+	GetMesh()->SetComponentTickEnabled(true);
+	GetCharacterMovement()->SetComponentTickEnabled(true);
+	LifeBar->SetComponentTickEnabled(true);
+	HurtboxHistory->SetComponentTickEnabled(true);
+
+	// restore movement
+	GetCharacterMovement()->StopMovementImmediately();
+	GetCharacterMovement()->SetMovementMode(MOVE_Walking);
+
+	// reset HP to maximum
+	CurrentHP = GetArchetypeData().MaxHP;
+	UpdateReplicatedState();
+
+	// show and fill the life bar
+	LifeBar->SetBarVisible(true);
+	LifeBar->SetLifePercentage(1.0f);
+
+	// register with the combat target grid again
+	if (UCombatTargetGridSubsystem* TargetGrid = GetWorld()->GetSubsystem<UCombatTargetGridSubsystem>())
+	{
+		TargetGrid->RegisterTarget(this, GetCapsuleComponent(), ECombatTargetType::Pawn);
+	}
+
+	// face the spawn direction and restart the StateTree
+	if (AAIController* AIController = Cast<AAIController>(GetController()))
+	{
+		AIController->SetControlRotation(SpawnTransform.Rotator());
+
+		if (UBrainComponent* Brain = AIController->GetBrainComponent())
+		{
+			Brain->RestartLogic();
+		}
+	}
+}
+
 void ACombatEnemy::DoAttackTrace(FName DamageSourceBone)
 {
-	// sweep for objects in front of the character to be hit by the attack
-	TArray<FHitResult> OutHits;
+	// hits are only resolved by the server
+	if (!HasAuthority())
+	{
+		return;
+	}
+
+	// all attack tuning values are packed together in our archetype
+	const FCombatEnemyArchetypeData& ArchetypeData = GetArchetypeData();
 
 	// start at the provided socket location, sweep forward
 	const FVector TraceStart = GetMesh()->GetSocketLocation(DamageSourceBone);
-	const FVector TraceEnd = TraceStart + (GetActorForwardVector() * MeleeTraceDistance);
+	const FVector TraceEnd = TraceStart + (GetActorForwardVector() * ArchetypeData.MeleeTraceDistance);
+
+	// use the combat target grid if it's available so we don't have to touch the physics scene
+	if (UCombatTargetGridSubsystem* TargetGrid = GetWorld()->GetSubsystem<UCombatTargetGridSubsystem>())
+	{
+		// enemies only affect pawns; they don't knock back boxes
+		TArray<FCombatTargetCandidate> Candidates;
+		TargetGrid->QueryCapsule(TraceStart, TraceEnd, ArchetypeData.MeleeTraceRadius, ECombatTargetType::Pawn, this, Candidates);
+
+		for (const FCombatTargetCandidate& Candidate : Candidates)
+		{
+			/** does the actor have the player tag? */
+			if (Candidate.Actor->ActorHasTag(FName("Player")))
+			{
+				// knock upwards and away from the impact normal
+				const FVector Impulse = FCombatRules::ComputeKnockback(Candidate.ImpactNormal, ArchetypeData.MeleeKnockbackImpulse, ArchetypeData.MeleeLaunchImpulse);
+
+				// pass the damage event to the actor
+				Candidate.Damageable->ApplyDamage(ArchetypeData.MeleeDamage, this, Candidate.ImpactPoint, Impulse);
+			}
+		}
+
+		return;
+	}
+
+	// sweep for objects in front of the character to be hit by the attack
+	TArray<FHitResult> OutHits;
 
 	// enemies only affect Pawn collision objects; they don't knock back boxes
 	FCollisionObjectQueryParams ObjectParams;
@@ -128,7 +398,7 @@ void ACombatEnemy::DoAttackTrace(FName DamageSourceBone)
 
 	// use a sphere shape for the sweep
 	FCollisionShape CollisionShape;
-	CollisionShape.SetSphere(MeleeTraceRadius);
+	CollisionShape.SetSphere(ArchetypeData.MeleeTraceRadius);
 
 	// ignore self
 	FCollisionQueryParams QueryParams;
@@ -148,10 +418,10 @@ void ACombatEnemy::DoAttackTrace(FName DamageSourceBone)
 				if (Damageable)
 				{
 					// knock upwards and away from the impact normal
-					const FVector Impulse = (CurrentHit.ImpactNormal * -MeleeKnockbackImpulse) + (FVector::UpVector * MeleeLaunchImpulse);
+					const FVector Impulse = FCombatRules::ComputeKnockback(CurrentHit.ImpactNormal, ArchetypeData.MeleeKnockbackImpulse, ArchetypeData.MeleeLaunchImpulse);
 
 					// pass the damage event to the actor
-					Damageable->ApplyDamage(MeleeDamage, this, CurrentHit.ImpactPoint, Impulse);
+					Damageable->ApplyDamage(ArchetypeData.MeleeDamage, this, CurrentHit.ImpactPoint, Impulse);
 
 				}
 			}
@@ -161,30 +431,52 @@ void ACombatEnemy::DoAttackTrace(FName DamageSourceBone)
 
 void ACombatEnemy::CheckCombo()
 {
+	// clients follow the server's section changes instead
+	if (!HasAuthority())
+	{
+		return;
+	}
+
 	// increase the combo counter
 	++CurrentComboAttack;
 
 	// do we still have attacks to play in this string?
-	if (CurrentComboAttack < TargetComboCount)
+	if (FCombatRules::ShouldContinueCombo(CurrentComboAttack, TargetComboCount))
 	{
+		const FName Section = GetArchetypeData().ComboSectionNames[CurrentComboAttack];
+
 		// jump to the next attack section
 		if (UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance())
 		{
-			AnimInstance->Montage_JumpToSection(ComboSectionNames[CurrentComboAttack], ComboAttackMontage);
+			AnimInstance->Montage_JumpToSection(Section, ComboAttackMontage);
 		}
+
+		// show the next attack to clients
+		MulticastAttackMontage(ComboAttackMontage, Section);
 	}
 }
 
 void ACombatEnemy::CheckChargedAttack()
 {
+	// clients follow the server's section changes instead
+	if (!HasAuthority())
+	{
+		return;
+	}
+
 	// increase the charge loop counter
 	++CurrentChargeLoop;
 
 	// jump to either the loop or attack section of the montage depending on whether we hit the loop target
+	const FName Section = FCombatRules::ShouldLoopCharge(CurrentChargeLoop, TargetChargeLoops) ? ChargeLoopSection : ChargeAttackSection;
+
 	if (UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance())
 	{
-		AnimInstance->Montage_JumpToSection(CurrentChargeLoop >= TargetChargeLoops ? ChargeAttackSection : ChargeLoopSection, ChargedAttackMontage);
+		AnimInstance->Montage_JumpToSection(Section, ChargedAttackMontage);
 	}
+
+	// show the section change to clients
+	MulticastAttackMontage(ChargedAttackMontage, Section);
 }
 
 void ACombatEnemy::ApplyDamage(float Damage, AActor* DamageCauser, const FVector& DamageLocation, const FVector& DamageImpulse)
@@ -197,47 +489,73 @@ void ACombatEnemy::ApplyDamage(float Damage, AActor* DamageCauser, const FVector
 	// only process knockback and effects if we received nonzero damage
 	if (ActualDamage > 0.0f)
 	{
-		// apply the knockback impulse
-		GetCharacterMovement()->AddImpulse(DamageImpulse, true);
-
-		// is the character ragdolling?
-		if (GetMesh()->IsSimulatingPhysics())
+		// react at full rate while we're being hit
+		if (UStateTreeLODAIComponent* StateTreeLOD = UStateTreeLODAIComponent::FindForPawn(this))
 		{
-			// apply an impulse to the ragdoll
-			GetMesh()->AddImpulseAtLocation(DamageImpulse * GetMesh()->GetMass(), DamageLocation);
+			StateTreeLOD->NotifyCombatActivity();
 		}
 
-		// stop the attack montages to interrupt the attack
-		if (UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance())
-		{
-			AnimInstance->Montage_Stop(0.1f, ComboAttackMontage);
-			AnimInstance->Montage_Stop(0.1f, ChargedAttackMontage);
-		}
+		// apply the knockback impulse. Character movement replicates the result
+		GetCharacterMovement()->AddImpulse(DamageImpulse, true);
 
-		// pass control to BP to play effects, etc.
-		ReceivedDamage(ActualDamage, DamageLocation, DamageImpulse.GetSafeNormal());
+		// interrupt the attack and play the hit effects on every machine
+		MulticastDamageEffects(ActualDamage, DamageLocation, DamageImpulse, FCombatRules::IsDead(CurrentHP));
 	}
 }
 
 void ACombatEnemy::HandleDeath()
 {
+	// stop any hit reaction in progress
+	HitReaction->StopHitReaction();
+
 	// hide the life bar
-	LifeBar->SetHiddenInGame(true);
+	LifeBar->SetBarVisible(false);
 
 	// disable the collision capsule to avoid being hit again while dead
 	GetCapsuleComponent()->SetCollisionEnabled(ECollisionEnabled::NoCollision);
 
+	// remove ourselves from the combat target grid
+	if (UCombatTargetGridSubsystem* TargetGrid = GetWorld()->GetSubsystem<UCombatTargetGridSubsystem>())
+	{
+		TargetGrid->UnregisterTarget(this);
+	}
+
 	// disable character movement
 	GetCharacterMovement()->DisableMovement();
 
-	// enable full ragdoll physics
-	GetMesh()->SetSimulatePhysics(true);
+	// enable full ragdoll physics if the budget allows it
+	if (UCombatRagdollSubsystem* Ragdolls = GetWorld()->GetSubsystem<UCombatRagdollSubsystem>())
+	{
+		Ragdolls->RequestRagdoll(GetMesh(), RagdollSignificance, DeathMontage);
+	}
+	else
+	{
+		GetMesh()->SetSimulatePhysics(true);
+	}
+
+	// apply the impulse of a lethal hit that arrived before the death state
+	if (!PendingDeathImpulse.IsZero())
+	{
+		if (GetMesh()->IsSimulatingPhysics())
+		{
+			GetMesh()->AddImpulseAtLocation(PendingDeathImpulse * GetMesh()->GetMass(), PendingDeathImpulseLocation);
+		}
+
+		PendingDeathImpulse = FVector::ZeroVector;
+	}
 
-	// call the died delegate to notify any subscribers
-	OnEnemyDied.Broadcast();
+	// clients run this from the HP rep notify, but gameplay consequences only happen on the server
+	if (HasAuthority())
+	{
+		// free up our attack slot
+		ReleaseAttackToken();
+
+		// call the died delegate to notify any subscribers
+		OnEnemyDied.Broadcast();
 
-	// set up the death timer
-	GetWorld()->GetTimerManager().SetTimer(DeathTimer, this, &ACombatEnemy::RemoveFromLevel, DeathRemovalTime);
+		// set up the death timer
+		GetWorld()->GetTimerManager().SetTimer(DeathTimer, this, &ACombatEnemy::RemoveFromLevel, GetArchetypeData().DeathRemovalTime);
+	}
 }
 
 void ACombatEnemy::ApplyHealing(float Healing, AActor* Healer)
@@ -247,23 +565,145 @@ void ACombatEnemy::ApplyHealing(float Healing, AActor* Healer)
 
 void ACombatEnemy::RemoveFromLevel()
 {
-	// destroy this actor
-	Destroy();
+	// hand ourselves back to the owning spawner if there is one, otherwise destroy this actor
+	if (!OnEnemyRemoved.ExecuteIfBound(this))
+	{
+		Destroy();
+	}
+}
+
+void ACombatEnemy::ResetMesh()
+{
+	// reset the mesh from any ragdoll or frozen state and reattach it to the capsule
+	UCombatRagdollSubsystem::ThawPose(GetMesh());
+	GetMesh()->SetSimulatePhysics(false);
+	GetMesh()->SetAllBodiesSimulatePhysics(false);
+	GetMesh()->SetPhysicsBlendWeight(0.0f);
+	GetMesh()->AttachToComponent(GetCapsuleComponent(), FAttachmentTransformRules::SnapToTargetIncludingScale);
+	GetMesh()->SetRelativeTransform(MeshStartingTransform);
+}
+
+void ACombatEnemy::PlayAttackMontage(UAnimMontage* Montage, FName Section)
+{
+	UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance();
+
+	if (!AnimInstance || !Montage)
+	{
+		return;
+	}
+
+	// start the montage over for a new attack, or if we missed its start
+	if (Section.IsNone() || !AnimInstance->Montage_IsPlaying(Montage))
+	{
+		bIsAttacking = true;
+
+		AnimInstance->Montage_Play(Montage, 1.0f, EMontagePlayReturnType::MontageLength, 0.0f, true);
+	}
+
+	// jump to the requested section
+	if (!Section.IsNone())
+	{
+		AnimInstance->Montage_JumpToSection(Section, Montage);
+	}
+}
+
+void ACombatEnemy::MulticastAttackMontage_Implementation(UAnimMontage* Montage, FName Section)
+{
+	// the server played this already
+	if (HasAuthority())
+	{
+		return;
+	}
+
+	PlayAttackMontage(Montage, Section);
+}
+
+void ACombatEnemy::MulticastDamageEffects_Implementation(float Damage, FVector_NetQuantize DamageLocation, FVector_NetQuantize10 DamageImpulse, bool bLethal)
+{
+	// is the character ragdolling?
+	if (GetMesh()->IsSimulatingPhysics())
+	{
+		// apply an impulse to the ragdoll
+		GetMesh()->AddImpulseAtLocation(DamageImpulse * GetMesh()->GetMass(), DamageLocation);
+	}
+	else if (bLethal)
+	{
+		// the death state hasn't reached us yet, so keep the impulse until the ragdoll starts
+		PendingDeathImpulse = DamageImpulse;
+		PendingDeathImpulseLocation = DamageLocation;
+	}
+
+	// stop the attack montages to interrupt the attack
+	if (UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance())
+	{
+		AnimInstance->Montage_Stop(0.1f, ComboAttackMontage);
+		AnimInstance->Montage_Stop(0.1f, ChargedAttackMontage);
+	}
+
+	// react to the hit if we survived it
+	if (!bLethal)
+	{
+		HitReaction->PlayHitReaction(DamageImpulse, PelvisBoneName);
+	}
+
+	// pass control to BP to play effects, etc.
+	ReceivedDamage(Damage, DamageLocation, DamageImpulse.GetSafeNormal());
+}
+
+void ACombatEnemy::UpdateReplicatedState()
+{
+	if (UCombatEnemyStateSubsystem* EnemyStates = GetWorld()->GetSubsystem<UCombatEnemyStateSubsystem>())
+	{
+		EnemyStates->UpdateEnemy(this);
+	}
+}
+
+void ACombatEnemy::RefreshReplicatedState()
+{
+	const bool bWasDead = FCombatRules::IsDead(CurrentHP);
+
+	bIsAttacking = EnumHasAnyFlags(ReplicatedFlags, ECombatEnemyStateFlags::Attacking);
+
+	// have we just run out of HP?
+	if (EnumHasAnyFlags(ReplicatedFlags, ECombatEnemyStateFlags::Dead))
+	{
+		CurrentHP = 0.0f;
+
+		if (!bWasDead)
+		{
+			HandleDeath();
+		}
+
+		return;
+	}
+
+	// keep a local copy of our HP so StateTree and Blueprints can read it
+	CurrentHP = ReplicatedLifeFraction * GetArchetypeData().MaxHP;
+
+	// have we been reactivated from a pool?
+	if (bWasDead)
+	{
+		ResetMesh();
+		GetCapsuleComponent()->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
+		LifeBar->SetBarVisible(true);
+	}
+
+	// update the life bar
+	LifeBar->SetLifePercentage(ReplicatedLifeFraction);
 }
 
 float ACombatEnemy::TakeDamage(float Damage, struct FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser)
 {
-	// only process damage if the character is still alive
-	if (CurrentHP <= 0.0f)
+	// reduce the current HP. This does nothing if we're already dead
+	const float AppliedDamage = FCombatRules::ApplyDamage(CurrentHP, Damage);
+
+	if (AppliedDamage <= 0.0f)
 	{
 		return 0.0f;
 	}
 
-	// reduce the current HP
-	CurrentHP -= Damage;
-
 	// have we run out of HP?
-	if (CurrentHP <= 0.0f)
+	if (FCombatRules::IsDead(CurrentHP))
 	{
 		// die
 		HandleDeath();
@@ -271,46 +711,86 @@ float ACombatEnemy::TakeDamage(float Damage, struct FDamageEvent const& DamageEv
 	else
 	{
 		// update the life bar
-		LifeBarWidget->SetLifePercentage(CurrentHP / MaxHP);
-
-		// enable partial ragdoll physics, but keep the pelvis vertical
-		GetMesh()->SetPhysicsBlendWeight(0.5f);
-		GetMesh()->SetBodySimulatePhysics(PelvisBoneName, false);
+		LifeBar->SetLifePercentage(CurrentHP / GetArchetypeData().MaxHP);
 	}
 
+	// send the new HP to clients
+	UpdateReplicatedState();
+
 	// return the received damage amount
-	return Damage;
+	return AppliedDamage;
 }
 
 void ACombatEnemy::Landed(const FHitResult& Hit)
 {
 	Super::Landed(Hit);
 
-	// is the character still alive?
-	if (CurrentHP >= 0.0f)
+	// is the character still alive and reacting to a hit with physics?
+	if (CurrentHP >= 0.0f && HitReaction->IsPhysicalReactionActive())
 	{
 		// disable ragdoll physics
-		GetMesh()->SetPhysicsBlendWeight(0.0f);
+		HitReaction->ResetPhysicalReaction();
 	}
 
 	// call the landed Delegate for StateTree
 	OnEnemyLanded.ExecuteIfBound();
 }
 
+void ACombatEnemy::OnMovementModeChanged(EMovementMode PrevMovementMode, uint8 PreviousCustomMode)
+{
+	Super::OnMovementModeChanged(PrevMovementMode, PreviousCustomMode);
+
+	// send a movement event to the StateTree
+	FAIStateTreeEvents::SendMovementModeEvent(this, PrevMovementMode);
+}
+
 void ACombatEnemy::BeginPlay()
 {
-	// reset HP to maximum
-	CurrentHP = MaxHP;
+	// seed our attack choices
+	AttackRandom.Initialize(AttackRandomSeed != 0 ? AttackRandomSeed : FMath::Rand());
+
+	// look up our compiled archetype
+	ArchetypeRegistry = GetWorld()->GetSubsystem<UCombatEnemyArchetypeSubsystem>();
+
+	if (ArchetypeRegistry)
+	{
+		ArchetypeIndex = ArchetypeRegistry->RegisterArchetype(Archetype);
+	}
+
+	// reset HP to maximum. Clients receive their HP from the server
+	if (HasAuthority())
+	{
+		CurrentHP = GetArchetypeData().MaxHP;
+	}
 
 	// we top the HP before BeginPlay so StateTree picks it up at the right value
 	Super::BeginPlay();
 
-	// get the life bar widget from the widget comp
-	LifeBarWidget = Cast<UCombatLifeBar>(LifeBar->GetUserWidgetObject());
-	check(LifeBarWidget);
+	// save the relative transform for the mesh so we can reset the ragdoll later
+	MeshStartingTransform = GetMesh()->GetRelativeTransform();
+
+	if (HasAuthority())
+	{
+		// fill the life bar
+		LifeBar->SetLifePercentage(1.0f);
 
-	// fill the life bar
-	LifeBarWidget->SetLifePercentage(1.0f);
+		// start replicating our HP and state flags
+		if (UCombatEnemyStateSubsystem* EnemyStates = GetWorld()->GetSubsystem<UCombatEnemyStateSubsystem>())
+		{
+			EnemyStates->RegisterEnemy(this);
+		}
+	}
+	else
+	{
+		// apply any state we received before beginning play
+		RefreshReplicatedState();
+	}
+
+	// register with the combat target grid so attacks can find us
+	if (UCombatTargetGridSubsystem* TargetGrid = GetWorld()->GetSubsystem<UCombatTargetGridSubsystem>())
+	{
+		TargetGrid->RegisterTarget(this, GetCapsuleComponent(), ECombatTargetType::Pawn);
+	}
 }
 
 void ACombatEnemy::EndPlay(EEndPlayReason::Type EndPlayReason)
@@ -319,4 +799,25 @@ void ACombatEnemy::EndPlay(EEndPlayReason::Type EndPlayReason)
 
 	// clear the death timer
 	GetWorld()->GetTimerManager().ClearTimer(DeathTimer);
+
+	// free up our attack slot
+	ReleaseAttackToken();
+
+	// stop replicating our state
+	if (UCombatEnemyStateSubsystem* EnemyStates = GetWorld()->GetSubsystem<UCombatEnemyStateSubsystem>())
+	{
+		EnemyStates->UnregisterEnemy(this);
+	}
+
+	// remove ourselves from the combat target grid
+	if (UCombatTargetGridSubsystem* TargetGrid = GetWorld()->GetSubsystem<UCombatTargetGridSubsystem>())
+	{
+		TargetGrid->UnregisterTarget(this);
+	}
+
+	// free up our ragdoll budget slot
+	if (UCombatRagdollSubsystem* Ragdolls = GetWorld()->GetSubsystem<UCombatRagdollSubsystem>())
+	{
+		Ragdolls->ReleaseRagdoll(GetMesh());
+	}
 }
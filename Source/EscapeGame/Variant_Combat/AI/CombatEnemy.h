@@ -8,11 +8,18 @@
 #include "CombatDamageable.h"
 #include "Animation/AnimMontage.h"
 #include "Engine/TimerHandle.h"
+#include "Math/RandomStream.h"
+#include "Engine/NetSerialization.h"
+#include "CombatEnemyStateReplicator.h"
 #include "CombatEnemy.generated.h"
 
-class UWidgetComponent;
-class UCombatLifeBar;
+class UCombatLifeBarComponent;
+class UCombatHitReactionComponent;
+class UCombatHurtboxHistoryComponent;
 class UAnimMontage;
+class UCombatEnemyArchetype;
+class UCombatEnemyArchetypeSubsystem;
+struct FCombatEnemyArchetypeData;
 
 /** Completed attack animation delegate for StateTree */
 DECLARE_DELEGATE(FOnEnemyAttackCompleted);
@@ -23,6 +30,9 @@ DECLARE_DELEGATE(FOnEnemyLanded);
 /** Enemy died delegate */
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnEnemyDied);
 
+/** Enemy removed from level delegate. Allows an owning spawner to reclaim the enemy instead of destroying it */
+DECLARE_DELEGATE_OneParam(FOnEnemyRemoved, ACombatEnemy*);
+
 /**
  *  An AI-controlled character with combat capabilities.
  *  Its bundled AI Controller runs logic through StateTree
@@ -34,7 +44,15 @@ class ACombatEnemy : public ACharacter, public ICombatAttacker, public ICombatDa
 
 	/** Life bar widget component */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Components", meta = (AllowPrivateAccess = "true"))
-	UWidgetComponent* LifeBar;
+	UCombatLifeBarComponent* LifeBar;
+
+	/** Hit reaction component */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Components", meta = (AllowPrivateAccess = "true"))
+	UCombatHitReactionComponent* HitReaction;
+
+	/** Hurtbox history component, used by the server to validate attacks with lag compensation */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Components", meta = (AllowPrivateAccess = "true"))
+	UCombatHurtboxHistoryComponent* HurtboxHistory;
 
 public:
 	
@@ -43,13 +61,20 @@ public:
 
 protected:
 
-	/** Max amount of HP the character will have on respawn */
-	UPROPERTY(EditAnywhere, Category="Damage")
-	float MaxHP = 3.0f;
+	/** Shared tuning data for this enemy. If not set, the default values are used, which match the pre-archetype BP_CombatEnemy tuning */
+	UPROPERTY(EditAnywhere, Category="Archetype")
+	UCombatEnemyArchetype* Archetype;
+
+	/** Index of our compiled archetype in the archetype registry */
+	int32 ArchetypeIndex = 0;
+
+	/** Archetype registry holding our compiled archetype */
+	UPROPERTY(Transient)
+	UCombatEnemyArchetypeSubsystem* ArchetypeRegistry;
 
 public:
 
-	/** Current amount of HP the character has */
+	/** Current amount of HP the character has. Server authoritative. Clients receive it quantized through the enemy state replicator */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Damage", meta = (ClampMin = 0, ClampMax = 100))
 	float CurrentHP = 0.0f;
 
@@ -59,41 +84,13 @@ protected:
 	UPROPERTY(EditAnywhere, Category="Damage")
 	FName PelvisBoneName;
 
-	/** Pointer to the life bar widget */
-	UPROPERTY(EditAnywhere, Category="Damage")
-	UCombatLifeBar* LifeBarWidget;
-
 	/** If true, the character is currently playing an attack animation */
 	bool bIsAttacking = false;
 
-	/** Distance ahead of the character that melee attack sphere collision traces will extend */
-	UPROPERTY(EditAnywhere, Category="Melee Attack|Trace", meta = (ClampMin = 0, ClampMax = 500, Units = "cm"))
-	float MeleeTraceDistance = 75.0f;
-
-	/** Radius of the sphere trace for melee attacks */
-	UPROPERTY(EditAnywhere, Category="Melee Attack|Trace", meta = (ClampMin = 0, ClampMax = 500, Units = "cm"))
-	float MeleeTraceRadius = 50.0f;
-
-	/** Amount of damage a melee attack will deal */
-	UPROPERTY(EditAnywhere, Category="Melee Attack|Damage", meta = (ClampMin = 0, ClampMax = 100))
-	float MeleeDamage = 1.0f;
-
-	/** Amount of knockback impulse a melee attack will apply */
-	UPROPERTY(EditAnywhere, Category="Melee Attack|Damage", meta = (ClampMin = 0, ClampMax = 1000, Units = "cm/s"))
-	float MeleeKnockbackImpulse = 150.0f;
-
-	/** Amount of upwards impulse a melee attack will apply */
-	UPROPERTY(EditAnywhere, Category="Melee Attack|Damage", meta = (ClampMin = 0, ClampMax = 1000, Units = "cm/s"))
-	float MeleeLaunchImpulse = 350.0f;
-
 	/** AnimMontage that will play for combo attacks */
 	UPROPERTY(EditAnywhere, Category="Melee Attack|Combo")
 	UAnimMontage* ComboAttackMontage;
 
-	/** Names of the AnimMontage sections that correspond to each stage of the combo attack */
-	UPROPERTY(EditAnywhere, Category="Melee Attack|Combo")
-	TArray<FName> ComboSectionNames;
-
 	/** Target number of attacks in the combo attack string we're playing */
 	int32 TargetComboCount = 0;
 
@@ -112,13 +109,12 @@ protected:
 	UPROPERTY(EditAnywhere, Category="Melee Attack|Charged")
 	FName ChargeAttackSection;
 
-	/** Minimum number of charge animation loops that will be played by the AI */
-	UPROPERTY(EditAnywhere, Category="Melee Attack|Charged", meta = (ClampMin = 1, ClampMax = 20))
-	int32 MinChargeLoops = 2;
+	/** Seed for this enemy's attack choices. 0 picks a random seed on BeginPlay */
+	UPROPERTY(EditAnywhere, Category="Melee Attack")
+	int32 AttackRandomSeed = 0;
 
-	/** Maximum number of charge animation loops that will be played by the AI */
-	UPROPERTY(EditAnywhere, Category="Melee Attack|Charged", meta = (ClampMin = 1, ClampMax = 20))
-	int32 MaxChargeLoops = 5;
+	/** Random stream driving this enemy's attack choices */
+	FRandomStream AttackRandom;
 
 	/** Target number of charge animation loops to play in this charged attack */
 	int32 TargetChargeLoops = 0;
@@ -126,13 +122,35 @@ protected:
 	/** Number of charge animation loop currently playing */
 	int32 CurrentChargeLoop = 0;
 
-	/** Time to wait before removing this character from the level after it dies */
+	/** Importance of this character's death ragdoll when the ragdoll budget is full */
+	UPROPERTY(EditAnywhere, Category="Death", meta = (ClampMin = 0, ClampMax = 10))
+	float RagdollSignificance = 1.0f;
+
+	/** Optional AnimMontage to play on death when the ragdoll budget is full. Should not auto blend out */
 	UPROPERTY(EditAnywhere, Category="Death")
-	float DeathRemovalTime = 5.0f;
+	UAnimMontage* DeathMontage;
 
 	/** Enemy death timer */
 	FTimerHandle DeathTimer;
 
+	/** Impulse of a lethal hit that arrived before the death state, applied once the ragdoll starts */
+	FVector PendingDeathImpulse = FVector::ZeroVector;
+
+	/** Location of the pending death impulse */
+	FVector PendingDeathImpulseLocation = FVector::ZeroVector;
+
+	/** Relative transform of the mesh at game start, so we can restore it after ragdolling */
+	FTransform MeshStartingTransform;
+
+	/** If true, this enemy is currently inactive and waiting in a spawner's pool */
+	bool bIsPooled = false;
+
+	/** Latest HP fraction received from the server */
+	float ReplicatedLifeFraction = 1.0f;
+
+	/** Latest state flags received from the server */
+	ECombatEnemyStateFlags ReplicatedFlags = ECombatEnemyStateFlags::None;
+
 	/** Attack montage ended delegate */
 	FOnMontageEnded OnAttackMontageEnded;
 
@@ -147,6 +165,9 @@ public:
 	UPROPERTY(BlueprintAssignable, Category="Events")
 	FOnEnemyDied OnEnemyDied;
 
+	/** Removed from level delegate. If bound, the enemy will be handed back instead of destroyed after dying */
+	FOnEnemyRemoved OnEnemyRemoved;
+
 public:
 
 	/** Performs an AI-initiated combo attack. Number of hits will be decided by this character */
@@ -158,6 +179,41 @@ public:
 	/** Called from a delegate when the attack montage ends */
 	void AttackMontageEnded(UAnimMontage* Montage, bool bInterrupted);
 
+	/** Tries to acquire an attack token on the target. Returns true if this enemy is allowed to attack */
+	bool AcquireAttackToken(AActor* Target);
+
+	/** Returns true if this enemy could acquire an attack token on the target right now */
+	bool CanAcquireAttackToken(AActor* Target) const;
+
+	/** Releases the attack token held by this enemy, if any */
+	void ReleaseAttackToken();
+
+public:
+
+	/** Hides this enemy and pauses its AI, physics and collision so it can wait in a pool */
+	void DeactivateForPool();
+
+	/** Restores this enemy to its initial state at the provided transform and restarts its AI */
+	void ActivateFromPool(const FTransform& SpawnTransform);
+
+	/** Returns true if this enemy is currently waiting in a pool */
+	bool IsPooled() const { return bIsPooled; }
+
+	/** Returns the archetype asset assigned to this enemy, if any */
+	const UCombatEnemyArchetype* GetArchetype() const { return Archetype; }
+
+	/** Returns the shared tuning data for this enemy */
+	const FCombatEnemyArchetypeData& GetArchetypeData() const;
+
+	/** Returns the current HP as a fraction of max HP */
+	float GetLifeFraction() const;
+
+	/** Returns the state flags replicated to clients */
+	ECombatEnemyStateFlags GetStateFlags() const;
+
+	/** Applies HP and state flags received from the server. Deferred until BeginPlay if needed */
+	void ApplyReplicatedState(float LifeFraction, ECombatEnemyStateFlags Flags);
+
 public:
 
 	// ~begin ICombatAttacker interface
@@ -193,14 +249,37 @@ protected:
 	/** Removes this character from the level after it dies */
 	void RemoveFromLevel();
 
+	/** Resets the mesh from any ragdoll or frozen state and reattaches it to the capsule */
+	void ResetMesh();
+
+	/** Plays an attack montage, optionally jumping to a section */
+	void PlayAttackMontage(UAnimMontage* Montage, FName Section);
+
+	/** Plays an attack montage section on clients */
+	UFUNCTION(NetMulticast, Unreliable)
+	void MulticastAttackMontage(UAnimMontage* Montage, FName Section);
+
+	/** Interrupts attacks and plays damage reaction effects on every machine. bLethal comes from the server, since clients may not have received the death state yet */
+	UFUNCTION(NetMulticast, Unreliable)
+	void MulticastDamageEffects(float Damage, FVector_NetQuantize DamageLocation, FVector_NetQuantize10 DamageImpulse, bool bLethal);
+
+	/** Sends our latest state to the enemy state replicator. Only does anything on the server */
+	void UpdateReplicatedState();
+
+	/** Updates the life bar and handles death and pool reactivation from the latest replicated state */
+	void RefreshReplicatedState();
+
 public:
 
 	/** Overrides the default TakeDamage functionality */
 	virtual float TakeDamage(float Damage, struct FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser) override;
 
-	/** Overrides landing to reset damage ragdoll physics */
+	/** Overrides landing to reset physical hit reactions */
 	virtual void Landed(const FHitResult& Hit) override;
 
+	/** Notifies the StateTree when we become grounded or airborne */
+	virtual void OnMovementModeChanged(EMovementMode PrevMovementMode, uint8 PreviousCustomMode = 0) override;
+
 protected:
 
 	/** Blueprint handler to play damage received effects */
@@ -0,0 +1,22 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatEnemyArchetype.h"
+
+void UCombatEnemyArchetype::Compile(FCombatEnemyArchetypeData& OutData) const
+{
+	OutData.MeleeTraceDistance = MeleeTraceDistance;
+	OutData.MeleeTraceRadius = MeleeTraceRadius;
+	OutData.MeleeDamage = MeleeDamage;
+	OutData.MeleeKnockbackImpulse = MeleeKnockbackImpulse;
+	OutData.MeleeLaunchImpulse = MeleeLaunchImpulse;
+	OutData.MaxHP = MaxHP;
+
+	// keep the charge loop range valid even if the asset was misconfigured
+	OutData.MinChargeLoops = FMath::Min(MinChargeLoops, MaxChargeLoops);
+	OutData.MaxChargeLoops = FMath::Max(MinChargeLoops, MaxChargeLoops);
+
+	OutData.AttackTokenCost = AttackTokenCost;
+	OutData.DeathRemovalTime = DeathRemovalTime;
+	OutData.ComboSectionNames = ComboSectionNames;
+}
@@ -0,0 +1,109 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "CombatEnemyArchetype.generated.h"
+
+/**
+ *  Compiled, read-only tuning values shared by every enemy of an archetype.
+ *  Values read on the attack path are packed together at the front.
+ */
+struct FCombatEnemyArchetypeData
+{
+	/** Distance ahead of the character that melee attack sphere collision traces will extend */
+	float MeleeTraceDistance = 75.0f;
+
+	/** Radius of the sphere trace for melee attacks */
+	float MeleeTraceRadius = 50.0f;
+
+	/** Amount of damage a melee attack will deal */
+	float MeleeDamage = 1.0f;
+
+	/** Amount of knockback impulse a melee attack will apply */
+	float MeleeKnockbackImpulse = 150.0f;
+
+	/** Amount of upwards impulse a melee attack will apply */
+	float MeleeLaunchImpulse = 350.0f;
+
+	/** Max amount of HP the character will have on respawn */
+	float MaxHP = 3.0f;
+
+	/** Minimum number of charge animation loops that will be played by the AI */
+	int32 MinChargeLoops = 2;
+
+	/** Maximum number of charge animation loops that will be played by the AI */
+	int32 MaxChargeLoops = 5;
+
+	/** Number of the target's attack slots the enemy takes up while attacking */
+	int32 AttackTokenCost = 1;
+
+	/** Time to wait before removing the character from the level after it dies */
+	float DeathRemovalTime = 5.0f;
+
+	/** Names of the AnimMontage sections that correspond to each stage of the combo attack */
+	TArray<FName> ComboSectionNames;
+};
+
+/**
+ *  Tuning data for a type of combat enemy.
+ *  Archetypes are compiled into shared FCombatEnemyArchetypeData entries by UCombatEnemyArchetypeSubsystem,
+ *  so rebalancing an archetype affects every enemy using it without touching placed instances.
+ */
+UCLASS(BlueprintType)
+class UCombatEnemyArchetype : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Max amount of HP the character will have on respawn */
+	UPROPERTY(EditAnywhere, Category="Damage")
+	float MaxHP = 3.0f;
+
+	/** Distance ahead of the character that melee attack sphere collision traces will extend */
+	UPROPERTY(EditAnywhere, Category="Melee Attack|Trace", meta = (ClampMin = 0, ClampMax = 500, Units = "cm"))
+	float MeleeTraceDistance = 75.0f;
+
+	/** Radius of the sphere trace for melee attacks */
+	UPROPERTY(EditAnywhere, Category="Melee Attack|Trace", meta = (ClampMin = 0, ClampMax = 500, Units = "cm"))
+	float MeleeTraceRadius = 50.0f;
+
+	/** Amount of damage a melee attack will deal */
+	UPROPERTY(EditAnywhere, Category="Melee Attack|Damage", meta = (ClampMin = 0, ClampMax = 100))
+	float MeleeDamage = 1.0f;
+
+	/** Amount of knockback impulse a melee attack will apply */
+	UPROPERTY(EditAnywhere, Category="Melee Attack|Damage", meta = (ClampMin = 0, ClampMax = 1000, Units = "cm/s"))
+	float MeleeKnockbackImpulse = 150.0f;
+
+	/** Amount of upwards impulse a melee attack will apply */
+	UPROPERTY(EditAnywhere, Category="Melee Attack|Damage", meta = (ClampMin = 0, ClampMax = 1000, Units = "cm/s"))
+	float MeleeLaunchImpulse = 350.0f;
+
+	/** Names of the AnimMontage sections that correspond to each stage of the combo attack */
+	UPROPERTY(EditAnywhere, Category="Melee Attack|Combo")
+	TArray<FName> ComboSectionNames;
+
+	/** Minimum number of charge animation loops that will be played by the AI */
+	UPROPERTY(EditAnywhere, Category="Melee Attack|Charged", meta = (ClampMin = 1, ClampMax = 20))
+	int32 MinChargeLoops = 2;
+
+	/** Maximum number of charge animation loops that will be played by the AI */
+	UPROPERTY(EditAnywhere, Category="Melee Attack|Charged", meta = (ClampMin = 1, ClampMax = 20))
+	int32 MaxChargeLoops = 5;
+
+	/** Number of the target's attack slots this enemy takes up while attacking. 0 lets it attack regardless of other attackers. Costs above the per-target slot count take up all the slots */
+	UPROPERTY(EditAnywhere, Category="Melee Attack|Tokens", meta = (ClampMin = 0, ClampMax = 10))
+	int32 AttackTokenCost = 1;
+
+	/** Time to wait before removing this character from the level after it dies */
+	UPROPERTY(EditAnywhere, Category="Death")
+	float DeathRemovalTime = 5.0f;
+
+public:
+
+	/** Compiles the archetype into its packed runtime form */
+	void Compile(FCombatEnemyArchetypeData& OutData) const;
+};
@@ -0,0 +1,80 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatEnemyArchetypeSubsystem.h"
+#include "UObject/UObjectGlobals.h"
+
+int32 UCombatEnemyArchetypeSubsystem::RegisterArchetype(const UCombatEnemyArchetype* Archetype)
+{
+	// enemies without an archetype use the defaults
+	if (!Archetype)
+	{
+		return 0;
+	}
+
+	// has this archetype been compiled already?
+	if (const int32* Index = ArchetypeIndices.Find(Archetype))
+	{
+		return *Index;
+	}
+
+	// compile it into a new entry
+	const int32 Index = Archetypes.AddDefaulted();
+	Archetype->Compile(Archetypes[Index]);
+
+	ArchetypeIndices.Add(Archetype, Index);
+
+	return Index;
+}
+
+const FCombatEnemyArchetypeData& UCombatEnemyArchetypeSubsystem::GetDefaultArchetype()
+{
+	// match the values BP_CombatEnemy used before archetypes existed, so enemies without one keep their combos
+	static const FCombatEnemyArchetypeData DefaultArchetype = []()
+	{
+		FCombatEnemyArchetypeData Data;
+		Data.ComboSectionNames = { FName("Melee01"), FName("Melee02"), FName("Melee03") };
+
+		return Data;
+	}();
+
+	return DefaultArchetype;
+}
+
+void UCombatEnemyArchetypeSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// reserve index 0 for the defaults
+	Archetypes.Add(GetDefaultArchetype());
+
+#if WITH_EDITOR
+	PropertyChangedHandle = FCoreUObjectDelegates::OnObjectPropertyChanged.AddUObject(this, &UCombatEnemyArchetypeSubsystem::OnObjectPropertyChanged);
+#endif // WITH_EDITOR
+}
+
+void UCombatEnemyArchetypeSubsystem::Deinitialize()
+{
+#if WITH_EDITOR
+	FCoreUObjectDelegates::OnObjectPropertyChanged.Remove(PropertyChangedHandle);
+#endif // WITH_EDITOR
+
+	Archetypes.Empty();
+	ArchetypeIndices.Empty();
+
+	Super::Deinitialize();
+}
+
+#if WITH_EDITOR
+void UCombatEnemyArchetypeSubsystem::OnObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& PropertyChangedEvent)
+{
+	// recompile the archetype in place so every enemy using it picks up the change
+	if (const UCombatEnemyArchetype* Archetype = Cast<UCombatEnemyArchetype>(Object))
+	{
+		if (const int32* Index = ArchetypeIndices.Find(Archetype))
+		{
+			Archetype->Compile(Archetypes[*Index]);
+		}
+	}
+}
+#endif // WITH_EDITOR
@@ -0,0 +1,60 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CombatEnemyArchetype.h"
+#include "CombatEnemyArchetypeSubsystem.generated.h"
+
+/**
+ *  Registry of compiled enemy archetypes.
+ *  Each archetype asset is compiled once into a packed FCombatEnemyArchetypeData entry, and enemies reference it by index.
+ *  Index 0 always holds the default values, for enemies without an archetype. These match the pre-archetype BP_CombatEnemy tuning.
+ */
+UCLASS()
+class UCombatEnemyArchetypeSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Compiled archetypes, indexed by archetype index */
+	TArray<FCombatEnemyArchetypeData> Archetypes;
+
+	/** Maps archetype assets to their compiled index */
+	TMap<TObjectKey<UCombatEnemyArchetype>, int32> ArchetypeIndices;
+
+public:
+
+	/** Compiles the archetype if needed and returns its index */
+	int32 RegisterArchetype(const UCombatEnemyArchetype* Archetype);
+
+	/** Returns the compiled archetype at the provided index, or the defaults if the index isn't valid */
+	const FCombatEnemyArchetypeData& GetArchetype(int32 Index) const { return Archetypes.IsValidIndex(Index) ? Archetypes[Index] : GetDefaultArchetype(); }
+
+	/** Returns the default archetype values */
+	static const FCombatEnemyArchetypeData& GetDefaultArchetype();
+
+public:
+
+	// ~begin UWorldSubsystem interface
+
+	/** Initialization */
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	/** Cleanup */
+	virtual void Deinitialize() override;
+
+	// ~end UWorldSubsystem interface
+
+protected:
+
+#if WITH_EDITOR
+	/** Recompiles archetypes edited while playing in the editor */
+	void OnObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& PropertyChangedEvent);
+
+	/** Property changed delegate handle */
+	FDelegateHandle PropertyChangedHandle;
+#endif // WITH_EDITOR
+};
@@ -5,13 +5,25 @@
 #include "Components/SceneComponent.h"
 #include "Components/CapsuleComponent.h"
 #include "Components/ArrowComponent.h"
+#include "Components/SphereComponent.h"
+#include "GameFramework/Pawn.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
 #include "TimerManager.h"
+#include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
 #include "CombatEnemy.h"
+#include "CombatWaveDirectorSubsystem.h"
+#include "CombatSimulation.h"
 
 ACombatEnemySpawner::ACombatEnemySpawner()
 {
 	PrimaryActorTick.bCanEverTick = false;
 
+	// replicate, but stay dormant until we're activated
+	bReplicates = true;
+	NetDormancy = DORM_Initial;
+
 	// create the root
 	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
 
@@ -25,17 +37,46 @@ ACombatEnemySpawner::ACombatEnemySpawner()
 
 	SpawnDirection = CreateDefaultSubobject<UArrowComponent>(TEXT("Spawn Direction"));
 	SpawnDirection->SetupAttachment(RootComponent);
+
+	// create the proximity sphere, only overlapping pawns
+	PreloadSphere = CreateDefaultSubobject<USphereComponent>(TEXT("Preload Sphere"));
+	PreloadSphere->SetupAttachment(RootComponent);
+
+	PreloadSphere->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+	PreloadSphere->SetCollisionResponseToAllChannels(ECR_Ignore);
+	PreloadSphere->SetCollisionResponseToChannel(ECC_Pawn, ECR_Overlap);
+
+	// bind the begin overlap
+	PreloadSphere->OnComponentBeginOverlap.AddDynamic(this, &ACombatEnemySpawner::OnPreloadOverlap);
+}
+
+void ACombatEnemySpawner::OnConstruction(const FTransform& Transform)
+{
+	Super::OnConstruction(Transform);
+
+	// size the proximity sphere, or disable it
+	PreloadSphere->SetSphereRadius(PreloadRadius);
+	PreloadSphere->SetCollisionEnabled(PreloadRadius > 0.0f ? ECollisionEnabled::QueryOnly : ECollisionEnabled::NoCollision);
 }
 
 void ACombatEnemySpawner::BeginPlay()
 {
 	Super::BeginPlay();
-	
+
+	// only the server spawns enemies. Clients receive them through replication
+	if (!HasAuthority())
+	{
+		return;
+	}
+
 	// should we spawn an enemy right away?
 	if (bShouldSpawnEnemiesImmediately)
 	{
+		// start loading the enemy class during the initial delay
+		LoadEnemyClass();
+
 		// schedule the first enemy spawn
-		GetWorld()->GetTimerManager().SetTimer(SpawnTimer, this, &ACombatEnemySpawner::SpawnEnemy, InitialSpawnDelay);
+		GetWorld()->GetTimerManager().SetTimer(SpawnTimer, this, &ACombatEnemySpawner::RequestSpawn, InitialSpawnDelay);
 	}
 
 }
@@ -46,30 +87,277 @@ void ACombatEnemySpawner::EndPlay(EEndPlayReason::Type EndPlayReason)
 
 	// clear the spawn timer
 	GetWorld()->GetTimerManager().ClearTimer(SpawnTimer);
+
+	// cancel any in-flight loads
+	if (EnemyClassLoadHandle.IsValid())
+	{
+		EnemyClassLoadHandle->CancelHandle();
+		EnemyClassLoadHandle.Reset();
+	}
+
+	// stop waiting on returning enemies, and destroy any enemies still waiting in the pool
+	bSpawnPendingReturn = false;
+
+	for (ACombatEnemy* PooledEnemy : EnemyPool)
+	{
+		if (IsValid(PooledEnemy))
+		{
+			PooledEnemy->Destroy();
+		}
+	}
+
+	EnemyPool.Empty();
+
+	// drop any spawns we still have queued
+	if (UCombatWaveDirectorSubsystem* WaveDirector = GetWorld()->GetSubsystem<UCombatWaveDirectorSubsystem>())
+	{
+		WaveDirector->CancelSpawns(this);
+	}
 }
 
-void ACombatEnemySpawner::SpawnEnemy()
+void ACombatEnemySpawner::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
-	// ensure the enemy class is valid
-	if (IsValid(EnemyClass))
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	// the activation flag only changes once, so only compare it when it's been marked dirty
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+
+	DOREPLIFETIME_WITH_PARAMS_FAST(ACombatEnemySpawner, bHasBeenActivated, Params);
+}
+
+void ACombatEnemySpawner::RequestSpawn()
+{
+	// only the server spawns enemies
+	if (!HasAuthority())
+	{
+		return;
+	}
+
+	// defer the spawn until the enemy class is loaded
+	if (!LoadedEnemyClass)
+	{
+		bSpawnPendingLoad = true;
+		LoadEnemyClass();
+		return;
+	}
+
+	// wait for a dead enemy to come back to the pool instead of creating a new one
+	if (IsEnemyReturning())
+	{
+		bSpawnPendingReturn = true;
+		return;
+	}
+
+	// let the wave director decide when to spawn
+	if (UCombatWaveDirectorSubsystem* WaveDirector = GetWorld()->GetSubsystem<UCombatWaveDirectorSubsystem>())
 	{
-		// spawn the enemy at the reference capsule's transform
-		FActorSpawnParameters SpawnParams;
-		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+		WaveDirector->RequestSpawn(this, SpawnCost);
+		return;
+	}
 
-		ACombatEnemy* SpawnedEnemy = GetWorld()->SpawnActor<ACombatEnemy>(EnemyClass, SpawnCapsule->GetComponentTransform(), SpawnParams);
+	// no director, so spawn right away
+	SpawnEnemy();
+}
 
-		// was the enemy successfully created?
-		if (SpawnedEnemy)
+ACombatEnemy* ACombatEnemySpawner::SpawnEnemy()
+{
+	// reuse a pooled enemy if we have one, otherwise create a new one
+	ACombatEnemy* SpawnedEnemy = nullptr;
+
+	while (!SpawnedEnemy && EnemyPool.Num() > 0)
+	{
+		SpawnedEnemy = EnemyPool.Pop(EAllowShrinking::No);
+
+		// skip any enemies destroyed while pooled
+		if (!IsValid(SpawnedEnemy))
 		{
-			// subscribe to the death delegate
-			SpawnedEnemy->OnEnemyDied.AddDynamic(this, &ACombatEnemySpawner::OnEnemyDied);
+			SpawnedEnemy = nullptr;
 		}
 	}
+
+	if (!SpawnedEnemy)
+	{
+		SpawnedEnemy = CreatePooledEnemy();
+	}
+
+	// was the enemy successfully created?
+	if (SpawnedEnemy)
+	{
+		// bring the enemy back at the reference capsule's transform
+		SpawnedEnemy->ActivateFromPool(SpawnCapsule->GetComponentTransform());
+	}
+
+	return SpawnedEnemy;
+}
+
+void ACombatEnemySpawner::LoadEnemyClass()
+{
+	// clients never spawn enemies, so they don't need the class. Skip if we're already loaded or loading
+	if (!HasAuthority() || LoadedEnemyClass || EnemyClassLoadHandle.IsValid() || EnemyClass.IsNull())
+	{
+		return;
+	}
+
+	// request the enemy class asynchronously
+	EnemyClassLoadHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(EnemyClass.ToSoftObjectPath(), FStreamableDelegate::CreateUObject(this, &ACombatEnemySpawner::OnEnemyClassLoaded));
+
+	// no request is made for an invalid path, so resolve the spawn right away instead of waiting forever
+	if (!EnemyClassLoadHandle.IsValid())
+	{
+		OnEnemyClassLoaded();
+	}
+}
+
+void ACombatEnemySpawner::OnEnemyClassLoaded()
+{
+	// hold on to the loaded class
+	LoadedEnemyClass = EnemyClass.Get();
+	EnemyClassLoadHandle.Reset();
+
+	// ensure the class loaded successfully
+	if (!LoadedEnemyClass)
+	{
+		return;
+	}
+
+	// create the pooled enemies now that we can
+	PrewarmPool();
+
+	// spawn any enemy that was waiting on the load
+	if (bSpawnPendingLoad)
+	{
+		bSpawnPendingLoad = false;
+		RequestSpawn();
+	}
+}
+
+void ACombatEnemySpawner::OnPreloadOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+{
+	// only the server preloads, since it's the only one spawning enemies
+	if (!HasAuthority())
+	{
+		return;
+	}
+
+	// start loading when the player gets close
+	const APawn* Pawn = Cast<APawn>(OtherActor);
+
+	if (Pawn && Pawn->IsPlayerControlled())
+	{
+		LoadEnemyClass();
+	}
+}
+
+void ACombatEnemySpawner::PrewarmPool()
+{
+	// only the server keeps an enemy pool
+	if (!HasAuthority())
+	{
+		return;
+	}
+
+	// don't create more enemies than we'll ever spawn
+	const int32 TargetPoolSize = FMath::Min(PoolSize, SpawnCount);
+
+	for (int32 i = EnemyPool.Num(); i < TargetPoolSize; ++i)
+	{
+		if (ACombatEnemy* PooledEnemy = CreatePooledEnemy())
+		{
+			EnemyPool.Add(PooledEnemy);
+		}
+	}
+}
+
+ACombatEnemy* ACombatEnemySpawner::CreatePooledEnemy()
+{
+	// ensure we're the server and the enemy class is loaded
+	if (!HasAuthority() || !IsValid(LoadedEnemyClass))
+	{
+		return nullptr;
+	}
+
+	// spawn the enemy at the reference capsule's transform
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	ACombatEnemy* NewEnemy = GetWorld()->SpawnActor<ACombatEnemy>(LoadedEnemyClass, SpawnCapsule->GetComponentTransform(), SpawnParams);
+
+	// was the enemy successfully created?
+	if (NewEnemy)
+	{
+		CreatedEnemies.Add(NewEnemy);
+
+		// subscribe to the death and destruction delegates
+		NewEnemy->OnEnemyDied.AddUniqueDynamic(this, &ACombatEnemySpawner::OnEnemyDied);
+		NewEnemy->OnDestroyed.AddUniqueDynamic(this, &ACombatEnemySpawner::OnEnemyDestroyed);
+
+		// reclaim the enemy after it dies instead of letting it destroy itself
+		NewEnemy->OnEnemyRemoved.BindUObject(this, &ACombatEnemySpawner::ReturnEnemyToPool);
+
+		// keep it inactive until it's needed
+		NewEnemy->DeactivateForPool();
+	}
+
+	return NewEnemy;
+}
+
+void ACombatEnemySpawner::ReturnEnemyToPool(ACombatEnemy* Enemy)
+{
+	// if we won't spawn any more enemies, there's no need to keep it around
+	if (SpawnCount <= EnemyPool.Num())
+	{
+		Enemy->Destroy();
+		return;
+	}
+
+	// deactivate the enemy and keep it for the next spawn
+	Enemy->DeactivateForPool();
+	EnemyPool.Add(Enemy);
+
+	// reuse it right away if a spawn was waiting on it
+	if (bSpawnPendingReturn)
+	{
+		bSpawnPendingReturn = false;
+		RequestSpawn();
+	}
+}
+
+bool ACombatEnemySpawner::IsEnemyReturning(const AActor* IgnoreEnemy) const
+{
+	// a pooled enemy is ready to go
+	if (EnemyPool.ContainsByPredicate([](const ACombatEnemy* PooledEnemy) { return IsValid(PooledEnemy); }))
+	{
+		return false;
+	}
+
+	// look for a dead enemy that hasn't been removed from the level yet
+	return CreatedEnemies.ContainsByPredicate([IgnoreEnemy](const TWeakObjectPtr<ACombatEnemy>& Enemy)
+	{
+		return Enemy.IsValid() && Enemy.Get() != IgnoreEnemy && !Enemy->IsPooled() && FCombatRules::IsDead(Enemy->CurrentHP);
+	});
+}
+
+void ACombatEnemySpawner::OnEnemyDestroyed(AActor* DestroyedActor)
+{
+	CreatedEnemies.RemoveAllSwap([DestroyedActor](const TWeakObjectPtr<ACombatEnemy>& Enemy) { return !Enemy.IsValid() || Enemy.Get() == DestroyedActor; }, EAllowShrinking::No);
+
+	// the enemy we were waiting on won't come back, so create a new one instead
+	if (bSpawnPendingReturn && !IsEnemyReturning(DestroyedActor))
+	{
+		bSpawnPendingReturn = false;
+		RequestSpawn();
+	}
 }
 
 void ACombatEnemySpawner::OnEnemyDied()
 {
+	// free up the enemy's slot in the wave director
+	if (UCombatWaveDirectorSubsystem* WaveDirector = GetWorld()->GetSubsystem<UCombatWaveDirectorSubsystem>())
+	{
+		WaveDirector->NotifyEnemyDied();
+	}
+
 	// decrease the spawn counter
 	--SpawnCount;
 
@@ -82,7 +370,7 @@ void ACombatEnemySpawner::OnEnemyDied()
 	}
 
 	// schedule the next enemy spawn
-	GetWorld()->GetTimerManager().SetTimer(SpawnTimer, this, &ACombatEnemySpawner::SpawnEnemy, RespawnDelay);
+	GetWorld()->GetTimerManager().SetTimer(SpawnTimer, this, &ACombatEnemySpawner::RequestSpawn, RespawnDelay);
 }
 
 void ACombatEnemySpawner::SpawnerDepleted()
@@ -106,20 +394,36 @@ void ACombatEnemySpawner::ToggleInteraction(AActor* ActivationInstigator)
 
 void ACombatEnemySpawner::ActivateInteraction(AActor* ActivationInstigator)
 {
-	// ensure we're only activated once, and only if we've deferred enemy spawning
-	if (bHasBeenActivated || bShouldSpawnEnemiesImmediately)
+	// ensure we're only activated once on the server, and only if we've deferred enemy spawning
+	if (!HasAuthority() || bHasBeenActivated || bShouldSpawnEnemiesImmediately)
 	{
 		return;
 	}
 
 	// raise the activation flag
 	bHasBeenActivated = true;
+	MARK_PROPERTY_DIRTY_FROM_NAME(ACombatEnemySpawner, bHasBeenActivated, this);
+
+	// wake up just long enough to send the new state
+	FlushNetDormancy();
 
 	// spawn the first enemy
-	SpawnEnemy();
+	RequestSpawn();
 }
 
 void ACombatEnemySpawner::DeactivateInteraction(AActor* ActivationInstigator)
 {
 	// stub
 }
+
+void ACombatEnemySpawner::PrepareInteraction(AActor* ActivationInstigator)
+{
+	// only the server spawns enemies, so there's nothing to prepare on clients
+	if (!HasAuthority())
+	{
+		return;
+	}
+
+	// start loading the enemy class so it's ready when we're activated
+	LoadEnemyClass();
+}
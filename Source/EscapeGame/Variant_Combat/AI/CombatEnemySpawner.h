@@ -9,13 +9,19 @@
 
 class UCapsuleComponent;
 class UArrowComponent;
+class USphereComponent;
 class ACombatEnemy;
+struct FStreamableHandle;
 
 /**
  *  A basic Actor in charge of spawning Enemy Characters and monitoring their deaths.
  *  Enemies will be spawned one by one, and the spawner will wait until the enemy dies before spawning a new one.
+ *  Spawns are queued with the wave director, which spreads them across frames and caps the number of live enemies.
+ *  Enemies are prewarmed into a pool of hidden, inactive characters and recycled after they die.
+ *  The enemy class is soft referenced and streamed in asynchronously when the player gets close or the spawner is about to be activated
  *  The spawner can be remotely activated through the ICombatActivatable interface
  *  When the last spawned enemy dies, the spawner can also activate other ICombatActivatables
+ *  The spawner is net dormant, and only wakes to replicate its activation state
  */
 UCLASS(abstract)
 class ACombatEnemySpawner : public AActor, public ICombatActivatable
@@ -28,11 +34,33 @@ class ACombatEnemySpawner : public AActor, public ICombatActivatable
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components", meta = (AllowPrivateAccess = "true"))
 	UArrowComponent* SpawnDirection;
 
+	/** Proximity sphere. The enemy class will start loading when the player enters it */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components", meta = (AllowPrivateAccess = "true"))
+	USphereComponent* PreloadSphere;
+
 protected:
 
-	/** Type of enemy to spawn */
+	/** Type of enemy to spawn. Soft referenced so the enemy's assets don't load with the map */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Enemy Spawner")
-	TSubclassOf<ACombatEnemy> EnemyClass;
+	TSoftClassPtr<ACombatEnemy> EnemyClass;
+
+	/** Loaded enemy class. Keeps the enemy's assets resident while this spawner is in use */
+	UPROPERTY(Transient)
+	TSubclassOf<ACombatEnemy> LoadedEnemyClass;
+
+	/** Radius around the spawner at which the enemy class will start loading. Zero disables proximity loading */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Enemy Spawner", meta = (ClampMin = 0, ClampMax = 10000, Units = "cm"))
+	float PreloadRadius = 2500.0f;
+
+	/** Cost of spawning one of this spawner's enemies, against the wave director's per-frame budget */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Enemy Spawner", meta = (ClampMin = 0, ClampMax = 10))
+	float SpawnCost = 1.0f;
+
+	/** Handle to the in-flight enemy class streaming request */
+	TSharedPtr<FStreamableHandle> EnemyClassLoadHandle;
+
+	/** If true, an enemy spawn was requested while the enemy class was still loading */
+	bool bSpawnPendingLoad = false;
 
 	/** If true, the first enemy will be spawned as soon as the game starts */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Enemy Spawner")
@@ -46,10 +74,24 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Enemy Spawner", meta = (ClampMin = 0, ClampMax = 100))
 	int32 SpawnCount = 1;
 
-	/** Time to wait before spawning the next enemy after the current one dies */
+	/** Time to wait before spawning the next enemy after the current one dies. If the pool is empty, the spawn also waits for the dead enemy to return to it */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Enemy Spawner", meta = (ClampMin = 0, ClampMax = 10))
 	float RespawnDelay = 5.0f;
 
+	/** Number of enemies to create and deactivate on BeginPlay, so spawning doesn't hitch mid-wave. Capped by SpawnCount */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Enemy Spawner", meta = (ClampMin = 0, ClampMax = 10))
+	int32 PoolSize = 1;
+
+	/** Inactive enemies waiting to be spawned */
+	UPROPERTY(Transient)
+	TArray<ACombatEnemy*> EnemyPool;
+
+	/** Every enemy this spawner has created, so we can tell when a dead one is on its way back to the pool */
+	TArray<TWeakObjectPtr<ACombatEnemy>> CreatedEnemies;
+
+	/** If true, an enemy spawn is waiting for a dead enemy to return to the pool */
+	bool bSpawnPendingReturn = false;
+
 	/** Time to wait after this spawner is depleted before activating the actor list */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Activation", meta = (ClampMin = 0, ClampMax = 10))
 	float ActivationDelay = 1.0f;
@@ -59,6 +101,7 @@ protected:
 	TArray<AActor*> ActorsToActivateWhenDepleted;
 
 	/** Flag to ensure this is only activated once */
+	UPROPERTY(Replicated)
 	bool bHasBeenActivated = false;
 
 	/** Timer to spawn enemies after a delay */
@@ -69,6 +112,9 @@ public:
 	/** Constructor */
 	ACombatEnemySpawner();
 
+	/** Sizes the proximity sphere */
+	virtual void OnConstruction(const FTransform& Transform) override;
+
 public:
 
 	/** Initialization */
@@ -77,10 +123,39 @@ public:
 	/** Cleanup */
 	virtual void EndPlay(EEndPlayReason::Type EndPlayReason) override;
 
+	/** Sets up replicated properties */
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
 protected:
 
-	/** Spawn an enemy and subscribe to its death event */
-	void SpawnEnemy();
+	/** Queues an enemy spawn with the wave director. Deferred until the enemy class finishes loading */
+	void RequestSpawn();
+
+	/** Starts streaming in the enemy class, if it's not loaded or loading already */
+	void LoadEnemyClass();
+
+	/** Called when the enemy class has finished loading */
+	void OnEnemyClassLoaded();
+
+	/** Handles overlaps with the proximity sphere */
+	UFUNCTION()
+	void OnPreloadOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
+
+	/** Creates the pooled enemies */
+	void PrewarmPool();
+
+	/** Creates a new inactive enemy and subscribes to its events */
+	ACombatEnemy* CreatePooledEnemy();
+
+	/** Called when a dead enemy is removed from the level, so we can return it to the pool */
+	void ReturnEnemyToPool(ACombatEnemy* Enemy);
+
+	/** Returns true if the pool is empty but a dead enemy will return to it. Optionally ignores an enemy that's being destroyed */
+	bool IsEnemyReturning(const AActor* IgnoreEnemy = nullptr) const;
+
+	/** Called when one of our enemies is destroyed, so a spawn waiting on it can go ahead */
+	UFUNCTION()
+	void OnEnemyDestroyed(AActor* DestroyedActor);
 
 	/** Called when the spawned enemy has died */
 	UFUNCTION()
@@ -89,6 +164,11 @@ protected:
 	/** Called after the last spawned enemy has died */
 	void SpawnerDepleted();
 
+public:
+
+	/** Spawns an enemy right away. Called by the wave director when it processes our request. Returns the spawned enemy, if any */
+	ACombatEnemy* SpawnEnemy();
+
 public:
 
 	// ~begin ICombatActivatable interface
@@ -105,5 +185,8 @@ public:
 	UFUNCTION(BlueprintCallable, Category="Activatable")
 	virtual void DeactivateInteraction(AActor* ActivationInstigator) override;
 
+	/** Starts loading the enemy class ahead of activation */
+	virtual void PrepareInteraction(AActor* ActivationInstigator) override;
+
 	// ~end IActivatable interface
 };
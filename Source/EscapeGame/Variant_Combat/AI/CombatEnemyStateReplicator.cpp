@@ -0,0 +1,118 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatEnemyStateReplicator.h"
+#include "CombatEnemy.h"
+#include "Net/UnrealNetwork.h"
+
+uint8 FCombatEnemyStateItem::QuantizeLifeFraction(float LifeFraction)
+{
+	return static_cast<uint8>(FMath::Clamp(FMath::CeilToInt32(LifeFraction * 255.0f), 0, 255));
+}
+
+void FCombatEnemyStateItem::PostReplicatedAdd(const FCombatEnemyStateArray& InArraySerializer)
+{
+	ApplyToEnemy();
+}
+
+void FCombatEnemyStateItem::PostReplicatedChange(const FCombatEnemyStateArray& InArraySerializer)
+{
+	ApplyToEnemy();
+}
+
+void FCombatEnemyStateItem::ApplyToEnemy() const
+{
+	// the enemy may not have been replicated yet. We'll get another change callback once it's mapped
+	if (IsValid(Enemy))
+	{
+		Enemy->ApplyReplicatedState(GetLifeFraction(), static_cast<ECombatEnemyStateFlags>(Flags));
+	}
+}
+
+ACombatEnemyStateReplicator::ACombatEnemyStateReplicator()
+{
+	// every client needs every enemy's state, and changes are pushed with a forced update
+	bReplicates = true;
+	bAlwaysRelevant = true;
+	SetNetUpdateFrequency(10.0f);
+}
+
+void ACombatEnemyStateReplicator::AddEnemy(ACombatEnemy* Enemy)
+{
+	// ignore repeated registrations
+	if (!IsValid(Enemy) || ItemIndices.Contains(Enemy))
+	{
+		return;
+	}
+
+	FCombatEnemyStateItem& Item = EnemyStates.Items.AddDefaulted_GetRef();
+	Item.Enemy = Enemy;
+	CopyState(Enemy, Item);
+
+	ItemIndices.Add(Enemy, EnemyStates.Items.Num() - 1);
+
+	EnemyStates.MarkItemDirty(Item);
+	ForceNetUpdate();
+}
+
+void ACombatEnemyStateReplicator::RemoveEnemy(const ACombatEnemy* Enemy)
+{
+	int32 ItemIndex;
+
+	if (!ItemIndices.RemoveAndCopyValue(Enemy, ItemIndex))
+	{
+		return;
+	}
+
+	// swap the last item into the removed slot and fix up its index
+	EnemyStates.Items.RemoveAtSwap(ItemIndex, EAllowShrinking::No);
+
+	if (EnemyStates.Items.IsValidIndex(ItemIndex))
+	{
+		ItemIndices.Add(EnemyStates.Items[ItemIndex].Enemy, ItemIndex);
+	}
+
+	EnemyStates.MarkArrayDirty();
+}
+
+void ACombatEnemyStateReplicator::UpdateEnemy(const ACombatEnemy* Enemy)
+{
+	const int32* ItemIndex = ItemIndices.Find(Enemy);
+
+	if (!ItemIndex)
+	{
+		return;
+	}
+
+	// only send items whose replicated values changed
+	FCombatEnemyStateItem& Item = EnemyStates.Items[*ItemIndex];
+
+	if (CopyState(Enemy, Item))
+	{
+		EnemyStates.MarkItemDirty(Item);
+		ForceNetUpdate();
+	}
+}
+
+bool ACombatEnemyStateReplicator::CopyState(const ACombatEnemy* Enemy, FCombatEnemyStateItem& Item)
+{
+	const uint8 QuantizedHP = FCombatEnemyStateItem::QuantizeLifeFraction(Enemy->GetLifeFraction());
+	const uint8 Flags = static_cast<uint8>(Enemy->GetStateFlags());
+
+	if (Item.QuantizedHP == QuantizedHP && Item.Flags == Flags)
+	{
+		return false;
+	}
+
+	Item.QuantizedHP = QuantizedHP;
+	Item.Flags = Flags;
+
+	return true;
+}
+
+void ACombatEnemyStateReplicator::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(ACombatEnemyStateReplicator, EnemyStates);
+}
@@ -0,0 +1,129 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+#include "Net/Serialization/FastArraySerializer.h"
+#include "CombatEnemyStateReplicator.generated.h"
+
+class ACombatEnemy;
+class ACombatEnemyStateReplicator;
+struct FCombatEnemyStateArray;
+
+/** Replicated enemy state flags */
+enum class ECombatEnemyStateFlags : uint8
+{
+	None = 0,
+	Dead = 1 << 0,
+	Attacking = 1 << 1
+};
+ENUM_CLASS_FLAGS(ECombatEnemyStateFlags);
+
+/**
+ *  Replicated state of a single enemy.
+ *  The enemy reference doubles as its id, and is sent as the enemy's network GUID
+ */
+USTRUCT()
+struct FCombatEnemyStateItem : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+	/** Enemy this state belongs to */
+	UPROPERTY()
+	ACombatEnemy* Enemy = nullptr;
+
+	/** Current HP as a fraction of max HP, quantized to a byte. Only zero when dead */
+	UPROPERTY()
+	uint8 QuantizedHP = 0;
+
+	/** Packed ECombatEnemyStateFlags */
+	UPROPERTY()
+	uint8 Flags = 0;
+
+	/** Returns the HP fraction */
+	float GetLifeFraction() const { return QuantizedHP / 255.0f; }
+
+	/** Quantizes an HP fraction. Any HP left rounds up so clients never see a live enemy at zero */
+	static uint8 QuantizeLifeFraction(float LifeFraction);
+
+	/** Pushes the initial state to the enemy on clients */
+	void PostReplicatedAdd(const FCombatEnemyStateArray& InArraySerializer);
+
+	/** Pushes the changed state to the enemy on clients */
+	void PostReplicatedChange(const FCombatEnemyStateArray& InArraySerializer);
+
+	/** Pushes the state to the enemy, if it's been mapped on this client */
+	void ApplyToEnemy() const;
+};
+
+/** Fast array of enemy states. Only items that changed are sent */
+USTRUCT()
+struct FCombatEnemyStateArray : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	/** One item per registered enemy */
+	UPROPERTY()
+	TArray<FCombatEnemyStateItem> Items;
+
+	/** Delta serializes the changed items */
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FCombatEnemyStateItem, FCombatEnemyStateArray>(Items, DeltaParms, *this);
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FCombatEnemyStateArray> : public TStructOpsTypeTraitsBase2<FCombatEnemyStateArray>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
+
+/**
+ *  Always relevant actor that replicates the HP and state flags of every combat enemy in a single fast array.
+ *  Enemies keep replicating their movement, but this avoids per-actor property replication costs for their combat state,
+ *  so large waves only pay for the enemies that actually changed.
+ *  Spawned on the server by UCombatEnemyStateSubsystem.
+ */
+UCLASS(NotPlaceable, Transient)
+class ACombatEnemyStateReplicator : public AInfo
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Replicated enemy states */
+	UPROPERTY(Replicated)
+	FCombatEnemyStateArray EnemyStates;
+
+	/** Maps registered enemies to their item index. Server only */
+	TMap<const ACombatEnemy*, int32> ItemIndices;
+
+public:
+
+	/** Constructor */
+	ACombatEnemyStateReplicator();
+
+	/** Adds an enemy's state to the array */
+	void AddEnemy(ACombatEnemy* Enemy);
+
+	/** Removes an enemy's state from the array */
+	void RemoveEnemy(const ACombatEnemy* Enemy);
+
+	/** Copies an enemy's latest state into its item, marking it dirty only if the replicated values changed */
+	void UpdateEnemy(const ACombatEnemy* Enemy);
+
+protected:
+
+	/** Copies an enemy's state into an item. Returns true if anything changed */
+	static bool CopyState(const ACombatEnemy* Enemy, FCombatEnemyStateItem& Item);
+
+public:
+
+	/** Sets up replicated properties */
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+};
@@ -0,0 +1,53 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatEnemyStateSubsystem.h"
+#include "CombatEnemyStateReplicator.h"
+#include "Engine/World.h"
+
+void UCombatEnemyStateSubsystem::RegisterEnemy(ACombatEnemy* Enemy)
+{
+	if (Replicator)
+	{
+		Replicator->AddEnemy(Enemy);
+	}
+}
+
+void UCombatEnemyStateSubsystem::UnregisterEnemy(const ACombatEnemy* Enemy)
+{
+	if (Replicator)
+	{
+		Replicator->RemoveEnemy(Enemy);
+	}
+}
+
+void UCombatEnemyStateSubsystem::UpdateEnemy(const ACombatEnemy* Enemy)
+{
+	if (Replicator)
+	{
+		Replicator->UpdateEnemy(Enemy);
+	}
+}
+
+void UCombatEnemyStateSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// only the server spawns the replicator. Clients get it through replication
+	if (!InWorld.IsGameWorld() || InWorld.GetNetMode() == NM_Client)
+	{
+		return;
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.ObjectFlags |= RF_Transient;
+
+	Replicator = InWorld.SpawnActor<ACombatEnemyStateReplicator>(SpawnParams);
+}
+
+void UCombatEnemyStateSubsystem::Deinitialize()
+{
+	Replicator = nullptr;
+
+	Super::Deinitialize();
+}
@@ -0,0 +1,49 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CombatEnemyStateSubsystem.generated.h"
+
+class ACombatEnemy;
+class ACombatEnemyStateReplicator;
+
+/**
+ *  Owns the server's ACombatEnemyStateReplicator and routes enemy state changes to it.
+ *  Clients don't use this. They receive enemy state through the replicator's fast array callbacks.
+ */
+UCLASS()
+class UCombatEnemyStateSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Replicator spawned for this world. Server only */
+	UPROPERTY(Transient)
+	ACombatEnemyStateReplicator* Replicator;
+
+public:
+
+	/** Starts replicating an enemy's state */
+	void RegisterEnemy(ACombatEnemy* Enemy);
+
+	/** Stops replicating an enemy's state */
+	void UnregisterEnemy(const ACombatEnemy* Enemy);
+
+	/** Sends an enemy's latest state, if any of its replicated values changed */
+	void UpdateEnemy(const ACombatEnemy* Enemy);
+
+public:
+
+	// ~begin UWorldSubsystem interface
+
+	/** Spawns the replicator on the server before any enemies begin play */
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	/** Cleanup */
+	virtual void Deinitialize() override;
+
+	// ~end UWorldSubsystem interface
+};
@@ -0,0 +1,246 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatEnvQuerySubsystem.h"
+#include "EnvironmentQuery/EnvQuery.h"
+#include "EnvironmentQuery/EnvQueryManager.h"
+#include "GameFramework/Actor.h"
+#include "GameFramework/Pawn.h"
+#include "Kismet/GameplayStatics.h"
+#include "AIPlayerInfoSubsystem.h"
+
+TSharedPtr<FEnvQueryResult> UCombatEnvQuerySubsystem::RequestQuery(UEnvQuery* Template, UObject* Querier, EEnvQueryRunMode::Type RunMode, const FOnSharedEnvQueryFinished& OnFinished, int32& OutRequestID)
+{
+	OutRequestID = INDEX_NONE;
+
+	// ensure we have something to run
+	if (!Template || !IsValid(Querier))
+	{
+		return nullptr;
+	}
+
+	const FCombatEnvQueryKey Key = MakeKey(Template, Querier, RunMode);
+
+	// do we have a fresh result we can share?
+	if (const FCombatEnvQueryCacheEntry* Entry = Cache.Find(Key))
+	{
+		if (GetWorld()->GetTimeSeconds() - Entry->Time <= ResultTimeToLive)
+		{
+			return Entry->Result;
+		}
+
+		Cache.Remove(Key);
+	}
+
+	// join the matching query, or queue a new one
+	FCombatEnvQueryPending* PendingQuery = Pending.Find(Key);
+
+	if (!PendingQuery)
+	{
+		PendingQuery = &Pending.Add(Key);
+		StartQueue.Add(Key);
+	}
+
+	FCombatEnvQueryWaiter& Waiter = PendingQuery->Waiters.AddDefaulted_GetRef();
+	Waiter.RequestID = OutRequestID = ++LastRequestID;
+	Waiter.Querier = Querier;
+	Waiter.OnFinished = OnFinished;
+
+	return nullptr;
+}
+
+void UCombatEnvQuerySubsystem::CancelQuery(int32 RequestID)
+{
+	if (RequestID == INDEX_NONE)
+	{
+		return;
+	}
+
+	for (auto It = Pending.CreateIterator(); It; ++It)
+	{
+		FCombatEnvQueryPending& PendingQuery = It.Value();
+
+		if (PendingQuery.Waiters.RemoveAll([RequestID](const FCombatEnvQueryWaiter& Waiter) { return Waiter.RequestID == RequestID; }) == 0)
+		{
+			continue;
+		}
+
+		// drop queries nobody is waiting on anymore if they haven't started yet.
+		// Running queries are left to finish, since their results can still be shared
+		if (PendingQuery.Waiters.Num() == 0 && PendingQuery.QueryID == INDEX_NONE)
+		{
+			StartQueue.Remove(It.Key());
+			It.RemoveCurrent();
+		}
+
+		return;
+	}
+}
+
+void UCombatEnvQuerySubsystem::Tick(float DeltaTime)
+{
+	// expire old results
+	const double CurrentTime = GetWorld()->GetTimeSeconds();
+
+	for (auto It = Cache.CreateIterator(); It; ++It)
+	{
+		if (CurrentTime - It.Value().Time > ResultTimeToLive)
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	// ensure EQS is available
+	if (!UEnvQueryManager::GetCurrent(GetWorld()))
+	{
+		return;
+	}
+
+	// start queued queries within the frame budget
+	int32 StartedQueries = 0;
+
+	while (StartQueue.Num() > 0 && StartedQueries < MaxQueriesPerFrame)
+	{
+		const FCombatEnvQueryKey Key = StartQueue[0];
+		StartQueue.RemoveAt(0, 1, EAllowShrinking::No);
+
+		FCombatEnvQueryPending* PendingQuery = Pending.Find(Key);
+		UEnvQuery* Template = Key.Template.Get();
+
+		if (!PendingQuery || !Template)
+		{
+			FailPendingQuery(Key);
+			continue;
+		}
+
+		// run the query on behalf of the first waiter that's still around
+		UObject* Querier = nullptr;
+
+		for (const FCombatEnvQueryWaiter& Waiter : PendingQuery->Waiters)
+		{
+			if (UObject* WaiterQuerier = Waiter.Querier.Get())
+			{
+				Querier = WaiterQuerier;
+				break;
+			}
+		}
+
+		if (!Querier)
+		{
+			FailPendingQuery(Key);
+			continue;
+		}
+
+		FEnvQueryRequest Request(Template, Querier);
+		PendingQuery->QueryID = Request.Execute(Key.RunMode, FQueryFinishedSignature::CreateUObject(this, &UCombatEnvQuerySubsystem::OnQueryFinished));
+
+		if (PendingQuery->QueryID == INDEX_NONE)
+		{
+			FailPendingQuery(Key);
+			continue;
+		}
+
+		RunningQueries.Add(PendingQuery->QueryID, Key);
+		++StartedQueries;
+	}
+}
+
+TStatId UCombatEnvQuerySubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCombatEnvQuerySubsystem, STATGROUP_Tickables);
+}
+
+void UCombatEnvQuerySubsystem::Deinitialize()
+{
+	// abort any running queries
+	if (UEnvQueryManager* QueryManager = UEnvQueryManager::GetCurrent(GetWorld()))
+	{
+		for (const TPair<int32, FCombatEnvQueryKey>& RunningQuery : RunningQueries)
+		{
+			QueryManager->AbortQuery(RunningQuery.Key);
+		}
+	}
+
+	Cache.Empty();
+	Pending.Empty();
+	StartQueue.Empty();
+	RunningQueries.Empty();
+
+	Super::Deinitialize();
+}
+
+FCombatEnvQueryKey UCombatEnvQuerySubsystem::MakeKey(UEnvQuery* Template, const UObject* Querier, EEnvQueryRunMode::Type RunMode) const
+{
+	FCombatEnvQueryKey Key;
+	Key.Template = Template;
+	Key.RunMode = RunMode;
+
+	const AActor* QuerierActor = Cast<AActor>(Querier);
+
+	if (QuerierActor)
+	{
+		Key.QuerierCell = GetCell(QuerierActor->GetActorLocation());
+	}
+
+	// key by the querier's nearest player, which is the one the player query context resolves to
+	if (const UAIPlayerInfoSubsystem* PlayerInfo = GetWorld()->GetSubsystem<UAIPlayerInfoSubsystem>())
+	{
+		const int32 NearestPlayer = QuerierActor ? PlayerInfo->FindNearestPlayer(QuerierActor->GetActorLocation()) : 0;
+		Key.PlayerCell = GetCell(PlayerInfo->GetPlayerLocation(NearestPlayer));
+	}
+	else if (const APawn* PlayerPawn = UGameplayStatics::GetPlayerPawn(this, 0))
+	{
+		Key.PlayerCell = GetCell(PlayerPawn->GetActorLocation());
+	}
+
+	return Key;
+}
+
+FIntVector UCombatEnvQuerySubsystem::GetCell(const FVector& Location) const
+{
+	const double InvCellSize = 1.0 / FMath::Max(CellSize, 1.0f);
+	return FIntVector(FMath::FloorToInt32(Location.X * InvCellSize), FMath::FloorToInt32(Location.Y * InvCellSize), FMath::FloorToInt32(Location.Z * InvCellSize));
+}
+
+void UCombatEnvQuerySubsystem::OnQueryFinished(TSharedPtr<FEnvQueryResult> Result)
+{
+	FCombatEnvQueryKey Key;
+
+	if (!Result.IsValid() || !RunningQueries.RemoveAndCopyValue(Result->QueryID, Key))
+	{
+		return;
+	}
+
+	// cache successful results so later requests can share them
+	if (Result->IsSuccessful())
+	{
+		FCombatEnvQueryCacheEntry& Entry = Cache.Add(Key);
+		Entry.Result = Result;
+		Entry.Time = GetWorld()->GetTimeSeconds();
+	}
+
+	// notify everybody waiting on the query
+	FCombatEnvQueryPending PendingQuery;
+
+	if (Pending.RemoveAndCopyValue(Key, PendingQuery))
+	{
+		for (const FCombatEnvQueryWaiter& Waiter : PendingQuery.Waiters)
+		{
+			Waiter.OnFinished.ExecuteIfBound(Result);
+		}
+	}
+}
+
+void UCombatEnvQuerySubsystem::FailPendingQuery(const FCombatEnvQueryKey& Key)
+{
+	// remove the query first, since waiters may request new queries in response
+	FCombatEnvQueryPending PendingQuery;
+
+	if (Pending.RemoveAndCopyValue(Key, PendingQuery))
+	{
+		for (const FCombatEnvQueryWaiter& Waiter : PendingQuery.Waiters)
+		{
+			Waiter.OnFinished.ExecuteIfBound(nullptr);
+		}
+	}
+}
@@ -0,0 +1,155 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "EnvironmentQuery/EnvQueryTypes.h"
+#include "CombatEnvQuerySubsystem.generated.h"
+
+class UEnvQuery;
+
+/** Notifies a requester that its shared query finished */
+DECLARE_DELEGATE_OneParam(FOnSharedEnvQueryFinished, TSharedPtr<FEnvQueryResult> /* Result */);
+
+/** Identifies queries that can share their results */
+struct FCombatEnvQueryKey
+{
+	/** Query template */
+	TWeakObjectPtr<UEnvQuery> Template;
+
+	/** Grid cell containing the querier */
+	FIntVector QuerierCell = FIntVector::ZeroValue;
+
+	/** Grid cell containing the player */
+	FIntVector PlayerCell = FIntVector::ZeroValue;
+
+	/** Query run mode */
+	EEnvQueryRunMode::Type RunMode = EEnvQueryRunMode::SingleResult;
+
+	bool operator==(const FCombatEnvQueryKey& Other) const
+	{
+		return Template == Other.Template && QuerierCell == Other.QuerierCell && PlayerCell == Other.PlayerCell && RunMode == Other.RunMode;
+	}
+
+	friend uint32 GetTypeHash(const FCombatEnvQueryKey& Key)
+	{
+		return HashCombine(HashCombine(GetTypeHash(Key.Template), GetTypeHash(Key.QuerierCell)), HashCombine(GetTypeHash(Key.PlayerCell), GetTypeHash(static_cast<uint8>(Key.RunMode))));
+	}
+};
+
+/** A requester waiting on a shared query */
+struct FCombatEnvQueryWaiter
+{
+	/** Request ID handed out to the requester */
+	int32 RequestID = INDEX_NONE;
+
+	/** Object that asked for the query */
+	TWeakObjectPtr<UObject> Querier;
+
+	/** Called when the query finishes */
+	FOnSharedEnvQueryFinished OnFinished;
+};
+
+/** A shared query that is queued or running */
+struct FCombatEnvQueryPending
+{
+	/** EQS query ID, or INDEX_NONE if the query hasn't started yet */
+	int32 QueryID = INDEX_NONE;
+
+	/** Requesters waiting on this query */
+	TArray<FCombatEnvQueryWaiter> Waiters;
+};
+
+/** A finished query result kept around for sharing */
+struct FCombatEnvQueryCacheEntry
+{
+	/** Query result */
+	TSharedPtr<FEnvQueryResult> Result;
+
+	/** Game time when the result was produced */
+	double Time = 0.0;
+};
+
+/**
+ *  Shares and time-slices EQS queries between combat enemies.
+ *  Queries are keyed by template, querier grid cell and player grid cell.
+ *  Requests matching a cached result or a query already in flight share it instead of running their own.
+ *  New queries are started under a per-frame budget, and each running query is time-sliced by the EQS manager.
+ */
+UCLASS(config=Game)
+class UCombatEnvQuerySubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Size of the grid cells used to match queriers and player locations */
+	UPROPERTY(Config)
+	float CellSize = 200.0f;
+
+	/** Time a finished query result can be shared for */
+	UPROPERTY(Config)
+	float ResultTimeToLive = 0.5f;
+
+	/** Maximum number of new queries started per frame */
+	UPROPERTY(Config)
+	int32 MaxQueriesPerFrame = 2;
+
+	/** Finished results that can still be shared */
+	TMap<FCombatEnvQueryKey, FCombatEnvQueryCacheEntry> Cache;
+
+	/** Queued and running queries */
+	TMap<FCombatEnvQueryKey, FCombatEnvQueryPending> Pending;
+
+	/** Queued queries, in the order they were requested */
+	TArray<FCombatEnvQueryKey> StartQueue;
+
+	/** Maps running EQS query IDs back to their keys */
+	TMap<int32, FCombatEnvQueryKey> RunningQueries;
+
+	/** Last handed out request ID */
+	int32 LastRequestID = 0;
+
+public:
+
+	/**
+	 *  Requests a query for the provided querier.
+	 *  If a fresh matching result is cached, it's returned right away and the delegate is never called.
+	 *  Otherwise the delegate is called once the shared query finishes, and OutRequestID can be used to cancel it.
+	 *  If the shared query can't be started, the delegate is called with a null result.
+	 */
+	TSharedPtr<FEnvQueryResult> RequestQuery(UEnvQuery* Template, UObject* Querier, EEnvQueryRunMode::Type RunMode, const FOnSharedEnvQueryFinished& OnFinished, int32& OutRequestID);
+
+	/** Stops waiting on a previously requested query */
+	void CancelQuery(int32 RequestID);
+
+public:
+
+	// ~begin UTickableWorldSubsystem interface
+
+	/** Starts queued queries within the frame budget and expires old results */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Returns the stat ID for the tickable */
+	virtual TStatId GetStatId() const override;
+
+	/** Cleanup */
+	virtual void Deinitialize() override;
+
+	// ~end UTickableWorldSubsystem interface
+
+protected:
+
+	/** Builds the sharing key for a query */
+	FCombatEnvQueryKey MakeKey(UEnvQuery* Template, const UObject* Querier, EEnvQueryRunMode::Type RunMode) const;
+
+	/** Converts a world location into a grid cell */
+	FIntVector GetCell(const FVector& Location) const;
+
+	/** Handles a finished EQS query */
+	void OnQueryFinished(TSharedPtr<FEnvQueryResult> Result);
+
+	/** Drops a query that couldn't be started, notifying its waiters with a null result */
+	void FailPendingQuery(const FCombatEnvQueryKey& Key);
+};
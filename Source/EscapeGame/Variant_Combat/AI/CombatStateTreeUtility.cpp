@@ -6,8 +6,12 @@
 #include "StateTreeExecutionTypes.h"
 #include "GameFramework/Character.h"
 #include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/PlayerController.h"
 #include "AIController.h"
 #include "CombatEnemy.h"
+#include "AIPlayerInfoSubsystem.h"
+#include "AIStateTreeEvents.h"
+#include "CombatEnvQuerySubsystem.h"
 #include "Kismet/GameplayStatics.h"
 #include "StateTreeAsyncExecutionContext.h"
 
@@ -30,6 +34,57 @@ FText FStateTreeCharacterGroundedCondition::GetDescription(const FGuid& ID, FSta
 
 ////////////////////////////////////////////////////////////////////
 
+/** Returns the actor an attack task is aimed at */
+static AActor* GetAttackTarget(const FStateTreeAttackInstanceData& InstanceData)
+{
+	if (InstanceData.AttackTarget)
+	{
+		return InstanceData.AttackTarget;
+	}
+
+	// default to the closest player pawn, so tokens are counted against whoever we're actually fighting
+	APawn* ClosestPawn = nullptr;
+	double ClosestDistSquared = TNumericLimits<double>::Max();
+
+	for (FConstPlayerControllerIterator It = InstanceData.Character->GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController = It->Get();
+		APawn* PlayerPawn = PlayerController ? PlayerController->GetPawn() : nullptr;
+
+		if (!PlayerPawn)
+		{
+			continue;
+		}
+
+		const double DistSquared = FVector::DistSquared(PlayerPawn->GetActorLocation(), InstanceData.Character->GetActorLocation());
+
+		if (DistSquared < ClosestDistSquared)
+		{
+			ClosestDistSquared = DistSquared;
+			ClosestPawn = PlayerPawn;
+		}
+	}
+
+	return ClosestPawn;
+}
+
+bool FStateTreeAttackTokenAvailableCondition::TestCondition(FStateTreeExecutionContext& Context) const
+{
+	const FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
+
+	// could the character attack right now?
+	return InstanceData.Character->CanAcquireAttackToken(GetAttackTarget(InstanceData));
+}
+
+#if WITH_EDITOR
+FText FStateTreeAttackTokenAvailableCondition::GetDescription(const FGuid& ID, FStateTreeDataView InstanceDataView, const IStateTreeBindingLookup& BindingLookup, EStateTreeNodeFormatting Formatting /*= EStateTreeNodeFormatting::Text*/) const
+{
+	return FText::FromString("<b>Attack Token Available</b>");
+}
+#endif // WITH_EDITOR
+
+////////////////////////////////////////////////////////////////////
+
 EStateTreeRunStatus FStateTreeComboAttackTask::EnterState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const
 {
 	// have we transitioned from another state?
@@ -38,6 +93,12 @@ EStateTreeRunStatus FStateTreeComboAttackTask::EnterState(FStateTreeExecutionCon
 		// get the instance data
 		FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
 
+		// wait for our turn if the target's attack slots are taken
+		if (!InstanceData.Character->AcquireAttackToken(GetAttackTarget(InstanceData)))
+		{
+			return EStateTreeRunStatus::Failed;
+		}
+
 		// bind to the on attack completed delegate
 		InstanceData.Character->OnAttackCompleted.BindLambda(
 			[WeakContext = Context.MakeWeakExecutionContext()]()
@@ -64,6 +125,9 @@ void FStateTreeComboAttackTask::ExitState(FStateTreeExecutionContext& Context, c
 
 		// unbind the on attack completed delegate
 		InstanceData.Character->OnAttackCompleted.Unbind();
+
+		// let other attackers have a turn
+		InstanceData.Character->ReleaseAttackToken();
 	}
 }
 
@@ -84,6 +148,12 @@ EStateTreeRunStatus FStateTreeChargedAttackTask::EnterState(FStateTreeExecutionC
 		// get the instance data
 		FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
 
+		// wait for our turn if the target's attack slots are taken
+		if (!InstanceData.Character->AcquireAttackToken(GetAttackTarget(InstanceData)))
+		{
+			return EStateTreeRunStatus::Failed;
+		}
+
 		// bind to the on attack completed delegate
 		InstanceData.Character->OnAttackCompleted.BindLambda(
 			[WeakContext = Context.MakeWeakExecutionContext()]()
@@ -109,6 +179,9 @@ void FStateTreeChargedAttackTask::ExitState(FStateTreeExecutionContext& Context,
 
 		// unbind the on attack completed delegate
 		InstanceData.Character->OnAttackCompleted.Unbind();
+
+		// let other attackers have a turn
+		InstanceData.Character->ReleaseAttackToken();
 	}
 }
 
@@ -261,30 +334,198 @@ FText FStateTreeSetCharacterSpeedTask::GetDescription(const FGuid& ID, FStateTre
 
 ////////////////////////////////////////////////////////////////////
 
-EStateTreeRunStatus FStateTreeGetPlayerInfoTask::Tick(FStateTreeExecutionContext& Context, const float DeltaTime) const
+FStateTreeGetPlayerInfoTask::FStateTreeGetPlayerInfoTask()
+{
+	// the outputs are pushed by the player info subsystem, so we never need to tick
+	bShouldCallTick = false;
+}
+
+EStateTreeRunStatus FStateTreeGetPlayerInfoTask::EnterState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const
+{
+	// have we transitioned from another state?
+	if (Transition.ChangeType == EStateTreeStateChangeType::Changed)
+	{
+		// get the instance data
+		FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
+
+		// register with the player info subsystem so our nearest player gets tracked every frame
+		if (UAIPlayerInfoSubsystem* PlayerInfo = InstanceData.Character->GetWorld()->GetSubsystem<UAIPlayerInfoSubsystem>())
+		{
+			InstanceData.PlayerInfoHandle = PlayerInfo->RegisterAgent(InstanceData.Character);
+			UpdateOutputs(InstanceData, PlayerInfo);
+
+			// update the outputs and notify the tree only when the target changes enough, so nobody needs to poll
+			PlayerInfo->TrackPlayer(InstanceData.PlayerInfoHandle, InstanceData.UpdateTolerance, FOnPlayerInfoChanged::CreateLambda(
+				[WeakContext = Context.MakeWeakExecutionContext(), InstanceDataRef = Context.GetInstanceDataStructRef(*this), WeakPlayerInfo = TWeakObjectPtr<UAIPlayerInfoSubsystem>(PlayerInfo)]() mutable
+				{
+					if (FInstanceDataType* InstanceDataPtr = InstanceDataRef.GetPtr())
+					{
+						UpdateOutputs(*InstanceDataPtr, WeakPlayerInfo.Get());
+					}
+
+					WeakContext.SendEvent(TAG_AI_Event_PlayerInfoChanged);
+				}
+			));
+		}
+		else
+		{
+			// no subsystem, so evaluate the target once
+			UpdateOutputs(InstanceData, nullptr);
+		}
+	}
+
+	return EStateTreeRunStatus::Running;
+}
+
+void FStateTreeGetPlayerInfoTask::ExitState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const
+{
+	// have we transitioned to another state?
+	if (Transition.ChangeType == EStateTreeStateChangeType::Changed)
+	{
+		// get the instance data
+		FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
+
+		// unregister from the player info subsystem
+		if (UAIPlayerInfoSubsystem* PlayerInfo = InstanceData.Character->GetWorld()->GetSubsystem<UAIPlayerInfoSubsystem>())
+		{
+			PlayerInfo->UnregisterAgent(InstanceData.PlayerInfoHandle);
+		}
+
+		InstanceData.PlayerInfoHandle = INDEX_NONE;
+	}
+}
+
+void FStateTreeGetPlayerInfoTask::UpdateOutputs(FInstanceDataType& InstanceData, const UAIPlayerInfoSubsystem* PlayerInfo)
+{
+	if (PlayerInfo && InstanceData.PlayerInfoHandle != INDEX_NONE)
+	{
+		// read the shared info for our nearest player
+		const int32 NearestPlayer = PlayerInfo->GetNearestPlayer(InstanceData.PlayerInfoHandle);
+		InstanceData.TargetPlayerCharacter = Cast<ACharacter>(PlayerInfo->GetPlayerPawn(NearestPlayer));
+
+		// do we have a valid target?
+		if (InstanceData.TargetPlayerCharacter)
+		{
+			// update the last known location and velocity, and the distance to them
+			InstanceData.TargetPlayerLocation = PlayerInfo->GetPlayerLocation(NearestPlayer);
+			InstanceData.TargetPlayerVelocity = PlayerInfo->GetPlayerVelocity(NearestPlayer);
+			InstanceData.DistanceToTarget = PlayerInfo->GetDistanceToPlayer(InstanceData.PlayerInfoHandle);
+
+			return;
+		}
+	}
+	else if (InstanceData.Character)
+	{
+		// get the character possessed by the first local player
+		InstanceData.TargetPlayerCharacter = Cast<ACharacter>(UGameplayStatics::GetPlayerPawn(InstanceData.Character, 0));
+
+		// do we have a valid target?
+		if (InstanceData.TargetPlayerCharacter)
+		{
+			// update the last known location and velocity
+			InstanceData.TargetPlayerLocation = InstanceData.TargetPlayerCharacter->GetActorLocation();
+			InstanceData.TargetPlayerVelocity = InstanceData.TargetPlayerCharacter->GetVelocity();
+		}
+	}
+
+	// update the distance to the last known location
+	if (InstanceData.Character)
+	{
+		InstanceData.DistanceToTarget = FVector::Distance(InstanceData.TargetPlayerLocation, InstanceData.Character->GetActorLocation());
+	}
+}
+
+#if WITH_EDITOR
+FText FStateTreeGetPlayerInfoTask::GetDescription(const FGuid& ID, FStateTreeDataView InstanceDataView, const IStateTreeBindingLookup& BindingLookup, EStateTreeNodeFormatting Formatting /*= EStateTreeNodeFormatting::Text*/) const
+{
+	return FText::FromString("<b>Get Player Info</b>");
+}
+#endif // WITH_EDITOR
+
+////////////////////////////////////////////////////////////////////
+
+FStateTreeSharedEnvQueryTask::FStateTreeSharedEnvQueryTask()
+{
+	// the subsystem finishes the task when the query completes, so we never need to tick
+	bShouldCallTick = false;
+}
+
+EStateTreeRunStatus FStateTreeSharedEnvQueryTask::EnterState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const
 {
 	// get the instance data
 	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
 
-	// get the character possessed by the first local player
-	InstanceData.TargetPlayerCharacter = Cast<ACharacter>(UGameplayStatics::GetPlayerPawn(InstanceData.Character, 0));
+	UCombatEnvQuerySubsystem* EnvQueries = Context.GetWorld()->GetSubsystem<UCombatEnvQuerySubsystem>();
 
-	// do we have a valid target?
-	if (InstanceData.TargetPlayerCharacter)
+	if (!EnvQueries)
 	{
-		// update the last known location
-		InstanceData.TargetPlayerLocation = InstanceData.TargetPlayerCharacter->GetActorLocation();
+		return EStateTreeRunStatus::Failed;
 	}
 
-	// update the distance
-	InstanceData.DistanceToTarget = FVector::Distance(InstanceData.TargetPlayerLocation, InstanceData.Character->GetActorLocation());
+	// request the query. We may get a shared result right away
+	const TSharedPtr<FEnvQueryResult> CachedResult = EnvQueries->RequestQuery(InstanceData.QueryTemplate, InstanceData.Querier, InstanceData.RunMode, FOnSharedEnvQueryFinished::CreateLambda(
+		[WeakContext = Context.MakeWeakExecutionContext(), InstanceDataRef = Context.GetInstanceDataStructRef(*this)](TSharedPtr<FEnvQueryResult> Result) mutable
+		{
+			bool bSucceeded = false;
+
+			// copy the result to the outputs
+			if (FInstanceDataType* InstanceDataPtr = InstanceDataRef.GetPtr())
+			{
+				InstanceDataPtr->RequestID = INDEX_NONE;
+				bSucceeded = ApplyQueryResult(*InstanceDataPtr, Result.Get());
+			}
+
+			// complete the task
+			WeakContext.FinishTask(bSucceeded ? EStateTreeFinishTaskType::Succeeded : EStateTreeFinishTaskType::Failed);
+		}
+	), InstanceData.RequestID);
+
+	// did we get a shared result right away?
+	if (CachedResult.IsValid())
+	{
+		return ApplyQueryResult(InstanceData, CachedResult.Get()) ? EStateTreeRunStatus::Succeeded : EStateTreeRunStatus::Failed;
+	}
+
+	// fail right away if the query couldn't be requested
+	if (InstanceData.RequestID == INDEX_NONE)
+	{
+		return EStateTreeRunStatus::Failed;
+	}
 
 	return EStateTreeRunStatus::Running;
 }
 
+void FStateTreeSharedEnvQueryTask::ExitState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const
+{
+	// get the instance data
+	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
+
+	// stop waiting on the query
+	if (UCombatEnvQuerySubsystem* EnvQueries = Context.GetWorld()->GetSubsystem<UCombatEnvQuerySubsystem>())
+	{
+		EnvQueries->CancelQuery(InstanceData.RequestID);
+	}
+
+	InstanceData.RequestID = INDEX_NONE;
+}
+
+bool FStateTreeSharedEnvQueryTask::ApplyQueryResult(FInstanceDataType& InstanceData, const FEnvQueryResult* Result)
+{
+	if (!Result || !Result->IsSuccessful() || Result->Items.Num() == 0)
+	{
+		return false;
+	}
+
+	// copy the best item to the outputs
+	InstanceData.ResultLocation = Result->GetItemAsLocation(0);
+	InstanceData.ResultActor = Result->GetItemAsActor(0);
+
+	return true;
+}
+
 #if WITH_EDITOR
-FText FStateTreeGetPlayerInfoTask::GetDescription(const FGuid& ID, FStateTreeDataView InstanceDataView, const IStateTreeBindingLookup& BindingLookup, EStateTreeNodeFormatting Formatting /*= EStateTreeNodeFormatting::Text*/) const
+FText FStateTreeSharedEnvQueryTask::GetDescription(const FGuid& ID, FStateTreeDataView InstanceDataView, const IStateTreeBindingLookup& BindingLookup, EStateTreeNodeFormatting Formatting /*= EStateTreeNodeFormatting::Text*/) const
 {
-	return FText::FromString("<b>Get Player Info</b>");
+	return FText::FromString("<b>Run Shared Env Query</b>");
 }
-#endif // WITH_EDITOR
\ No newline at end of file
+#endif // WITH_EDITOR
@@ -5,12 +5,15 @@
 #include "CoreMinimal.h"
 #include "StateTreeTaskBase.h"
 #include "StateTreeConditionBase.h"
+#include "EnvironmentQuery/EnvQueryTypes.h"
 
 #include "CombatStateTreeUtility.generated.h"
 
 class ACharacter;
 class AAIController;
 class ACombatEnemy;
+class UEnvQuery;
+class UAIPlayerInfoSubsystem;
 
 /**
  *  Instance data struct for the FStateTreeCharacterGroundedCondition condition
@@ -32,6 +35,8 @@ STATETREE_POD_INSTANCEDATA(FStateTreeCharacterGroundedConditionInstanceData);
 
 /**
  *  StateTree condition to check if the character is grounded
+ *  This is a one-off read, evaluated whenever its transition is. It isn't event-driven itself:
+ *  put it on transitions triggered by the AI.Event.Movement events so it's only evaluated when the grounded state changes
  */
 USTRUCT(DisplayName = "Character is Grounded")
 struct FStateTreeCharacterGroundedCondition : public FStateTreeConditionCommonBase
@@ -69,10 +74,42 @@ struct FStateTreeAttackInstanceData
 	/** Character that will perform the attack */
 	UPROPERTY(EditAnywhere, Category = Context)
 	TObjectPtr<ACombatEnemy> Character;
+
+	/** Actor the attack is aimed at, used to claim an attack token. Defaults to the closest player pawn if not set */
+	UPROPERTY(EditAnywhere, Category = Parameter)
+	TObjectPtr<AActor> AttackTarget;
+};
+
+/**
+ *  StateTree condition to check if the character could get an attack token on its target
+ *  Lets trees keep enemies in idle or strafing states while the target's attack slots are taken
+ */
+USTRUCT(DisplayName = "Attack Token Available", Category="Combat")
+struct FStateTreeAttackTokenAvailableCondition : public FStateTreeConditionCommonBase
+{
+	GENERATED_BODY()
+
+	/** Set the instance data type */
+	using FInstanceDataType = FStateTreeAttackInstanceData;
+	virtual const UStruct* GetInstanceDataType() const override { return FInstanceDataType::StaticStruct(); }
+
+	/** Default constructor */
+	FStateTreeAttackTokenAvailableCondition() = default;
+
+	/** Tests the StateTree condition */
+	virtual bool TestCondition(FStateTreeExecutionContext& Context) const override;
+
+#if WITH_EDITOR
+
+	/** Provides the description string */
+	virtual FText GetDescription(const FGuid& ID, FStateTreeDataView InstanceDataView, const IStateTreeBindingLookup& BindingLookup, EStateTreeNodeFormatting Formatting = EStateTreeNodeFormatting::Text) const override;
+#endif
+
 };
 
 /**
  *  StateTree task to perform a combo attack
+ *  Fails if the character can't get an attack token on its target
  */
 USTRUCT(meta=(DisplayName="Combo Attack", Category="Combat"))
 struct FStateTreeComboAttackTask : public FStateTreeTaskCommonBase
@@ -96,6 +133,7 @@ struct FStateTreeComboAttackTask : public FStateTreeTaskCommonBase
 
 /**
  *  StateTree task to perform a charged attack
+ *  Fails if the character can't get an attack token on its target
  */
 USTRUCT(meta=(DisplayName="Charged Attack", Category="Combat"))
 struct FStateTreeChargedAttackTask : public FStateTreeTaskCommonBase
@@ -285,13 +323,26 @@ struct FStateTreeGetPlayerInfoInstanceData
 	UPROPERTY(VisibleAnywhere)
 	FVector TargetPlayerLocation = FVector::ZeroVector;
 
+	/** Last known velocity for the target */
+	UPROPERTY(VisibleAnywhere)
+	FVector TargetPlayerVelocity = FVector::ZeroVector;
+
 	/** Distance to the target */
 	UPROPERTY(VisibleAnywhere)
 	float DistanceToTarget = 0.0f;
+
+	/** The outputs are only updated when the target moves or the distance changes by more than this */
+	UPROPERTY(EditAnywhere, Category = Parameter, meta = (ClampMin = 0, ClampMax = 1000, Units = "cm"))
+	float UpdateTolerance = 25.0f;
+
+	/** Handle of the character in the AI player info subsystem */
+	int32 PlayerInfoHandle = INDEX_NONE;
 };
 
 /**
- *  StateTree task to get information about the player character
+ *  StateTree task to get information about the player character nearest to the owner
+ *  Doesn't tick. The outputs are pushed by UAIPlayerInfoSubsystem when the target changes, or moves more than the update tolerance,
+ *  and AI.Event.PlayerInfoChanged is sent so the tree re-evaluates. Trees that only need to react to the distance should use Watch Player Range instead
  */
 USTRUCT(meta=(DisplayName="GetPlayerInfo", Category="Combat"))
 struct FStateTreeGetPlayerInfoTask : public FStateTreeTaskCommonBase
@@ -302,10 +353,88 @@ struct FStateTreeGetPlayerInfoTask : public FStateTreeTaskCommonBase
 	using FInstanceDataType = FStateTreeGetPlayerInfoInstanceData;
 	virtual const UStruct* GetInstanceDataType() const override { return FInstanceDataType::StaticStruct(); }
 
-	/** Runs while the owning state is active */
-	virtual EStateTreeRunStatus Tick(FStateTreeExecutionContext& Context, const float DeltaTime) const override;
+	/** Constructor */
+	FStateTreeGetPlayerInfoTask();
+
+	/** Runs when the owning state is entered */
+	virtual EStateTreeRunStatus EnterState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const override;
+
+	/** Runs when the owning state is ended */
+	virtual void ExitState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const override;
 
 #if WITH_EDITOR
 	virtual FText GetDescription(const FGuid& ID, FStateTreeDataView InstanceDataView, const IStateTreeBindingLookup& BindingLookup, EStateTreeNodeFormatting Formatting = EStateTreeNodeFormatting::Text) const override;
 #endif // WITH_EDITOR
-};
\ No newline at end of file
+
+protected:
+
+	/** Copies the owner's nearest player info into the outputs */
+	static void UpdateOutputs(FInstanceDataType& InstanceData, const UAIPlayerInfoSubsystem* PlayerInfo);
+};
+
+////////////////////////////////////////////////////////////////////
+
+/**
+ *  Instance data struct for the Run Shared Env Query task
+ */
+USTRUCT()
+struct FStateTreeSharedEnvQueryInstanceData
+{
+	GENERATED_BODY()
+
+	/** Actor that runs the query */
+	UPROPERTY(EditAnywhere, Category = Context)
+	TObjectPtr<AActor> Querier;
+
+	/** Query to run */
+	UPROPERTY(EditAnywhere, Category = Parameter)
+	TObjectPtr<UEnvQuery> QueryTemplate;
+
+	/** How the query picks its result */
+	UPROPERTY(EditAnywhere, Category = Parameter)
+	TEnumAsByte<EEnvQueryRunMode::Type> RunMode = EEnvQueryRunMode::SingleResult;
+
+	/** Location of the best query item */
+	UPROPERTY(VisibleAnywhere, Category = Output)
+	FVector ResultLocation = FVector::ZeroVector;
+
+	/** Actor of the best query item, if the query returns actors */
+	UPROPERTY(VisibleAnywhere, Category = Output)
+	TObjectPtr<AActor> ResultActor;
+
+	/** Request ID in the shared query subsystem */
+	int32 RequestID = INDEX_NONE;
+};
+
+/**
+ *  StateTree task to run an EnvQuery through UCombatEnvQuerySubsystem
+ *  Nearby enemies running the same query share its result, and new queries are started under a per-frame budget
+ *  Doesn't tick. The task finishes from the subsystem's callback once the shared query completes
+ */
+USTRUCT(meta=(DisplayName="Run Shared Env Query", Category="Combat"))
+struct FStateTreeSharedEnvQueryTask : public FStateTreeTaskCommonBase
+{
+	GENERATED_BODY()
+
+	/* Ensure we're using the correct instance data struct */
+	using FInstanceDataType = FStateTreeSharedEnvQueryInstanceData;
+	virtual const UStruct* GetInstanceDataType() const override { return FInstanceDataType::StaticStruct(); }
+
+	/** Constructor */
+	FStateTreeSharedEnvQueryTask();
+
+	/** Runs when the owning state is entered */
+	virtual EStateTreeRunStatus EnterState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const override;
+
+	/** Runs when the owning state is ended */
+	virtual void ExitState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const override;
+
+#if WITH_EDITOR
+	virtual FText GetDescription(const FGuid& ID, FStateTreeDataView InstanceDataView, const IStateTreeBindingLookup& BindingLookup, EStateTreeNodeFormatting Formatting = EStateTreeNodeFormatting::Text) const override;
+#endif // WITH_EDITOR
+
+protected:
+
+	/** Copies the best item of a query result to the outputs. Returns false if the query failed or found nothing */
+	static bool ApplyQueryResult(FInstanceDataType& InstanceData, const FEnvQueryResult* Result);
+};
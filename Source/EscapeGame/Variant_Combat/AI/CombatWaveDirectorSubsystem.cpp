@@ -0,0 +1,103 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatWaveDirectorSubsystem.h"
+#include "CombatEnemySpawner.h"
+#include "CombatEnemy.h"
+#include "CombatSimulation.h"
+
+void UCombatWaveDirectorSubsystem::RequestSpawn(ACombatEnemySpawner* Spawner, float Cost)
+{
+	// ensure the spawner is valid
+	if (!IsValid(Spawner))
+	{
+		return;
+	}
+
+	// add the request to the back of the queue
+	FCombatSpawnRequest& Request = SpawnQueue.AddDefaulted_GetRef();
+	Request.Spawner = Spawner;
+	Request.Cost = FMath::Max(Cost, 0.0f);
+}
+
+void UCombatWaveDirectorSubsystem::CancelSpawns(const ACombatEnemySpawner* Spawner)
+{
+	SpawnQueue.RemoveAll([Spawner](const FCombatSpawnRequest& Request)
+	{
+		return Request.Spawner.Get() == Spawner;
+	});
+}
+
+void UCombatWaveDirectorSubsystem::NotifyEnemyDied()
+{
+	// the dead enemy is still in the list, so find it by its state
+	ReleaseInactiveEnemies();
+}
+
+void UCombatWaveDirectorSubsystem::ReleaseInactiveEnemies()
+{
+	ActiveEnemies.RemoveAllSwap([](const TWeakObjectPtr<ACombatEnemy>& WeakEnemy)
+	{
+		const ACombatEnemy* Enemy = WeakEnemy.Get();
+		return !IsValid(Enemy) || Enemy->IsPooled() || FCombatRules::IsDead(Enemy->CurrentHP);
+	}, EAllowShrinking::No);
+}
+
+void UCombatWaveDirectorSubsystem::Tick(float DeltaTime)
+{
+	// free up the slots of enemies that went away without dying, e.g. by falling out of the world
+	ReleaseInactiveEnemies();
+
+	float SpentBudget = 0.0f;
+	int32 ProcessedRequests = 0;
+
+	// process requests in order until we run out of budget or enemy slots
+	while (ProcessedRequests < SpawnQueue.Num() && ActiveEnemies.Num() < MaxConcurrentEnemies)
+	{
+		const FCombatSpawnRequest& Request = SpawnQueue[ProcessedRequests];
+
+		// always process at least one request per frame so expensive spawns can't stall the queue
+		if (ProcessedRequests > 0 && SpentBudget + Request.Cost > SpawnBudgetPerFrame)
+		{
+			break;
+		}
+
+		++ProcessedRequests;
+
+		// skip requests from spawners that have gone away
+		ACombatEnemySpawner* Spawner = Request.Spawner.Get();
+
+		if (!Spawner)
+		{
+			continue;
+		}
+
+		SpentBudget += Request.Cost;
+
+		// spawn the enemy and take up a slot
+		if (ACombatEnemy* SpawnedEnemy = Spawner->SpawnEnemy())
+		{
+			ActiveEnemies.Add(SpawnedEnemy);
+		}
+	}
+
+	// remove the processed requests while keeping the order of the rest
+	if (ProcessedRequests > 0)
+	{
+		SpawnQueue.RemoveAt(0, ProcessedRequests, EAllowShrinking::No);
+	}
+}
+
+TStatId UCombatWaveDirectorSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCombatWaveDirectorSubsystem, STATGROUP_Tickables);
+}
+
+void UCombatWaveDirectorSubsystem::Deinitialize()
+{
+	// clear all pending spawns
+	SpawnQueue.Empty();
+	ActiveEnemies.Empty();
+
+	Super::Deinitialize();
+}
@@ -0,0 +1,82 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CombatWaveDirectorSubsystem.generated.h"
+
+class ACombatEnemySpawner;
+class ACombatEnemy;
+
+/** A queued enemy spawn waiting for the wave director to process it */
+struct FCombatSpawnRequest
+{
+	/** Spawner that requested the enemy */
+	TWeakObjectPtr<ACombatEnemySpawner> Spawner;
+
+	/** Budget cost of spawning this enemy */
+	float Cost = 1.0f;
+};
+
+/**
+ *  Global wave director for enemy spawners.
+ *  Spawners queue their spawn requests here instead of spawning directly.
+ *  The director enforces a cap on concurrently alive enemies and spreads spawns across frames under a per-frame cost budget.
+ *  Live enemies are tracked weakly, so enemies destroyed or pooled without dying still free up their slot.
+ */
+UCLASS(config=Game)
+class UCombatWaveDirectorSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Maximum number of spawned enemies that can be alive at the same time */
+	UPROPERTY(Config)
+	int32 MaxConcurrentEnemies = 8;
+
+	/** Total spawn cost that can be processed in a single frame. At least one spawn is always processed per frame */
+	UPROPERTY(Config)
+	float SpawnBudgetPerFrame = 1.0f;
+
+	/** Pending spawn requests, in the order they were received */
+	TArray<FCombatSpawnRequest> SpawnQueue;
+
+	/** Spawned enemies currently alive */
+	TArray<TWeakObjectPtr<ACombatEnemy>> ActiveEnemies;
+
+public:
+
+	/** Queues an enemy spawn for the provided spawner */
+	void RequestSpawn(ACombatEnemySpawner* Spawner, float Cost);
+
+	/** Removes all queued spawns for the provided spawner */
+	void CancelSpawns(const ACombatEnemySpawner* Spawner);
+
+	/** Notifies the director that a spawned enemy has died, freeing up its slot */
+	void NotifyEnemyDied();
+
+	/** Returns the number of spawned enemies currently alive */
+	int32 GetActiveEnemies() const { return ActiveEnemies.Num(); }
+
+protected:
+
+	/** Frees the slots of enemies that have died, been pooled or been destroyed */
+	void ReleaseInactiveEnemies();
+
+public:
+
+	// ~begin UTickableWorldSubsystem interface
+
+	/** Processes queued spawns within the frame budget */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Returns the stat ID for the tickable */
+	virtual TStatId GetStatId() const override;
+
+	/** Cleanup */
+	virtual void Deinitialize() override;
+
+	// ~end UTickableWorldSubsystem interface
+};
@@ -6,12 +6,29 @@
 #include "EnvironmentQuery/EnvQueryTypes.h"
 #include "EnvironmentQuery/Items/EnvQueryItemType_Actor.h"
 #include "GameFramework/Pawn.h"
+#include "AIPlayerInfoSubsystem.h"
 
 void UEnvQueryContext_Player::ProvideContext(FEnvQueryInstance& QueryInstance, FEnvQueryContextData& ContextData) const
 {
-	// get the player pawn for the first local player
-	AActor* PlayerPawn = UGameplayStatics::GetPlayerPawn(QueryInstance.Owner.Get(), 0);
-	check(PlayerPawn);
+	AActor* PlayerPawn = nullptr;
+	const AActor* QuerierActor = Cast<AActor>(QueryInstance.Owner.Get());
+
+	// use the player nearest to the querier, so shared query results are keyed against the same player
+	if (const UAIPlayerInfoSubsystem* PlayerInfo = QuerierActor ? QuerierActor->GetWorld()->GetSubsystem<UAIPlayerInfoSubsystem>() : nullptr)
+	{
+		PlayerPawn = PlayerInfo->GetPlayerPawn(PlayerInfo->FindNearestPlayer(QuerierActor->GetActorLocation()));
+	}
+	else
+	{
+		// get the player pawn for the first local player
+		PlayerPawn = UGameplayStatics::GetPlayerPawn(QueryInstance.Owner.Get(), 0);
+	}
+
+	// the player may not have spawned yet or may have died. Provide an empty context so the query fails gracefully
+	if (!PlayerPawn)
+	{
+		return;
+	}
 
 	// add the actor data to the context
 	UEnvQueryItemType_Actor::SetContextHelper(ContextData, PlayerPawn);
@@ -8,7 +8,8 @@
 
 /**
  *  UEnvQueryContext_Player
- *  Basic EnvQuery Context that returns the first local player
+ *  Basic EnvQuery Context that returns the player nearest to the querier
+ *  Provides an empty context if there's no player pawn
  */
 UCLASS()
 class UEnvQueryContext_Player : public UEnvQueryContext
@@ -0,0 +1,146 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatHitReactionComponent.h"
+#include "GameFramework/Character.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Animation/AnimInstance.h"
+#include "Animation/AnimMontage.h"
+
+UCombatHitReactionComponent::UCombatHitReactionComponent()
+{
+	// only tick while a procedural reaction is playing
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+}
+
+void UCombatHitReactionComponent::PlayHitReaction(const FVector& DamageImpulse, FName PinnedBoneName)
+{
+	USkeletalMeshComponent* Mesh = GetOwnerMesh();
+
+	if (!Mesh)
+	{
+		return;
+	}
+
+	// play the directional animation if we have one, unless we always react with physics
+	if (!bAllowPhysicalReaction)
+	{
+		if (UAnimMontage* HitMontage = GetDirectionalMontage(DamageImpulse.GetSafeNormal2D()))
+		{
+			if (UAnimInstance* AnimInstance = Mesh->GetAnimInstance())
+			{
+				if (AnimInstance->Montage_Play(HitMontage) > 0.0f)
+				{
+					return;
+				}
+			}
+		}
+
+		// use the procedural offset if the anim graph applies it
+		if (bUseProceduralReaction)
+		{
+			StartProceduralReaction(DamageImpulse);
+			return;
+		}
+	}
+
+	// fall back to partial ragdoll physics, but keep the pinned bone vertical
+	Mesh->SetPhysicsBlendWeight(PhysicalReactionBlendWeight);
+	Mesh->SetBodySimulatePhysics(PinnedBoneName, false);
+
+	bPhysicalReactionActive = true;
+}
+
+void UCombatHitReactionComponent::ResetPhysicalReaction()
+{
+	// disable ragdoll physics
+	if (USkeletalMeshComponent* Mesh = GetOwnerMesh())
+	{
+		Mesh->SetPhysicsBlendWeight(0.0f);
+	}
+
+	bPhysicalReactionActive = false;
+}
+
+void UCombatHitReactionComponent::StopHitReaction()
+{
+	// reset the physical reaction flag. The owner resets the physics state itself
+	bPhysicalReactionActive = false;
+
+	// stop the procedural reaction and clear the bone offset
+	SetComponentTickEnabled(false);
+
+	ProceduralStrength = 0.0f;
+	ProceduralOffsetLocation = FVector::ZeroVector;
+}
+
+USkeletalMeshComponent* UCombatHitReactionComponent::GetOwnerMesh() const
+{
+	const ACharacter* OwnerCharacter = Cast<ACharacter>(GetOwner());
+	return OwnerCharacter ? OwnerCharacter->GetMesh() : nullptr;
+}
+
+UAnimMontage* UCombatHitReactionComponent::GetDirectionalMontage(const FVector& PushDirection) const
+{
+	if (PushDirection.IsNearlyZero())
+	{
+		return HitFrontMontage;
+	}
+
+	// the hit comes from the opposite side we're pushed towards
+	const FVector HitDirection = -PushDirection;
+	const float ForwardDot = FVector::DotProduct(HitDirection, GetOwner()->GetActorForwardVector());
+	const float RightDot = FVector::DotProduct(HitDirection, GetOwner()->GetActorRightVector());
+
+	// pick the dominant axis
+	if (FMath::Abs(ForwardDot) >= FMath::Abs(RightDot))
+	{
+		return ForwardDot >= 0.0f ? HitFrontMontage : HitBackMontage;
+	}
+
+	return RightDot >= 0.0f ? HitRightMontage : HitLeftMontage;
+}
+
+void UCombatHitReactionComponent::StartProceduralReaction(const FVector& DamageImpulse)
+{
+	// push horizontally along the impulse, in the actor's local space
+	ProceduralDirection = GetOwner()->GetActorTransform().InverseTransformVectorNoScale(DamageImpulse.GetSafeNormal2D());
+	ProceduralStrength = FMath::Clamp(DamageImpulse.Size2D() / ProceduralReferenceImpulse, 0.0f, 1.0f);
+	ProceduralTime = 0.0f;
+
+	if (ProceduralStrength > 0.0f && !ProceduralDirection.IsNearlyZero())
+	{
+		SetComponentTickEnabled(true);
+	}
+}
+
+void UCombatHitReactionComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	USkeletalMeshComponent* Mesh = GetOwnerMesh();
+
+	// stop if the mesh went away or started ragdolling
+	if (!Mesh || Mesh->IsSimulatingPhysics())
+	{
+		StopHitReaction();
+		return;
+	}
+
+	ProceduralTime += DeltaTime;
+
+	// has the reaction finished?
+	if (ProceduralTime >= ProceduralDuration)
+	{
+		StopHitReaction();
+		return;
+	}
+
+	// kick out and settle back over the duration
+	const float Alpha = ProceduralTime / ProceduralDuration;
+	const float Offset = ProceduralOffset * ProceduralStrength * FMath::Sin(Alpha * UE_PI);
+
+	// the direction is in actor space, so rotate it into the mesh's component space for the anim graph
+	ProceduralOffsetLocation = Mesh->GetRelativeRotation().UnrotateVector(ProceduralDirection * Offset);
+}
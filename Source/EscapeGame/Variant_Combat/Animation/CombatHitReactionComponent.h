@@ -0,0 +1,121 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "CombatHitReactionComponent.generated.h"
+
+class UAnimMontage;
+class USkeletalMeshComponent;
+
+/**
+ *  Plays non-lethal hit reactions for a combat character.
+ *  Reactions use directional additive montages chosen from the damage impulse.
+ *  If no montage is set, they use a short procedural bone offset along the impulse, or partial ragdoll physics if the procedural offset isn't enabled.
+ *  The procedural offset is read by the anim graph through GetProceduralOffset, e.g. to drive a Transform (Modify) Bone node on the pelvis,
+ *  so it never fights the movement component's mesh smoothing on simulated proxies.
+ *  Characters may also always react with partial ragdoll physics. Reserve this for high significance characters.
+ */
+UCLASS(ClassGroup=(Combat), meta=(BlueprintSpawnableComponent))
+class UCombatHitReactionComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Additive AnimMontage to play when hit from the front */
+	UPROPERTY(EditAnywhere, Category="Hit Reaction|Animation")
+	UAnimMontage* HitFrontMontage;
+
+	/** Additive AnimMontage to play when hit from the back */
+	UPROPERTY(EditAnywhere, Category="Hit Reaction|Animation")
+	UAnimMontage* HitBackMontage;
+
+	/** Additive AnimMontage to play when hit from the left */
+	UPROPERTY(EditAnywhere, Category="Hit Reaction|Animation")
+	UAnimMontage* HitLeftMontage;
+
+	/** Additive AnimMontage to play when hit from the right */
+	UPROPERTY(EditAnywhere, Category="Hit Reaction|Animation")
+	UAnimMontage* HitRightMontage;
+
+	/** Largest distance the offset bone will be pushed by a procedural hit reaction */
+	UPROPERTY(EditAnywhere, Category="Hit Reaction|Procedural", meta = (ClampMin = 0, ClampMax = 100, Units = "cm"))
+	float ProceduralOffset = 12.0f;
+
+	/** Duration of a procedural hit reaction */
+	UPROPERTY(EditAnywhere, Category="Hit Reaction|Procedural", meta = (ClampMin = 0.01, ClampMax = 2, Units = "s"))
+	float ProceduralDuration = 0.25f;
+
+	/** Impulse magnitude that produces the full procedural offset */
+	UPROPERTY(EditAnywhere, Category="Hit Reaction|Procedural", meta = (ClampMin = 1, ClampMax = 2000, Units = "cm/s"))
+	float ProceduralReferenceImpulse = 300.0f;
+
+	/** If true, hits without a montage play the procedural offset instead of partial ragdoll physics. Only enable if the anim graph applies GetProceduralOffset */
+	UPROPERTY(EditAnywhere, Category="Hit Reaction|Procedural")
+	bool bUseProceduralReaction = false;
+
+	/** If true, hits always enable partial ragdoll physics instead of the animated reaction. Reserve for high significance characters */
+	UPROPERTY(EditAnywhere, Category="Hit Reaction|Physics")
+	bool bAllowPhysicalReaction = false;
+
+	/** Physics blend weight to use for physical hit reactions */
+	UPROPERTY(EditAnywhere, Category="Hit Reaction|Physics", meta = (ClampMin = 0, ClampMax = 1))
+	float PhysicalReactionBlendWeight = 0.5f;
+
+	/** If true, a physical hit reaction is currently active */
+	bool bPhysicalReactionActive = false;
+
+	/** Direction of the current procedural reaction, in actor space */
+	FVector ProceduralDirection = FVector::ZeroVector;
+
+	/** Strength of the current procedural reaction, from 0 to 1 */
+	float ProceduralStrength = 0.0f;
+
+	/** Time elapsed in the current procedural reaction */
+	float ProceduralTime = 0.0f;
+
+	/** Current procedural offset, in the mesh's component space */
+	FVector ProceduralOffsetLocation = FVector::ZeroVector;
+
+public:
+
+	/** Constructor */
+	UCombatHitReactionComponent();
+
+	/** Plays a hit reaction for the provided damage impulse. The pinned bone is kept animated for physical reactions */
+	void PlayHitReaction(const FVector& DamageImpulse, FName PinnedBoneName);
+
+	/** Disables partial ragdoll physics from a physical hit reaction */
+	void ResetPhysicalReaction();
+
+	/** Stops any hit reaction in progress and restores the mesh */
+	void StopHitReaction();
+
+	/** Sets whether hits always enable partial ragdoll physics */
+	void SetAllowPhysicalReaction(bool bAllow) { bAllowPhysicalReaction = bAllow; }
+
+	/** Returns true if a physical hit reaction is currently active */
+	bool IsPhysicalReactionActive() const { return bPhysicalReactionActive; }
+
+	/** Returns the current procedural hit reaction offset, in the mesh's component space. Meant to be added to a bone in the anim graph */
+	UFUNCTION(BlueprintPure, Category="Hit Reaction", meta = (BlueprintThreadSafe))
+	FVector GetProceduralOffset() const { return ProceduralOffsetLocation; }
+
+protected:
+
+	/** Returns the owning character's mesh */
+	USkeletalMeshComponent* GetOwnerMesh() const;
+
+	/** Chooses the directional hit montage for a world space push direction */
+	UAnimMontage* GetDirectionalMontage(const FVector& PushDirection) const;
+
+	/** Starts a procedural hit reaction */
+	void StartProceduralReaction(const FVector& DamageImpulse);
+
+public:
+
+	/** Updates the procedural hit reaction */
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+};
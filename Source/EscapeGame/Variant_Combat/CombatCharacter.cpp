@@ -3,23 +3,39 @@
 
 #include "CombatCharacter.h"
 #include "Components/CapsuleComponent.h"
-#include "Components/WidgetComponent.h"
+#include "CombatLifeBarComponent.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "GameFramework/SpringArmComponent.h"
 #include "Components/SkeletalMeshComponent.h"
 #include "Camera/CameraComponent.h"
 #include "EnhancedInputSubsystems.h"
 #include "EnhancedInputComponent.h"
-#include "CombatLifeBar.h"
 #include "Engine/DamageEvents.h"
 #include "TimerManager.h"
 #include "Engine/LocalPlayer.h"
 #include "CombatPlayerController.h"
+#include "CombatTargetGridSubsystem.h"
+#include "CombatHitReactionComponent.h"
+#include "CombatHurtboxHistoryComponent.h"
+#include "GameFramework/PlayerState.h"
+#include "CombatRagdollSubsystem.h"
+#include "CombatBoxInstanceSubsystem.h"
+#include "CombatDamageableBox.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "CombatSimulation.h"
+#include "GameFramework/GameStateBase.h"
+#include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
 
 ACombatCharacter::ACombatCharacter()
 {
 	PrimaryActorTick.bCanEverTick = true;
 
+	// replicate at a rate that keeps a full server of players within its bandwidth budget
+	bReplicates = true;
+	SetNetUpdateFrequency(30.0f);
+	SetMinNetUpdateFrequency(10.0f);
+
 	// bind the attack montage ended delegate
 	OnAttackMontageEnded.BindUObject(this, &ACombatCharacter::AttackMontageEnded);
 
@@ -44,9 +60,16 @@ ACombatCharacter::ACombatCharacter()
 	FollowCamera->bUsePawnControlRotation = false;
 
 	// create the life bar widget component
-	LifeBar = CreateDefaultSubobject<UWidgetComponent>(TEXT("LifeBar"));
+	LifeBar = CreateDefaultSubobject<UCombatLifeBarComponent>(TEXT("LifeBar"));
 	LifeBar->SetupAttachment(RootComponent);
 
+	// create the hit reaction component. The player is significant enough for physical reactions
+	HitReaction = CreateDefaultSubobject<UCombatHitReactionComponent>(TEXT("HitReaction"));
+	HitReaction->SetAllowPhysicalReaction(true);
+
+	// create the hurtbox history component so other players' attacks can be lag compensated against us
+	HurtboxHistory = CreateDefaultSubobject<UCombatHurtboxHistoryComponent>(TEXT("HurtboxHistory"));
+
 	// set the player tag
 	Tags.Add(FName("Player"));
 }
@@ -118,17 +141,16 @@ void ACombatCharacter::DoLook(float Yaw, float Pitch)
 
 void ACombatCharacter::DoComboAttackStart()
 {
-	// are we already playing an attack animation?
-	if (bIsAttacking)
-	{
-		// cache the input time so we can check it later
-		CachedAttackInputTime = GetWorld()->GetTimeSeconds();
+	const float InputTime = GetAttackInputTime();
 
-		return;
-	}
+	// predict the attack locally
+	const bool bStartedAttack = HandleComboAttackInput(InputTime);
 
-	// perform a combo attack
-	ComboAttack();
+	// clients send the input to the server, which runs it again and corrects us if it disagrees
+	if (!HasAuthority())
+	{
+		ServerComboAttackStart(InputTime, bStartedAttack);
+	}
 }
 
 void ACombatCharacter::DoComboAttackEnd()
@@ -138,18 +160,16 @@ void ACombatCharacter::DoComboAttackEnd()
 
 void ACombatCharacter::DoChargedAttackStart()
 {
-	// raise the charging attack flag
-	bIsChargingAttack = true;
+	const float InputTime = GetAttackInputTime();
 
-	if (bIsAttacking)
-	{
-		// cache the input time so we can check it later
-		CachedAttackInputTime = GetWorld()->GetTimeSeconds();
+	// predict the attack locally
+	const bool bStartedAttack = HandleChargedAttackInput(InputTime);
 
-		return;
+	// clients send the input to the server, which runs it again and corrects us if it disagrees
+	if (!HasAuthority())
+	{
+		ServerChargedAttackStart(InputTime, bStartedAttack);
 	}
-
-	ChargedAttack();
 }
 
 void ACombatCharacter::DoChargedAttackEnd()
@@ -162,15 +182,22 @@ void ACombatCharacter::DoChargedAttackEnd()
 	{
 		CheckChargedAttack();
 	}
+
+	// let the server release the attack too
+	if (!HasAuthority())
+	{
+		ServerChargedAttackEnd();
+	}
 }
 
 void ACombatCharacter::ResetHP()
 {
 	// reset the current HP total
 	CurrentHP = MaxHP;
+	MARK_PROPERTY_DIRTY_FROM_NAME(ACombatCharacter, CurrentHP, this);
 
 	// update the life bar
-	LifeBarWidget->SetLifePercentage(1.0f);
+	LifeBar->SetLifePercentage(1.0f);
 }
 
 void ACombatCharacter::ComboAttack()
@@ -194,6 +221,11 @@ void ACombatCharacter::ComboAttack()
 		}
 	}
 
+	// show the attack to the other clients
+	if (HasAuthority())
+	{
+		MulticastAttackMontage(ComboAttackMontage, NAME_None);
+	}
 }
 
 void ACombatCharacter::ChargedAttack()
@@ -216,6 +248,12 @@ void ACombatCharacter::ChargedAttack()
 			AnimInstance->Montage_SetEndDelegate(OnAttackMontageEnded, ChargedAttackMontage);
 		}
 	}
+
+	// show the attack to the other clients
+	if (HasAuthority())
+	{
+		MulticastAttackMontage(ChargedAttackMontage, NAME_None);
+	}
 }
 
 void ACombatCharacter::AttackMontageEnded(UAnimMontage* Montage, bool bInterrupted)
@@ -223,8 +261,14 @@ void ACombatCharacter::AttackMontageEnded(UAnimMontage* Montage, bool bInterrupt
 	// reset the attacking flag
 	bIsAttacking = false;
 
+	// simulated proxies don't chain attacks on their own
+	if (!RunsAttackLogic())
+	{
+		return;
+	}
+
 	// check if we have a non-stale cached input
-	if (GetWorld()->GetTimeSeconds() - CachedAttackInputTime <= AttackInputCacheTimeTolerance)
+	if (GetAttackInputTime() - CachedAttackInputTime <= AttackInputCacheTimeTolerance)
 	{
 		// are we holding the charged attack button?
 		if (bIsChargingAttack)
@@ -240,20 +284,319 @@ void ACombatCharacter::AttackMontageEnded(UAnimMontage* Montage, bool bInterrupt
 	}
 }
 
+bool ACombatCharacter::HandleComboAttackInput(float InputTime)
+{
+	// are we already playing an attack animation?
+	if (bIsAttacking)
+	{
+		// cache the input time so we can check it later
+		CachedAttackInputTime = InputTime;
+
+		return false;
+	}
+
+	// perform a combo attack
+	ComboAttack();
+
+	return true;
+}
+
+bool ACombatCharacter::HandleChargedAttackInput(float InputTime)
+{
+	// raise the charging attack flag
+	bIsChargingAttack = true;
+
+	if (bIsAttacking)
+	{
+		// cache the input time so we can check it later
+		CachedAttackInputTime = InputTime;
+
+		return false;
+	}
+
+	ChargedAttack();
+
+	return true;
+}
+
+float ACombatCharacter::GetAttackInputTime() const
+{
+	// use the server's clock so timestamps mean the same thing on every machine
+	if (const AGameStateBase* GameState = GetWorld()->GetGameState())
+	{
+		return static_cast<float>(GameState->GetServerWorldTimeSeconds());
+	}
+
+	return GetWorld()->GetTimeSeconds();
+}
+
+bool ACombatCharacter::IsValidAttackInputTime(float InputTime) const
+{
+	// the timestamp arrives half a round trip late, so allow for some latency but reject anything beyond that
+	return FMath::Abs(GetAttackInputTime() - InputTime) <= MaxAttackInputTimeDiscrepancy;
+}
+
+void ACombatCharacter::PlayAttackMontage(UAnimMontage* Montage, FName Section)
+{
+	UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance();
+
+	if (!AnimInstance || !Montage)
+	{
+		return;
+	}
+
+	// start the montage over for a new attack, or if we're not playing it yet
+	if (Section.IsNone() || !AnimInstance->Montage_IsPlaying(Montage))
+	{
+		// raise the attacking flag
+		bIsAttacking = true;
+
+		const float MontageLength = AnimInstance->Montage_Play(Montage, 1.0f, EMontagePlayReturnType::MontageLength, 0.0f, true);
+
+		// subscribe to montage completed and interrupted events
+		if (MontageLength > 0.0f)
+		{
+			AnimInstance->Montage_SetEndDelegate(OnAttackMontageEnded, Montage);
+		}
+	}
+
+	// jump to the requested section
+	if (!Section.IsNone())
+	{
+		AnimInstance->Montage_JumpToSection(Section, Montage);
+	}
+}
+
+void ACombatCharacter::ReconcileAttack()
+{
+	// send the montage and section we're actually playing, or nothing if we're not attacking
+	UAnimMontage* Montage = nullptr;
+	FName Section = NAME_None;
+
+	if (bIsAttacking)
+	{
+		if (UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance())
+		{
+			Montage = AnimInstance->GetCurrentActiveMontage();
+			Section = Montage ? AnimInstance->Montage_GetCurrentSection(Montage) : NAME_None;
+		}
+	}
+
+	ClientReconcileAttack(Montage, Section);
+}
+
+bool ACombatCharacter::RunsAttackLogic() const
+{
+	// the server is authoritative and the owning client predicts. Everyone else follows the server's multicasts
+	return HasAuthority() || IsLocallyControlled();
+}
+
+double ACombatCharacter::GetHitValidationTime() const
+{
+	const double Now = GetWorld()->GetTimeSeconds();
+
+	// locally controlled characters see the world as it is
+	if (IsLocallyControlled())
+	{
+		return Now;
+	}
+
+	// the attack reached us half a round trip late, and the client saw its targets half a round trip in the past
+	const APlayerState* OwningPlayerState = GetPlayerState();
+
+	return OwningPlayerState ? Now - (OwningPlayerState->ExactPing * 0.001) : Now;
+}
+
+void ACombatCharacter::ServerComboAttackStart_Implementation(float InputTime, bool bPredictedAttack)
+{
+	// ignore inputs with untrustworthy timestamps, and correct the client if it acted on one
+	if (!IsValidAttackInputTime(InputTime))
+	{
+		if (bPredictedAttack)
+		{
+			ReconcileAttack();
+		}
+
+		return;
+	}
+
+	// run the input ourselves and correct the client if its prediction was wrong
+	if (HandleComboAttackInput(InputTime) != bPredictedAttack)
+	{
+		ReconcileAttack();
+	}
+}
+
+void ACombatCharacter::ServerChargedAttackStart_Implementation(float InputTime, bool bPredictedAttack)
+{
+	// ignore inputs with untrustworthy timestamps, and correct the client if it acted on one
+	if (!IsValidAttackInputTime(InputTime))
+	{
+		if (bPredictedAttack)
+		{
+			ReconcileAttack();
+		}
+
+		return;
+	}
+
+	// run the input ourselves and correct the client if its prediction was wrong
+	if (HandleChargedAttackInput(InputTime) != bPredictedAttack)
+	{
+		ReconcileAttack();
+	}
+}
+
+void ACombatCharacter::ServerChargedAttackEnd_Implementation()
+{
+	DoChargedAttackEnd();
+}
+
+void ACombatCharacter::ClientReconcileAttack_Implementation(UAnimMontage* Montage, FName Section)
+{
+	UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance();
+
+	if (!AnimInstance)
+	{
+		return;
+	}
+
+	// is the server not attacking?
+	if (!Montage)
+	{
+		// drop any cached input so stopping the montage doesn't chain into another attack
+		CachedAttackInputTime = 0.0f;
+
+		AnimInstance->Montage_Stop(0.1f, ComboAttackMontage);
+		AnimInstance->Montage_Stop(0.1f, ChargedAttackMontage);
+
+		bIsAttacking = false;
+
+		return;
+	}
+
+	// stop any other attack we predicted
+	UAnimMontage* OtherMontage = Montage == ComboAttackMontage ? ChargedAttackMontage : ComboAttackMontage;
+	AnimInstance->Montage_Stop(0.1f, OtherMontage);
+
+	// catch up with the server's attack if we disagree
+	if (!AnimInstance->Montage_IsPlaying(Montage) || AnimInstance->Montage_GetCurrentSection(Montage) != Section)
+	{
+		PlayAttackMontage(Montage, Section);
+	}
+}
+
+void ACombatCharacter::MulticastAttackMontage_Implementation(UAnimMontage* Montage, FName Section)
+{
+	// the server played this already
+	if (HasAuthority())
+	{
+		return;
+	}
+
+	// the owning client predicted this attack, so only correct its section if it disagrees with the server
+	if (IsLocallyControlled())
+	{
+		UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance();
+
+		if (Section.IsNone() || !AnimInstance || !AnimInstance->Montage_IsPlaying(Montage) || AnimInstance->Montage_GetCurrentSection(Montage) == Section)
+		{
+			return;
+		}
+	}
+
+	PlayAttackMontage(Montage, Section);
+}
+
+void ACombatCharacter::MulticastDamageEffects_Implementation(float Damage, FVector_NetQuantize DamageLocation, FVector_NetQuantize10 DamageImpulse, bool bLethal)
+{
+	// is the character ragdolling?
+	if (GetMesh()->IsSimulatingPhysics())
+	{
+		// apply an impulse to the ragdoll
+		GetMesh()->AddImpulseAtLocation(DamageImpulse * GetMesh()->GetMass(), DamageLocation);
+	}
+	else if (bLethal)
+	{
+		// the death state hasn't reached us yet, so keep the impulse until the ragdoll starts
+		PendingDeathImpulse = DamageImpulse;
+		PendingDeathImpulseLocation = DamageLocation;
+	}
+
+	// react to the hit if we survived it
+	if (!bLethal)
+	{
+		HitReaction->PlayHitReaction(DamageImpulse, PelvisBoneName);
+	}
+
+	// pass control to BP to play effects, etc.
+	ReceivedDamage(Damage, DamageLocation, DamageImpulse.GetSafeNormal());
+}
+
+void ACombatCharacter::OnRep_CurrentHP(float PreviousHP)
+{
+	// have we just run out of HP?
+	if (FCombatRules::IsDead(CurrentHP))
+	{
+		if (!FCombatRules::IsDead(PreviousHP))
+		{
+			HandleDeath();
+		}
+
+		return;
+	}
+
+	// update the life bar
+	LifeBar->SetLifePercentage(CurrentHP / MaxHP);
+}
+
 void ACombatCharacter::DoAttackTrace(FName DamageSourceBone)
 {
-	// sweep for objects in front of the character to be hit by the attack
-	TArray<FHitResult> OutHits;
+	// hits are only resolved by the server
+	if (!HasAuthority())
+	{
+		return;
+	}
 
 	// start at the provided socket location, sweep forward
 	const FVector TraceStart = GetMesh()->GetSocketLocation(DamageSourceBone);
 	const FVector TraceEnd = TraceStart + (GetActorForwardVector() * MeleeTraceDistance);
 
-	// check for pawn and world dynamic collision object types
+	// resolve pawn and prop targets through the combat target grid if it's available, so we don't have to touch the physics scene.
+	// This also reaches resting boxes, which are drawn as instances and can't be found through their own collision
+	UCombatTargetGridSubsystem* TargetGrid = GetWorld()->GetSubsystem<UCombatTargetGridSubsystem>();
+
+	if (TargetGrid)
+	{
+		// test pawns where our client saw them. Their hurtbox histories bound how far back we can go. Props have no history and are tested where they are
+		TArray<FCombatTargetCandidate> Candidates;
+		TargetGrid->QueryCapsuleAtTime(TraceStart, TraceEnd, MeleeTraceRadius, GetHitValidationTime(), ECombatTargetType::All, this, Candidates);
+
+		for (const FCombatTargetCandidate& Candidate : Candidates)
+		{
+			// knock upwards and away from the impact normal
+			const FVector Impulse = FCombatRules::ComputeKnockback(Candidate.ImpactNormal, MeleeKnockbackImpulse, MeleeLaunchImpulse);
+
+			// pass the damage event to the actor
+			Candidate.Damageable->ApplyDamage(MeleeDamage, this, Candidate.ImpactPoint, Impulse);
+
+			// call the BP handler to play effects, etc.
+			DealtDamage(MeleeDamage, Candidate.ImpactPoint);
+		}
+	}
+
+	// sweep for objects in front of the character to be hit by the attack
+	TArray<FHitResult> OutHits;
+
+	// check for world dynamic collision object types, and pawns if the target grid didn't handle them. This catches damageables that aren't on the grid
 	FCollisionObjectQueryParams ObjectParams;
-	ObjectParams.AddObjectTypesToQuery(ECC_Pawn);
 	ObjectParams.AddObjectTypesToQuery(ECC_WorldDynamic);
 
+	if (!TargetGrid)
+	{
+		ObjectParams.AddObjectTypesToQuery(ECC_Pawn);
+	}
+
 	// use a sphere shape for the sweep
 	FCollisionShape CollisionShape;
 	CollisionShape.SetSphere(MeleeTraceRadius);
@@ -262,18 +605,35 @@ void ACombatCharacter::DoAttackTrace(FName DamageSourceBone)
 	FCollisionQueryParams QueryParams;
 	QueryParams.AddIgnoredActor(this);
 
+	// resting boxes only collide through their instances, which are owned by the instance subsystem instead of the box
+	const UCombatBoxInstanceSubsystem* BoxInstances = GetWorld()->GetSubsystem<UCombatBoxInstanceSubsystem>();
+
 	if (GetWorld()->SweepMultiByObjectType(OutHits, TraceStart, TraceEnd, FQuat::Identity, ObjectParams, CollisionShape, QueryParams))
 	{
 		// iterate over each object hit
 		for (const FHitResult& CurrentHit : OutHits)
 		{
+			// resolve instance hits back to the box they draw
+			AActor* HitActor = CurrentHit.GetActor();
+
+			if (ACombatDamageableBox* InstancedBox = BoxInstances ? BoxInstances->GetBoxForInstance(Cast<UInstancedStaticMeshComponent>(CurrentHit.GetComponent()), CurrentHit.Item) : nullptr)
+			{
+				HitActor = InstancedBox;
+			}
+
+			// skip anything the target grid already handled, so it isn't damaged twice
+			if (TargetGrid && TargetGrid->IsTargetRegistered(HitActor))
+			{
+				continue;
+			}
+
 			// check if we've hit a damageable actor
-			ICombatDamageable* Damageable = Cast<ICombatDamageable>(CurrentHit.GetActor());
+			ICombatDamageable* Damageable = Cast<ICombatDamageable>(HitActor);
 
 			if (Damageable)
 			{
 				// knock upwards and away from the impact normal
-				const FVector Impulse = (CurrentHit.ImpactNormal * -MeleeKnockbackImpulse) + (FVector::UpVector * MeleeLaunchImpulse);
+				const FVector Impulse = FCombatRules::ComputeKnockback(CurrentHit.ImpactNormal, MeleeKnockbackImpulse, MeleeLaunchImpulse);
 
 				// pass the damage event to the actor
 				Damageable->ApplyDamage(MeleeDamage, this, CurrentHit.ImpactPoint, Impulse);
@@ -287,11 +647,17 @@ void ACombatCharacter::DoAttackTrace(FName DamageSourceBone)
 
 void ACombatCharacter::CheckCombo()
 {
+	// simulated proxies follow the server's section changes instead
+	if (!RunsAttackLogic())
+	{
+		return;
+	}
+
 	// are we playing a non-charge attack animation?
 	if (bIsAttacking && !bIsChargingAttack)
 	{
 		// is the last attack input not stale?
-		if (GetWorld()->GetTimeSeconds() - CachedAttackInputTime <= ComboInputCacheTimeTolerance)
+		if (GetAttackInputTime() - CachedAttackInputTime <= ComboInputCacheTimeTolerance)
 		{
 			// consume the attack input so we don't accidentally trigger it twice
 			CachedAttackInputTime = 0.0f;
@@ -307,6 +673,12 @@ void ACombatCharacter::CheckCombo()
 				{
 					AnimInstance->Montage_JumpToSection(ComboSectionNames[ComboCount], ComboAttackMontage);
 				}
+
+				// show the next attack to the other clients
+				if (HasAuthority())
+				{
+					MulticastAttackMontage(ComboAttackMontage, ComboSectionNames[ComboCount]);
+				}
 			}
 		}
 	}
@@ -314,13 +686,27 @@ void ACombatCharacter::CheckCombo()
 
 void ACombatCharacter::CheckChargedAttack()
 {
+	// simulated proxies follow the server's section changes instead
+	if (!RunsAttackLogic())
+	{
+		return;
+	}
+
 	// raise the looped charged attack flag
 	bHasLoopedChargedAttack = true;
 
 	// jump to either the loop or the attack section depending on whether we're still holding the charge button
+	const FName Section = bIsChargingAttack ? ChargeLoopSection : ChargeAttackSection;
+
 	if (UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance())
 	{
-		AnimInstance->Montage_JumpToSection(bIsChargingAttack ? ChargeLoopSection : ChargeAttackSection, ChargedAttackMontage);
+		AnimInstance->Montage_JumpToSection(Section, ChargedAttackMontage);
+	}
+
+	// show the section change to the other clients
+	if (HasAuthority())
+	{
+		MulticastAttackMontage(ChargedAttackMontage, Section);
 	}
 }
 
@@ -333,38 +719,61 @@ void ACombatCharacter::ApplyDamage(float Damage, AActor* DamageCauser, const FVe
 	// only process knockback and effects if we received nonzero damage
 	if (ActualDamage > 0.0f)
 	{
-		// apply the knockback impulse
+		// apply the knockback impulse. Character movement replicates the result
 		GetCharacterMovement()->AddImpulse(DamageImpulse, true);
 
-		// is the character ragdolling?
-		if (GetMesh()->IsSimulatingPhysics())
-		{
-			// apply an impulse to the ragdoll
-			GetMesh()->AddImpulseAtLocation(DamageImpulse * GetMesh()->GetMass(), DamageLocation);
-		}
-
-		// pass control to BP to play effects, etc.
-		ReceivedDamage(ActualDamage, DamageLocation, DamageImpulse.GetSafeNormal());
+		// play the hit reaction and effects on every machine
+		MulticastDamageEffects(ActualDamage, DamageLocation, DamageImpulse, FCombatRules::IsDead(CurrentHP));
 	}
 
 }
 
 void ACombatCharacter::HandleDeath()
 {
+	// stop any hit reaction in progress
+	HitReaction->StopHitReaction();
+
 	// disable movement while we're dead
 	GetCharacterMovement()->DisableMovement();
 
-	// enable full ragdoll physics
-	GetMesh()->SetSimulatePhysics(true);
+	// enable full ragdoll physics if the budget allows it
+	if (UCombatRagdollSubsystem* Ragdolls = GetWorld()->GetSubsystem<UCombatRagdollSubsystem>())
+	{
+		Ragdolls->RequestRagdoll(GetMesh(), RagdollSignificance, DeathMontage);
+	}
+	else
+	{
+		GetMesh()->SetSimulatePhysics(true);
+	}
+
+	// apply the impulse of a lethal hit that arrived before the death state
+	if (!PendingDeathImpulse.IsZero())
+	{
+		if (GetMesh()->IsSimulatingPhysics())
+		{
+			GetMesh()->AddImpulseAtLocation(PendingDeathImpulse * GetMesh()->GetMass(), PendingDeathImpulseLocation);
+		}
+
+		PendingDeathImpulse = FVector::ZeroVector;
+	}
 
 	// hide the life bar
-	LifeBar->SetHiddenInGame(true);
+	LifeBar->SetBarVisible(false);
+
+	// remove ourselves from the combat target grid
+	if (UCombatTargetGridSubsystem* TargetGrid = GetWorld()->GetSubsystem<UCombatTargetGridSubsystem>())
+	{
+		TargetGrid->UnregisterTarget(this);
+	}
 
 	// pull back the camera
 	GetCameraBoom()->TargetArmLength = DeathCameraDistance;
 
-	// schedule respawning
-	GetWorld()->GetTimerManager().SetTimer(RespawnTimer, this, &ACombatCharacter::RespawnCharacter, RespawnTime, false);
+	// schedule respawning. Clients run this from the HP rep notify, but only the server respawns
+	if (HasAuthority())
+	{
+		GetWorld()->GetTimerManager().SetTimer(RespawnTimer, this, &ACombatCharacter::RespawnCharacter, RespawnTime, false);
+	}
 }
 
 void ACombatCharacter::ApplyHealing(float Healing, AActor* Healer)
@@ -380,17 +789,18 @@ void ACombatCharacter::RespawnCharacter()
 
 float ACombatCharacter::TakeDamage(float Damage, struct FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser)
 {
-	// only process damage if the character is still alive
-	if (CurrentHP <= 0.0f)
+	// reduce the current HP. This does nothing if we're already dead
+	const float AppliedDamage = FCombatRules::ApplyDamage(CurrentHP, Damage);
+
+	if (AppliedDamage <= 0.0f)
 	{
 		return 0.0f;
 	}
 
-	// reduce the current HP
-	CurrentHP -= Damage;
+	MARK_PROPERTY_DIRTY_FROM_NAME(ACombatCharacter, CurrentHP, this);
 
 	// have we run out of HP?
-	if (CurrentHP <= 0.0f)
+	if (FCombatRules::IsDead(CurrentHP))
 	{
 		// die
 		HandleDeath();
@@ -398,26 +808,22 @@ float ACombatCharacter::TakeDamage(float Damage, struct FDamageEvent const& Dama
 	else
 	{
 		// update the life bar
-		LifeBarWidget->SetLifePercentage(CurrentHP / MaxHP);
-
-		// enable partial ragdoll physics, but keep the pelvis vertical
-		GetMesh()->SetPhysicsBlendWeight(0.5f);
-		GetMesh()->SetBodySimulatePhysics(PelvisBoneName, false);
+		LifeBar->SetLifePercentage(CurrentHP / MaxHP);
 	}
 
 	// return the received damage amount
-	return Damage;
+	return AppliedDamage;
 }
 
 void ACombatCharacter::Landed(const FHitResult& Hit)
 {
 	Super::Landed(Hit);
 
-	// is the character still alive?
-	if (CurrentHP >= 0.0f)
+	// is the character still alive and reacting to a hit with physics?
+	if (CurrentHP >= 0.0f && HitReaction->IsPhysicalReactionActive())
 	{
 		// disable ragdoll physics
-		GetMesh()->SetPhysicsBlendWeight(0.0f);
+		HitReaction->ResetPhysicalReaction();
 	}
 }
 
@@ -425,10 +831,6 @@ void ACombatCharacter::BeginPlay()
 {
 	Super::BeginPlay();
 
-	// get the life bar from the widget component
-	LifeBarWidget = Cast<UCombatLifeBar>(LifeBar->GetUserWidgetObject());
-	check(LifeBarWidget);
-
 	// initialize the camera
 	GetCameraBoom()->TargetArmLength = DefaultCameraDistance;
 
@@ -436,10 +838,23 @@ void ACombatCharacter::BeginPlay()
 	MeshStartingTransform = GetMesh()->GetRelativeTransform();
 
 	// set the life bar color
-	LifeBarWidget->SetBarColor(LifeBarColor);
+	LifeBar->SetBarColor(LifeBarColor);
+
+	// reset HP to maximum. Clients already received their HP from the server
+	if (HasAuthority())
+	{
+		ResetHP();
+	}
+	else
+	{
+		LifeBar->SetLifePercentage(CurrentHP / MaxHP);
+	}
 
-	// reset HP to maximum
-	ResetHP();
+	// register with the combat target grid so attacks can find us
+	if (UCombatTargetGridSubsystem* TargetGrid = GetWorld()->GetSubsystem<UCombatTargetGridSubsystem>())
+	{
+		TargetGrid->RegisterTarget(this, GetCapsuleComponent(), ECombatTargetType::Pawn);
+	}
 }
 
 void ACombatCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
@@ -448,6 +863,29 @@ void ACombatCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
 
 	// clear the respawn timer
 	GetWorld()->GetTimerManager().ClearTimer(RespawnTimer);
+
+	// remove ourselves from the combat target grid
+	if (UCombatTargetGridSubsystem* TargetGrid = GetWorld()->GetSubsystem<UCombatTargetGridSubsystem>())
+	{
+		TargetGrid->UnregisterTarget(this);
+	}
+
+	// free up our ragdoll budget slot
+	if (UCombatRagdollSubsystem* Ragdolls = GetWorld()->GetSubsystem<UCombatRagdollSubsystem>())
+	{
+		Ragdolls->ReleaseRagdoll(GetMesh());
+	}
+}
+
+void ACombatCharacter::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	// HP rarely changes, so only compare it when it's been marked dirty
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+
+	DOREPLIFETIME_WITH_PARAMS_FAST(ACombatCharacter, CurrentHP, Params);
 }
 
 void ACombatCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
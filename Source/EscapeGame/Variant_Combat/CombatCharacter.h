@@ -7,14 +7,16 @@
 #include "CombatAttacker.h"
 #include "CombatDamageable.h"
 #include "Animation/AnimInstance.h"
+#include "Engine/NetSerialization.h"
 #include "CombatCharacter.generated.h"
 
 class USpringArmComponent;
 class UCameraComponent;
 class UInputAction;
 struct FInputActionValue;
-class UCombatLifeBar;
-class UWidgetComponent;
+class UCombatHitReactionComponent;
+class UCombatLifeBarComponent;
+class UCombatHurtboxHistoryComponent;
 
 DECLARE_LOG_CATEGORY_EXTERN(LogCombatCharacter, Log, All);
 
@@ -41,7 +43,15 @@ class ACombatCharacter : public ACharacter, public ICombatAttacker, public IComb
 
 	/** Life bar widget component */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Components", meta = (AllowPrivateAccess = "true"))
-	UWidgetComponent* LifeBar;
+	UCombatLifeBarComponent* LifeBar;
+
+	/** Hit reaction component */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Components", meta = (AllowPrivateAccess = "true"))
+	UCombatHitReactionComponent* HitReaction;
+
+	/** Hurtbox history component, used by the server to validate attacks with lag compensation */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Components", meta = (AllowPrivateAccess = "true"))
+	UCombatHurtboxHistoryComponent* HurtboxHistory;
 	
 protected:
 
@@ -73,8 +83,8 @@ protected:
 	UPROPERTY(EditAnywhere, Category="Damage", meta = (ClampMin = 0, ClampMax = 100))
 	float MaxHP = 5.0f;
 
-	/** Current amount of HP the character has */
-	UPROPERTY(VisibleAnywhere, Category="Damage")
+	/** Current amount of HP the character has. Server authoritative, replicated through the push model */
+	UPROPERTY(VisibleAnywhere, ReplicatedUsing=OnRep_CurrentHP, Category="Damage")
 	float CurrentHP = 0.0f;
 
 	/** Life bar widget fill color */
@@ -85,17 +95,17 @@ protected:
 	UPROPERTY(EditAnywhere, Category="Damage")
 	FName PelvisBoneName;
 
-	/** Pointer to the life bar widget */
-	UPROPERTY(EditAnywhere, Category="Damage")
-	TObjectPtr<UCombatLifeBar> LifeBarWidget;
-
 	/** Max amount of time that may elapse for a non-combo attack input to not be considered stale */
 	UPROPERTY(EditAnywhere, Category="Melee Attack", meta = (ClampMin = 0, ClampMax = 5, Units = "s"))
 	float AttackInputCacheTimeTolerance = 1.0f;
 
-	/** Time at which an attack button was last pressed */
+	/** Time at which an attack button was last pressed, in synchronized server time */
 	float CachedAttackInputTime = 0.0f;
 
+	/** Max difference between a client's attack input timestamp and the server's clock before the input is rejected */
+	UPROPERTY(EditAnywhere, Category="Melee Attack|Network", meta = (ClampMin = 0, ClampMax = 2, Units = "s"))
+	float MaxAttackInputTimeDiscrepancy = 0.5f;
+
 	/** If true, the character is currently playing an attack animation */
 	bool bIsAttacking = false;
 
@@ -164,12 +174,26 @@ protected:
 	UPROPERTY(EditAnywhere, Category="Respawn", meta = (ClampMin = 0, ClampMax = 10, Units = "s"))
 	float RespawnTime = 3.0f;
 
+	/** Importance of this character's death ragdoll when the ragdoll budget is full */
+	UPROPERTY(EditAnywhere, Category="Respawn", meta = (ClampMin = 0, ClampMax = 10))
+	float RagdollSignificance = 10.0f;
+
+	/** Optional AnimMontage to play on death when the ragdoll budget is full. Should not auto blend out */
+	UPROPERTY(EditAnywhere, Category="Respawn")
+	UAnimMontage* DeathMontage;
+
 	/** Attack montage ended delegate */
 	FOnMontageEnded OnAttackMontageEnded;
 
 	/** Character respawn timer */
 	FTimerHandle RespawnTimer;
 
+	/** Impulse of a lethal hit that arrived before the death state, applied once the ragdoll starts */
+	FVector PendingDeathImpulse = FVector::ZeroVector;
+
+	/** Location of the pending death impulse */
+	FVector PendingDeathImpulseLocation = FVector::ZeroVector;
+
 	/** Copy of the mesh's transform so we can reset it after ragdoll animations */
 	FTransform MeshStartingTransform;
 
@@ -235,6 +259,59 @@ protected:
 	/** Called from a delegate when the attack montage ends */
 	void AttackMontageEnded(UAnimMontage* Montage, bool bInterrupted);
 
+	/** Runs a combo attack input. Returns true if it started a new attack */
+	bool HandleComboAttackInput(float InputTime);
+
+	/** Runs a charged attack press input. Returns true if it started a new attack */
+	bool HandleChargedAttackInput(float InputTime);
+
+	/** Returns the current time, synchronized with the server so client and server input timestamps can be compared */
+	float GetAttackInputTime() const;
+
+	/** Returns true if a client's input timestamp is close enough to the server's clock to be trusted */
+	bool IsValidAttackInputTime(float InputTime) const;
+
+	/** Plays an attack montage from the provided section, unless it's already playing it */
+	void PlayAttackMontage(UAnimMontage* Montage, FName Section);
+
+	/** Sends the server's attack montage state to the owning client so it can correct a misprediction */
+	void ReconcileAttack();
+
+	/** Returns true if this character's attack logic runs here, instead of following the server */
+	bool RunsAttackLogic() const;
+
+	/** Returns the server time at which the controlling client saw the targets of an attack happening now */
+	double GetHitValidationTime() const;
+
+protected:
+
+	/** Sends a predicted combo attack input to the server */
+	UFUNCTION(Server, Reliable)
+	void ServerComboAttackStart(float InputTime, bool bPredictedAttack);
+
+	/** Sends a predicted charged attack press to the server */
+	UFUNCTION(Server, Reliable)
+	void ServerChargedAttackStart(float InputTime, bool bPredictedAttack);
+
+	/** Sends a charged attack release to the server */
+	UFUNCTION(Server, Reliable)
+	void ServerChargedAttackEnd();
+
+	/** Overrides the owning client's predicted attack with the server's. A null montage means the server isn't attacking */
+	UFUNCTION(Client, Reliable)
+	void ClientReconcileAttack(UAnimMontage* Montage, FName Section);
+
+	/** Plays an attack montage section on remote machines */
+	UFUNCTION(NetMulticast, Unreliable)
+	void MulticastAttackMontage(UAnimMontage* Montage, FName Section);
+
+	/** Plays damage reaction effects on every machine. bLethal comes from the server, since clients may not have received the death state yet */
+	UFUNCTION(NetMulticast, Unreliable)
+	void MulticastDamageEffects(float Damage, FVector_NetQuantize DamageLocation, FVector_NetQuantize10 DamageImpulse, bool bLethal);
+
+	/** Updates the life bar and handles death on clients */
+	UFUNCTION()
+	void OnRep_CurrentHP(float PreviousHP);
 	
 public:
 
@@ -272,7 +349,7 @@ public:
 	/** Overrides the default TakeDamage functionality */
 	virtual float TakeDamage(float Damage, struct FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser) override;
 
-	/** Overrides landing to reset damage ragdoll physics */
+	/** Overrides landing to reset physical hit reactions */
 	virtual void Landed(const FHitResult& Hit) override;
 
 protected:
@@ -293,6 +370,9 @@ protected:
 	/** Cleanup */
 	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
+	/** Sets up replicated properties */
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
 	/** Handles input bindings */
 	virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
 
@@ -306,4 +386,13 @@ public:
 
 	/** Returns FollowCamera subobject **/
 	FORCEINLINE class UCameraComponent* GetFollowCamera() const { return FollowCamera; }
+
+	/** Returns the max HP the character respawns with */
+	FORCEINLINE float GetMaxHP() const { return MaxHP; }
+
+	/** Returns the damage dealt by each melee hit */
+	FORCEINLINE float GetMeleeDamage() const { return MeleeDamage; }
+
+	/** Returns the number of stages in the combo attack */
+	FORCEINLINE int32 GetNumComboSections() const { return ComboSectionNames.Num(); }
 };
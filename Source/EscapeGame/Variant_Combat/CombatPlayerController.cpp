@@ -12,6 +12,8 @@
 #include "Blueprint/UserWidget.h"
 #include "EscapeGame.h"
 #include "Widgets/Input/SVirtualJoystick.h"
+#include "CombatLifeBarLayer.h"
+#include "CombatLifeBarSubsystem.h"
 
 void ACombatPlayerController::BeginPlay()
 {
@@ -35,6 +37,21 @@ void ACombatPlayerController::BeginPlay()
 		}
 
 	}
+
+	// only spawn the life bar layer on local player controllers, and only if the bars are batched
+	const UCombatLifeBarSubsystem* LifeBars = GetWorld()->GetSubsystem<UCombatLifeBarSubsystem>();
+
+	if (IsLocalPlayerController() && LifeBars && LifeBars->IsBatchingEnabled())
+	{
+		// fall back to the native layer if no class was set
+		LifeBarLayer = CreateWidget<UCombatLifeBarLayer>(this, LifeBarLayerClass ? LifeBarLayerClass.Get() : UCombatLifeBarLayer::StaticClass());
+
+		if (LifeBarLayer)
+		{
+			// add the layer below the rest of the player's UI
+			LifeBarLayer->AddToPlayerScreen(-1);
+		}
+	}
 }
 
 void ACombatPlayerController::SetupInputComponent()
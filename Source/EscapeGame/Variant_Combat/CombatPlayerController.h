@@ -8,11 +8,13 @@
 
 class UInputMappingContext;
 class ACombatCharacter;
+class UCombatLifeBarLayer;
 
 /**
  *  Simple Player Controller for a third person combat game
  *  Manages input mappings
  *  Respawns the player character at the checkpoint when it's destroyed
+ *  Draws the batched life bars HUD layer
  */
 UCLASS(abstract)
 class ACombatPlayerController : public APlayerController
@@ -36,6 +38,14 @@ protected:
 	/** Pointer to the mobile controls widget */
 	TObjectPtr<UUserWidget> MobileControlsWidget;
 
+	/** Life bar layer widget to spawn when life bars are batched */
+	UPROPERTY(EditAnywhere, Category="UI")
+	TSubclassOf<UCombatLifeBarLayer> LifeBarLayerClass;
+
+	/** Pointer to the life bar layer widget */
+	UPROPERTY()
+	TObjectPtr<UCombatLifeBarLayer> LifeBarLayer;
+
 	/** Character class to respawn when the possessed pawn is destroyed */
 	UPROPERTY(EditAnywhere, Category="Respawn")
 	TSubclassOf<ACombatCharacter> CharacterClass;
@@ -10,6 +10,10 @@ ACombatActivationVolume::ACombatActivationVolume()
 {
 	PrimaryActorTick.bCanEverTick = false;
 
+	// replicate, but stay dormant until we're activated
+	bReplicates = true;
+	NetDormancy = DORM_Initial;
+
 	// create the box volume
 	RootComponent = Box = CreateDefaultSubobject<UBoxComponent>(TEXT("Box"));
 	check(Box);
@@ -22,10 +26,36 @@ ACombatActivationVolume::ACombatActivationVolume()
 
 	// bind the begin overlap 
 	Box->OnComponentBeginOverlap.AddDynamic(this, &ACombatActivationVolume::OnOverlap);
+
+	// create the preparation box volume
+	PrepareBox = CreateDefaultSubobject<UBoxComponent>(TEXT("Prepare Box"));
+	PrepareBox->SetupAttachment(Box);
+
+	// only overlap pawns
+	PrepareBox->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+	PrepareBox->SetCollisionResponseToAllChannels(ECR_Ignore);
+	PrepareBox->SetCollisionResponseToChannel(ECC_Pawn, ECR_Overlap);
+
+	// bind the begin overlap
+	PrepareBox->OnComponentBeginOverlap.AddDynamic(this, &ACombatActivationVolume::OnPrepareOverlap);
+}
+
+void ACombatActivationVolume::OnConstruction(const FTransform& Transform)
+{
+	Super::OnConstruction(Transform);
+
+	// grow the preparation box around the activation box
+	PrepareBox->SetBoxExtent(Box->GetUnscaledBoxExtent() + FVector(PrepareDistance));
 }
 
 void ACombatActivationVolume::OnOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
 {
+	// only the server activates actors. Clients get the results through replication
+	if (!HasAuthority())
+	{
+		return;
+	}
+
 	// has a Character entered the volume?
 	ACharacter* PlayerCharacter = Cast<ACharacter>(OtherActor);
 
@@ -34,6 +64,9 @@ void ACombatActivationVolume::OnOverlap(UPrimitiveComponent* OverlappedComponent
 		// is the Character controlled by a player
 		if (PlayerCharacter->IsPlayerControlled())
 		{
+			// wake up so clients receive any state the activation changes
+			FlushNetDormancy();
+
 			// process the actors to activate list
 			for (AActor* CurrentActor : ActorsToActivate)
 			{
@@ -46,4 +79,29 @@ void ACombatActivationVolume::OnOverlap(UPrimitiveComponent* OverlappedComponent
 		}
 	}
 
-}
\ No newline at end of file
+}
+
+void ACombatActivationVolume::OnPrepareOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+{
+	// only the server prepares actors, since it's the one activating them
+	if (!HasAuthority())
+	{
+		return;
+	}
+
+	// has a player controlled Character entered the volume?
+	ACharacter* PlayerCharacter = Cast<ACharacter>(OtherActor);
+
+	if (PlayerCharacter && PlayerCharacter->IsPlayerControlled())
+	{
+		// process the actors to activate list
+		for (AActor* CurrentActor : ActorsToActivate)
+		{
+			// is the referenced actor activatable?
+			if (ICombatActivatable* Activatable = Cast<ICombatActivatable>(CurrentActor))
+			{
+				Activatable->PrepareInteraction(PlayerCharacter);
+			}
+		}
+	}
+}
@@ -10,6 +10,8 @@ class UBoxComponent;
 
 /**
  *  A simple volume that activates a list of actors when the player pawn enters.
+ *  A larger surrounding volume lets the actors prepare for activation ahead of time
+ *  The volume is net dormant, and only wakes when it activates its actors
  */
 UCLASS()
 class ACombatActivationVolume : public AActor
@@ -19,6 +21,10 @@ class ACombatActivationVolume : public AActor
 	/** Collision box volume */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category ="Components", meta = (AllowPrivateAccess = "true"))
 	UBoxComponent* Box;
+
+	/** Preparation box volume, surrounding the activation box */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category ="Components", meta = (AllowPrivateAccess = "true"))
+	UBoxComponent* PrepareBox;
 	
 protected:
 
@@ -26,15 +32,26 @@ protected:
 	UPROPERTY(EditAnywhere, Category="Activation Volume")
 	TArray<AActor*> ActorsToActivate;
 
+	/** Distance around the activation box at which the actors will be told to prepare for activation */
+	UPROPERTY(EditAnywhere, Category="Activation Volume", meta = (ClampMin = 0, ClampMax = 10000, Units = "cm"))
+	float PrepareDistance = 1500.0f;
+
 public:	
 	
 	/** Constructor */
 	ACombatActivationVolume();
 
+	/** Sizes the preparation box around the activation box */
+	virtual void OnConstruction(const FTransform& Transform) override;
+
 protected:
 
 	/** Handles overlaps with the box volume */
 	UFUNCTION()
 	void OnOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
 
+	/** Handles overlaps with the preparation box volume */
+	UFUNCTION()
+	void OnPrepareOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
+
 };
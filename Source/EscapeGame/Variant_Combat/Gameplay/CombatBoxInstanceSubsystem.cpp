@@ -0,0 +1,231 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatBoxInstanceSubsystem.h"
+#include "CombatDamageableBox.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "TimerManager.h"
+
+bool UCombatBoxInstanceSubsystem::AddInstance(ACombatDamageableBox* Box, const UStaticMeshComponent* BoxMesh)
+{
+	// ignore repeated demotions
+	if (!IsValid(Box) || !IsValid(BoxMesh) || BoxHandles.Contains(Box))
+	{
+		return false;
+	}
+
+	const int32 GroupIndex = FindOrAddGroup(BoxMesh);
+
+	if (GroupIndex == INDEX_NONE)
+	{
+		return false;
+	}
+
+	// add an instance where the box's mesh is
+	FCombatBoxInstanceGroup& Group = Groups[GroupIndex];
+
+	FCombatBoxInstanceHandle& Handle = BoxHandles.Add(Box);
+	Handle.Group = GroupIndex;
+	Handle.Instance = Group.Instances->AddInstance(BoxMesh->GetComponentTransform(), true);
+
+	Group.Boxes.Add(Box);
+	check(Group.Boxes.Num() == Group.Instances->GetInstanceCount());
+
+	return true;
+}
+
+void UCombatBoxInstanceSubsystem::RemoveInstance(const ACombatDamageableBox* Box)
+{
+	FCombatBoxInstanceHandle Handle;
+
+	if (!BoxHandles.RemoveAndCopyValue(Box, Handle))
+	{
+		return;
+	}
+
+	FCombatBoxInstanceGroup& Group = Groups[Handle.Group];
+
+	// instances are removed by swapping the last one into the slot, so mirror that and fix up the moved box's handle
+	Group.Instances->RemoveInstance(Handle.Instance);
+	Group.Boxes.RemoveAtSwap(Handle.Instance, EAllowShrinking::No);
+
+	if (Group.Boxes.IsValidIndex(Handle.Instance))
+	{
+		BoxHandles.FindChecked(Group.Boxes[Handle.Instance]).Instance = Handle.Instance;
+	}
+}
+
+bool UCombatBoxInstanceSubsystem::HasInstance(const ACombatDamageableBox* Box) const
+{
+	return BoxHandles.Contains(Box);
+}
+
+ACombatDamageableBox* UCombatBoxInstanceSubsystem::GetBoxForInstance(const UInstancedStaticMeshComponent* Instances, int32 Item) const
+{
+	if (!Instances)
+	{
+		return nullptr;
+	}
+
+	const FCombatBoxInstanceGroup* Group = Groups.FindByPredicate([Instances](const FCombatBoxInstanceGroup& Candidate) { return Candidate.Instances == Instances; });
+
+	if (!Group || !Group->Boxes.IsValidIndex(Item) || !IsValid(Group->Boxes[Item]))
+	{
+		return nullptr;
+	}
+
+	return Group->Boxes[Item];
+}
+
+void UCombatBoxInstanceSubsystem::GetBoxesAbove(const FBox& Bounds, TArray<ACombatDamageableBox*>& OutBoxes) const
+{
+	// query a thin slab at the top of the bounds. Inset it on the sides so boxes resting next to this one aren't included
+	const FBox QueryBox(
+		FVector(Bounds.Min.X + StackTolerance, Bounds.Min.Y + StackTolerance, Bounds.Max.Z - StackTolerance),
+		FVector(Bounds.Max.X - StackTolerance, Bounds.Max.Y - StackTolerance, Bounds.Max.Z + StackTolerance));
+
+	for (const FCombatBoxInstanceGroup& Group : Groups)
+	{
+		for (const int32 InstanceIndex : Group.Instances->GetInstancesOverlappingBox(QueryBox))
+		{
+			if (Group.Boxes.IsValidIndex(InstanceIndex) && IsValid(Group.Boxes[InstanceIndex]))
+			{
+				OutBoxes.Add(Group.Boxes[InstanceIndex]);
+			}
+		}
+	}
+}
+
+void UCombatBoxInstanceSubsystem::Deinitialize()
+{
+	// the owner actor is destroyed with the world
+	InstanceOwner = nullptr;
+	Groups.Empty();
+	BoxHandles.Empty();
+
+	Super::Deinitialize();
+}
+
+int32 UCombatBoxInstanceSubsystem::FindOrAddGroup(const UStaticMeshComponent* BoxMesh)
+{
+	UStaticMesh* Mesh = BoxMesh->GetStaticMesh();
+
+	if (!Mesh)
+	{
+		return INDEX_NONE;
+	}
+
+	const TArray<UMaterialInterface*> Materials = BoxMesh->GetMaterials();
+
+	// reuse a group with the same look
+	const int32 ExistingGroup = Groups.IndexOfByPredicate([Mesh, &Materials](const FCombatBoxInstanceGroup& Group)
+	{
+		return Group.Mesh == Mesh && Group.Materials == Materials;
+	});
+
+	if (ExistingGroup != INDEX_NONE)
+	{
+		return ExistingGroup;
+	}
+
+	// spawn the actor that will own all of our instances
+	if (!IsValid(InstanceOwner))
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.ObjectFlags |= RF_Transient;
+
+		InstanceOwner = GetWorld()->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParams);
+	}
+
+	// create the instanced mesh, matching the box's look and collision
+	UInstancedStaticMeshComponent* Instances = NewObject<UInstancedStaticMeshComponent>(InstanceOwner);
+	Instances->SetMobility(EComponentMobility::Movable);
+	Instances->SetStaticMesh(Mesh);
+
+	for (int32 i = 0; i < Materials.Num(); ++i)
+	{
+		Instances->SetMaterial(i, Materials[i]);
+	}
+
+	Instances->SetCollisionProfileName(BoxMesh->GetCollisionProfileName());
+	Instances->SetCastShadow(BoxMesh->CastShadow);
+	Instances->bNavigationRelevant = false;
+
+	// removal swaps the last instance in, so the other indices stay stable
+	Instances->bSupportRemoveAtSwap = true;
+
+	// report hits so boxes can be pushed out of their instances
+	Instances->SetNotifyRigidBodyCollision(true);
+	Instances->OnComponentHit.AddDynamic(this, &UCombatBoxInstanceSubsystem::OnInstanceHit);
+
+	InstanceOwner->AddInstanceComponent(Instances);
+	Instances->RegisterComponent();
+
+	FCombatBoxInstanceGroup& NewGroup = Groups.AddDefaulted_GetRef();
+	NewGroup.Mesh = Mesh;
+	NewGroup.Materials = Materials;
+	NewGroup.Instances = Instances;
+
+	return Groups.Num() - 1;
+}
+
+void UCombatBoxInstanceSubsystem::OnInstanceHit(UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit)
+{
+	// ignore gentle contact, like something resting against the box
+	if (!OtherComp || OtherComp->GetComponentVelocity().SizeSquared() < FMath::Square(MinPushSpeed))
+	{
+		return;
+	}
+
+	const FCombatBoxInstanceGroup* Group = Groups.FindByPredicate([HitComponent](const FCombatBoxInstanceGroup& Candidate) { return Candidate.Instances == HitComponent; });
+
+	if (!Group)
+	{
+		return;
+	}
+
+	// the hit reports our instance index, but fall back to the closest instance if it doesn't
+	int32 InstanceIndex = Hit.MyItem;
+
+	if (!Group->Boxes.IsValidIndex(InstanceIndex))
+	{
+		InstanceIndex = FindClosestInstance(Group->Instances, Hit.ImpactPoint);
+	}
+
+	// only the server promotes boxes. Clients follow through replication
+	ACombatDamageableBox* Box = Group->Boxes.IsValidIndex(InstanceIndex) ? Group->Boxes[InstanceIndex] : nullptr;
+
+	if (IsValid(Box) && Box->HasAuthority())
+	{
+		// we're in the middle of the instanced component's hit dispatch, so wait until next tick to remove the instance
+		GetWorld()->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateWeakLambda(Box, [Box]()
+		{
+			Box->Promote();
+		}));
+	}
+}
+
+int32 UCombatBoxInstanceSubsystem::FindClosestInstance(const UInstancedStaticMeshComponent* Instances, const FVector& Location)
+{
+	int32 ClosestIndex = INDEX_NONE;
+	double ClosestDistSquared = TNumericLimits<double>::Max();
+
+	for (int32 i = 0; i < Instances->GetInstanceCount(); ++i)
+	{
+		FTransform InstanceTransform;
+		Instances->GetInstanceTransform(i, InstanceTransform, true);
+
+		const double DistSquared = FVector::DistSquared(InstanceTransform.GetLocation(), Location);
+
+		if (DistSquared < ClosestDistSquared)
+		{
+			ClosestDistSquared = DistSquared;
+			ClosestIndex = i;
+		}
+	}
+
+	return ClosestIndex;
+}
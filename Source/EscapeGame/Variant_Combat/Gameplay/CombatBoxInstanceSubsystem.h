@@ -0,0 +1,116 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CombatBoxInstanceSubsystem.generated.h"
+
+class ACombatDamageableBox;
+class UInstancedStaticMeshComponent;
+class UStaticMeshComponent;
+class UStaticMesh;
+class UMaterialInterface;
+
+/** Instanced mesh drawing all resting boxes that share the same mesh and materials */
+USTRUCT()
+struct FCombatBoxInstanceGroup
+{
+	GENERATED_BODY()
+
+	/** Mesh shared by the group's boxes */
+	UPROPERTY()
+	UStaticMesh* Mesh = nullptr;
+
+	/** Materials shared by the group's boxes */
+	UPROPERTY()
+	TArray<UMaterialInterface*> Materials;
+
+	/** Component holding the instances */
+	UPROPERTY()
+	UInstancedStaticMeshComponent* Instances = nullptr;
+
+	/** Box represented by each instance, indexed the same as the instances */
+	UPROPERTY()
+	TArray<ACombatDamageableBox*> Boxes;
+};
+
+/** Location of a box's instance */
+struct FCombatBoxInstanceHandle
+{
+	/** Index of the instance group */
+	int32 Group = INDEX_NONE;
+
+	/** Index of the instance within the group */
+	int32 Instance = INDEX_NONE;
+};
+
+/**
+ *  Draws resting damageable boxes as instances of a shared static mesh, instead of as individual simulating bodies.
+ *  Boxes hand their mesh over to an instance when they demote, and take it back as a physics actor when they're hit or pushed.
+ *  Instances only have static collision, so hundreds of untouched boxes cost a handful of draw calls and no simulation.
+ */
+UCLASS(config=Game)
+class UCombatBoxInstanceSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Minimum speed something must hit an instance at to push the box out of it */
+	UPROPERTY(Config)
+	float MinPushSpeed = 50.0f;
+
+	/** Tolerance used when looking for instances stacked on top of a promoted box */
+	UPROPERTY(Config)
+	float StackTolerance = 2.0f;
+
+	/** Transient actor owning the instanced mesh components */
+	UPROPERTY(Transient)
+	AActor* InstanceOwner;
+
+	/** Instance groups, one per mesh and material combination */
+	UPROPERTY(Transient)
+	TArray<FCombatBoxInstanceGroup> Groups;
+
+	/** Instance currently representing each demoted box */
+	TMap<const ACombatDamageableBox*, FCombatBoxInstanceHandle> BoxHandles;
+
+public:
+
+	/** Adds an instance matching the box's mesh component. Returns true if the box is now drawn by an instance */
+	bool AddInstance(ACombatDamageableBox* Box, const UStaticMeshComponent* BoxMesh);
+
+	/** Removes the box's instance, if it has one */
+	void RemoveInstance(const ACombatDamageableBox* Box);
+
+	/** Returns true if the box is currently drawn by an instance */
+	bool HasInstance(const ACombatDamageableBox* Box) const;
+
+	/** Returns the box drawn by an instance, or nullptr if the component isn't one of ours. Lets traces that hit an instance damage its box */
+	ACombatDamageableBox* GetBoxForInstance(const UInstancedStaticMeshComponent* Instances, int32 Item) const;
+
+	/** Collects the boxes whose instances rest on top of the provided world bounds */
+	void GetBoxesAbove(const FBox& Bounds, TArray<ACombatDamageableBox*>& OutBoxes) const;
+
+public:
+
+	// ~begin UWorldSubsystem interface
+
+	/** Cleanup */
+	virtual void Deinitialize() override;
+
+	// ~end UWorldSubsystem interface
+
+protected:
+
+	/** Finds or creates the group for a mesh component's mesh and materials. Returns INDEX_NONE if the component has no mesh */
+	int32 FindOrAddGroup(const UStaticMeshComponent* BoxMesh);
+
+	/** Promotes the box whose instance was hit hard enough */
+	UFUNCTION()
+	void OnInstanceHit(UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit);
+
+	/** Returns the index of the instance closest to a world location */
+	static int32 FindClosestInstance(const UInstancedStaticMeshComponent* Instances, const FVector& Location);
+};
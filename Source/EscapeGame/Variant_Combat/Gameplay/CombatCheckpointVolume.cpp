@@ -4,9 +4,15 @@
 #include "CombatCheckpointVolume.h"
 #include "CombatCharacter.h"
 #include "CombatPlayerController.h"
+#include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
 
 ACombatCheckpointVolume::ACombatCheckpointVolume()
 {
+	// replicate, but stay dormant until we're used
+	bReplicates = true;
+	NetDormancy = DORM_Initial;
+
 	// create the box volume
 	RootComponent = Box = CreateDefaultSubobject<UBoxComponent>(TEXT("Box"));
 	check(Box);
@@ -23,8 +29,8 @@ ACombatCheckpointVolume::ACombatCheckpointVolume()
 
 void ACombatCheckpointVolume::OnOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
 {
-	// ensure we use this only once
-	if (bCheckpointUsed)
+	// ensure we use this only once, and only on the server
+	if (bCheckpointUsed || !HasAuthority())
 	{
 		return;
 	}
@@ -38,6 +44,10 @@ void ACombatCheckpointVolume::OnOverlap(UPrimitiveComponent* OverlappedComponent
 		{
 			// raise the checkpoint used flag
 			bCheckpointUsed = true;
+			MARK_PROPERTY_DIRTY_FROM_NAME(ACombatCheckpointVolume, bCheckpointUsed, this);
+
+			// wake up just long enough to send the new state
+			FlushNetDormancy();
 
 			// update the player's respawn checkpoint
 			PC->SetRespawnTransform(PlayerCharacter->GetActorTransform());
@@ -45,3 +55,14 @@ void ACombatCheckpointVolume::OnOverlap(UPrimitiveComponent* OverlappedComponent
 
 	}
 }
+
+void ACombatCheckpointVolume::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	// the used flag only changes once, so only compare it when it's been marked dirty
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+
+	DOREPLIFETIME_WITH_PARAMS_FAST(ACombatCheckpointVolume, bCheckpointUsed, Params);
+}
@@ -7,6 +7,10 @@
 #include "Components/BoxComponent.h"
 #include "CombatCheckpointVolume.generated.h"
 
+/**
+ *  A volume that updates the player's respawn point the first time they enter it.
+ *  The volume is net dormant, and only wakes to replicate its used state
+ */
 UCLASS(abstract)
 class ACombatCheckpointVolume : public AActor
 {
@@ -24,8 +28,16 @@ public:
 protected:
 
 	/** Set to true after use to avoid accidentally resetting the checkpoint */
+	UPROPERTY(Replicated)
 	bool bCheckpointUsed = false;
 
+public:
+
+	/** Sets up replicated properties */
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+protected:
+
 	/** Handles overlaps with the box volume */
 	UFUNCTION()
 	void OnOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
@@ -5,6 +5,11 @@
 #include "Components/StaticMeshComponent.h"
 #include "TimerManager.h"
 #include "Engine/World.h"
+#include "CombatTargetGridSubsystem.h"
+#include "CombatBoxInstanceSubsystem.h"
+#include "CombatDebrisSubsystem.h"
+#include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
 
 ACombatDamageableBox::ACombatDamageableBox()
 {
@@ -21,20 +26,70 @@ ACombatDamageableBox::ACombatDamageableBox()
 
 	// disable navigation relevance so boxes don't affect NavMesh generation
 	Mesh->bNavigationRelevant = false;
+
+	// report physics wake and sleep so we can manage net dormancy
+	Mesh->BodyInstance.bGenerateWakeEvents = true;
+
+	// replicate movement, but stay dormant until we're hit or pushed
+	bReplicates = true;
+	SetReplicatingMovement(true);
+	NetDormancy = DORM_Initial;
 }
 
-void ACombatDamageableBox::RemoveFromLevel()
+void ACombatDamageableBox::BeginPlay()
 {
-	// destroy this actor
-	Destroy();
+	Super::BeginPlay();
+
+	// save our initial scale for the debris fade
+	InitialScale = Mesh->GetRelativeScale3D();
+
+	// register with the combat target grid so attacks can find us
+	if (UCombatTargetGridSubsystem* TargetGrid = GetWorld()->GetSubsystem<UCombatTargetGridSubsystem>())
+	{
+		TargetGrid->RegisterTarget(this, Mesh, ECombatTargetType::Prop);
+	}
+
+	// only the server manages dormancy and instancing. We start out simulating, so we're only demoted once our body has settled
+	if (HasAuthority())
+	{
+		Mesh->OnComponentWake.AddDynamic(this, &ACombatDamageableBox::OnPhysicsWake);
+		Mesh->OnComponentSleep.AddDynamic(this, &ACombatDamageableBox::OnPhysicsSleep);
+	}
 }
 
 void ACombatDamageableBox::EndPlay(EEndPlayReason::Type EndPlayReason)
 {
 	Super::EndPlay(EndPlayReason);
 
-	// clear the death timer
-	GetWorld()->GetTimerManager().ClearTimer(DeathTimer);
+	// stop tracking us as debris
+	if (UCombatDebrisSubsystem* Debris = GetWorld()->GetSubsystem<UCombatDebrisSubsystem>())
+	{
+		Debris->RemoveDebris(this);
+	}
+
+	// remove ourselves from the combat target grid
+	if (UCombatTargetGridSubsystem* TargetGrid = GetWorld()->GetSubsystem<UCombatTargetGridSubsystem>())
+	{
+		TargetGrid->UnregisterTarget(this);
+	}
+
+	// release our instance
+	if (UCombatBoxInstanceSubsystem* BoxInstances = GetWorld()->GetSubsystem<UCombatBoxInstanceSubsystem>())
+	{
+		BoxInstances->RemoveInstance(this);
+	}
+}
+
+void ACombatDamageableBox::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	// the representation only changes on promotion and demotion, so only compare it when it's been marked dirty
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+
+	DOREPLIFETIME_WITH_PARAMS_FAST(ACombatDamageableBox, bInstanced, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(ACombatDamageableBox, bFadingOut, Params);
 }
 
 void ACombatDamageableBox::ApplyDamage(float Damage, AActor* DamageCauser, const FVector& DamageLocation, const FVector& DamageImpulse)
@@ -42,6 +97,12 @@ void ACombatDamageableBox::ApplyDamage(float Damage, AActor* DamageCauser, const
 	// only process damage if we still have HP
 	if (CurrentHP > 0.0f)
 	{
+		// wake up before changing state so clients see the hit
+		SetNetDormancy(DORM_Awake);
+
+		// make sure we're simulating so the impulse can move us
+		Promote();
+
 		// apply the damage
 		CurrentHP -= Damage;
 
@@ -64,11 +125,172 @@ void ACombatDamageableBox::HandleDeath()
 	// change the collision object type to Visibility so we ignore most interactions but still retain physics collisions
 	Mesh->SetCollisionObjectType(ECC_Visibility);
 
+	// remove ourselves from the combat target grid so we're no longer considered a target
+	if (UCombatTargetGridSubsystem* TargetGrid = GetWorld()->GetSubsystem<UCombatTargetGridSubsystem>())
+	{
+		TargetGrid->UnregisterTarget(this);
+	}
+
 	// call the BP handler to play effects, etc.
 	OnBoxDestroyed();
 
-	// set up the death cleanup timer
-	GetWorld()->GetTimerManager().SetTimer(DeathTimer, this, &ACombatDamageableBox::RemoveFromLevel, DeathDelayTime);
+	// let the debris subsystem fade us out and recycle us
+	if (UCombatDebrisSubsystem* Debris = GetWorld()->GetSubsystem<UCombatDebrisSubsystem>())
+	{
+		Debris->AddDebris(this, DeathDelayTime);
+		return;
+	}
+
+	// no debris subsystem, so just remove ourselves after the delay
+	SetLifeSpan(FMath::Max(DeathDelayTime, KINDA_SMALL_NUMBER));
+}
+
+void ACombatDamageableBox::OnPhysicsWake(UPrimitiveComponent* WakingComponent, FName BoneName)
+{
+	// replicate our movement while the body simulates
+	SetNetDormancy(DORM_Awake);
+}
+
+void ACombatDamageableBox::OnPhysicsSleep(UPrimitiveComponent* SleepingComponent, FName BoneName)
+{
+	// fading debris stays awake until it's destroyed
+	if (bFadingOut)
+	{
+		return;
+	}
+
+	// live boxes hand their mesh over to an instance now that they've settled. We're inside the physics sleep notification, so wait until next tick
+	if (bUseInstancing && CurrentHP > 0.0f)
+	{
+		GetWorld()->GetTimerManager().SetTimerForNextTick(this, &ACombatDamageableBox::Demote);
+		return;
+	}
+
+	// the body settled, so go back to sleep. Flushes the final transform to clients
+	SetNetDormancy(DORM_DormantAll);
+}
+
+void ACombatDamageableBox::SetInstanced(bool bNewInstanced)
+{
+	UCombatBoxInstanceSubsystem* BoxInstances = GetWorld()->GetSubsystem<UCombatBoxInstanceSubsystem>();
+
+	// skip if there's no subsystem, or we're already in the requested representation
+	if (!BoxInstances || BoxInstances->HasInstance(this) == bNewInstanced)
+	{
+		return;
+	}
+
+	if (bNewInstanced)
+	{
+		// only hide the mesh if an instance took its place
+		if (!BoxInstances->AddInstance(this, Mesh))
+		{
+			return;
+		}
+
+		// stop simulating and let the instance handle rendering and collision
+		Mesh->SetSimulatePhysics(false);
+		Mesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		Mesh->SetVisibility(false);
+	}
+	else
+	{
+		BoxInstances->RemoveInstance(this);
+
+		// take over from the instance and start simulating again
+		Mesh->SetVisibility(true);
+		Mesh->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
+		Mesh->SetSimulatePhysics(true);
+		Mesh->WakeAllRigidBodies();
+	}
+
+	// only the server writes the representation. Clients follow it through OnRep_Instanced
+	if (HasAuthority())
+	{
+		bInstanced = bNewInstanced;
+		MARK_PROPERTY_DIRTY_FROM_NAME(ACombatDamageableBox, bInstanced, this);
+	}
+}
+
+void ACombatDamageableBox::OnRep_Instanced()
+{
+	// follow the server's representation
+	SetInstanced(bInstanced);
+}
+
+void ACombatDamageableBox::Promote()
+{
+	if (!bInstanced)
+	{
+		return;
+	}
+
+	// wake up so clients promote as well
+	SetNetDormancy(DORM_Awake);
+
+	SetInstanced(false);
+
+	// boxes stacked on our instance just lost their support, so promote them as well. They promote whatever rests on them in turn
+	if (UCombatBoxInstanceSubsystem* BoxInstances = GetWorld()->GetSubsystem<UCombatBoxInstanceSubsystem>())
+	{
+		TArray<ACombatDamageableBox*> StackedBoxes;
+		BoxInstances->GetBoxesAbove(Mesh->Bounds.GetBox(), StackedBoxes);
+
+		for (ACombatDamageableBox* StackedBox : StackedBoxes)
+		{
+			StackedBox->Promote();
+		}
+	}
+}
+
+void ACombatDamageableBox::Demote()
+{
+	// we may have been hit or destroyed since we fell asleep
+	if (bInstanced || CurrentHP <= 0.0f || Mesh->RigidBodyIsAwake())
+	{
+		return;
+	}
+
+	SetInstanced(true);
+
+	// go back to sleep. Flushes the final transform and representation to clients, including boxes still in their initial dormancy
+	FlushNetDormancy();
+	SetNetDormancy(DORM_DormantAll);
+}
+
+void ACombatDamageableBox::BeginDebrisFade()
+{
+	// stop simulating and get out of the way while we shrink
+	Mesh->SetSimulatePhysics(false);
+	Mesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+
+	// tell clients to fade as well. Stay awake until we're destroyed so they see it
+	if (HasAuthority())
+	{
+		SetNetDormancy(DORM_Awake);
+
+		bFadingOut = true;
+		MARK_PROPERTY_DIRTY_FROM_NAME(ACombatDamageableBox, bFadingOut, this);
+	}
+}
+
+void ACombatDamageableBox::SetDebrisFade(float Alpha)
+{
+	// keep a tiny scale instead of zero so the transform stays valid
+	Mesh->SetRelativeScale3D(InitialScale * FMath::Max(Alpha, 0.01f));
+}
+
+void ACombatDamageableBox::OnRep_FadingOut()
+{
+	// the server started fading us out, so run the fade visuals locally. Fading debris is destroyed rather than reused, so the flag never goes back
+	if (bFadingOut)
+	{
+		if (UCombatDebrisSubsystem* Debris = GetWorld()->GetSubsystem<UCombatDebrisSubsystem>())
+		{
+			BeginDebrisFade();
+			Debris->AddFadingDebris(this);
+		}
+	}
 }
 
 void ACombatDamageableBox::ApplyHealing(float Healing, AActor* Healer)
@@ -9,6 +9,11 @@
 
 /**
  *  A simple physics box that reacts to damage through the ICombatDamageable interface
+ *  The box is net dormant while its physics body is asleep, and wakes when it's hit or pushed
+ *  The box starts out simulating. Once its body has settled and fallen asleep, it's drawn as an instance by the box instance subsystem and stops simulating.
+ *  It's promoted back to a physics actor when hit or pushed, along with any boxes stacked on it, and demoted again once its body falls asleep.
+ *  Only the server decides the representation. Clients follow it through replication.
+ *  Destroyed boxes are handed to the debris subsystem, which fades them out and removes them.
  */
 UCLASS(abstract)
 class ACombatDamageableBox : public AActor, public ICombatDamageable
@@ -30,12 +35,24 @@ protected:
 	UPROPERTY(EditAnywhere, Category="Damage")
 	float CurrentHP = 3.0f;
 
-	/** Time to wait before we remove this box from the level. */
+	/** Time to wait before we remove this box from the level. Debris may be removed earlier if there's too much of it */
 	UPROPERTY(EditAnywhere, Category="Damage", meta = (ClampMin = 0, ClampMax = 10, Units = "s"))
 	float DeathDelayTime = 6.0f;
 
-	/** Timer to defer destruction of this box after its HP are depleted */
-	FTimerHandle DeathTimer;
+	/** Mesh scale the box started with, shrunk down during the debris fade */
+	FVector InitialScale = FVector::OneVector;
+
+	/** If true, the box is debris shrinking away */
+	UPROPERTY(ReplicatedUsing=OnRep_FadingOut)
+	bool bFadingOut = false;
+
+	/** If true, the box is drawn as an instance while it's resting */
+	UPROPERTY(EditAnywhere, Category="Instancing")
+	bool bUseInstancing = true;
+
+	/** If true, the box is currently drawn as an instance instead of simulating */
+	UPROPERTY(ReplicatedUsing=OnRep_Instanced)
+	bool bInstanced = false;
 
 	/** Blueprint damage handler for effect playback */
 	UFUNCTION(BlueprintImplementableEvent, Category="Damage")
@@ -45,14 +62,50 @@ protected:
 	UFUNCTION(BlueprintImplementableEvent, Category="Damage")
 	void OnBoxDestroyed();
 
-	/** Timer callback to remove the box from the level after it dies */
-	void RemoveFromLevel();
+	/** Wakes the box from net dormancy when its physics body starts moving */
+	UFUNCTION()
+	void OnPhysicsWake(UPrimitiveComponent* WakingComponent, FName BoneName);
+
+	/** Puts the box back into net dormancy once its physics body settles */
+	UFUNCTION()
+	void OnPhysicsSleep(UPrimitiveComponent* SleepingComponent, FName BoneName);
+
+	/** Swaps between the instanced and simulating representations. Does nothing if we're already in the requested one */
+	void SetInstanced(bool bNewInstanced);
+
+	/** Follows the server's representation */
+	UFUNCTION()
+	void OnRep_Instanced();
+
+	/** Follows the server's debris fade */
+	UFUNCTION()
+	void OnRep_FadingOut();
 
 public:
 
+	/** Turns the box and any boxes stacked on it back into simulating physics actors. Server only */
+	void Promote();
+
+	/** Hands the box over to an instance and stops simulating, then goes back to net dormancy. Only called once the body has fallen asleep. Server only */
+	void Demote();
+
+	/** Stops simulating and starts shrinking away. Called by the debris subsystem */
+	void BeginDebrisFade();
+
+	/** Scales the mesh down during the debris fade. One is the full size */
+	void SetDebrisFade(float Alpha);
+
+public:
+
+	/** Gameplay initialization */
+	virtual void BeginPlay() override;
+
 	/** EndPlay cleanup */
 	void EndPlay(EEndPlayReason::Type EndPlayReason) override;
 
+	/** Sets up replicated properties */
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
 	// ~Begin CombatDamageable interface
 
 	/** Handles damage and knockback events */
@@ -0,0 +1,92 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatDamageableBox.h"
+#include "CombatBoxInstanceSubsystem.h"
+#include "CombatTargetGridSubsystem.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "UObject/UObjectIterator.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCombatSettledBoxDamageTest, "EscapeGame.Combat.Gameplay.SettledBoxDamage", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ServerContext | EAutomationTestFlags::ProductFilter)
+
+bool FCombatSettledBoxDamageTest::RunTest(const FString& Parameters)
+{
+	// the native box is abstract, so use the content one
+	UClass* BoxClass = LoadClass<ACombatDamageableBox>(nullptr, TEXT("/Game/Variant_Combat/Blueprints/Interactables/BP_CombatDamageableBox.BP_CombatDamageableBox_C"));
+
+	if (!TestNotNull(TEXT("box class"), BoxClass))
+	{
+		return false;
+	}
+
+	// set up a standalone game world, so we have authority and all world subsystems
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	World->InitializeActorsForPlay(FURL());
+	World->BeginPlay();
+
+	const FVector BoxLocation(0.0f, 0.0f, 100.0f);
+	ACombatDamageableBox* Box = World->SpawnActor<ACombatDamageableBox>(BoxClass, FTransform(BoxLocation));
+	UCombatBoxInstanceSubsystem* BoxInstances = World->GetSubsystem<UCombatBoxInstanceSubsystem>();
+	const UCombatTargetGridSubsystem* TargetGrid = World->GetSubsystem<UCombatTargetGridSubsystem>();
+
+	if (TestNotNull(TEXT("box"), Box) && TestNotNull(TEXT("box instance subsystem"), BoxInstances) && TestNotNull(TEXT("target grid"), TargetGrid))
+	{
+		UStaticMeshComponent* BoxMesh = Box->FindComponentByClass<UStaticMeshComponent>();
+
+		// settle the box, the same way the physics sleep notification does
+		BoxMesh->PutRigidBodyToSleep();
+		Box->Demote();
+
+		TestTrue(TEXT("settled box is instanced"), BoxInstances->HasInstance(Box));
+		TestTrue(TEXT("settled box mesh has no collision"), BoxMesh->GetCollisionEnabled() == ECollisionEnabled::NoCollision);
+
+		// traces that hit the instance must be able to find the box
+		const UInstancedStaticMeshComponent* Instances = nullptr;
+
+		for (TObjectIterator<UInstancedStaticMeshComponent> It; It; ++It)
+		{
+			if (It->GetWorld() == World && It->GetInstanceCount() > 0)
+			{
+				Instances = *It;
+				break;
+			}
+		}
+
+		if (TestNotNull(TEXT("box instance component"), Instances))
+		{
+			TestTrue(TEXT("instance resolves to the box"), BoxInstances->GetBoxForInstance(Instances, 0) == Box);
+		}
+
+		// attack through the box like the player's melee trace does
+		TArray<FCombatTargetCandidate> Candidates;
+		TargetGrid->QueryCapsule(BoxLocation - FVector(200.0f, 0.0f, 0.0f), BoxLocation + FVector(200.0f, 0.0f, 0.0f), 50.0f, ECombatTargetType::All, nullptr, Candidates);
+
+		const FCombatTargetCandidate* BoxCandidate = Candidates.FindByPredicate([Box](const FCombatTargetCandidate& Candidate) { return Candidate.Actor == Box; });
+
+		if (TestNotNull(TEXT("settled box found by the melee query"), BoxCandidate))
+		{
+			BoxCandidate->Damageable->ApplyDamage(1.0f, nullptr, BoxCandidate->ImpactPoint, FVector(0.0f, 0.0f, 100.0f));
+
+			// the hit takes the box out of its instance so it can react
+			TestFalse(TEXT("damaged box is no longer instanced"), BoxInstances->HasInstance(Box));
+			TestTrue(TEXT("damaged box simulates"), BoxMesh->IsSimulatingPhysics());
+		}
+	}
+
+	// tear the world down
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,163 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatDebrisSubsystem.h"
+#include "CombatDamageableBox.h"
+#include "Engine/World.h"
+
+void UCombatDebrisSubsystem::AddDebris(ACombatDamageableBox* Box, float Lifetime)
+{
+	// ignore repeated registrations
+	if (!IsValid(Box) || LiveDebris.ContainsByPredicate([Box](const FCombatDebrisEntry& Entry) { return Entry.Box.Get() == Box; }))
+	{
+		return;
+	}
+
+	// if we're at the cap, force the oldest simulating debris to start fading now
+	int32 SimulatingDebris = 0;
+
+	for (const FCombatDebrisEntry& Entry : LiveDebris)
+	{
+		SimulatingDebris += Entry.IsFading() ? 0 : 1;
+	}
+
+	if (SimulatingDebris >= MaxLiveDebris)
+	{
+		const int32 OldestIndex = LiveDebris.IndexOfByPredicate([](const FCombatDebrisEntry& Entry) { return !Entry.IsFading(); });
+
+		if (OldestIndex != INDEX_NONE)
+		{
+			StartFade(OldestIndex);
+		}
+	}
+
+	FCombatDebrisEntry& NewEntry = LiveDebris.AddDefaulted_GetRef();
+	NewEntry.Box = Box;
+	NewEntry.ExpireTime = GetWorld()->GetTimeSeconds() + Lifetime;
+}
+
+void UCombatDebrisSubsystem::AddFadingDebris(ACombatDamageableBox* Box)
+{
+	// ignore repeated registrations
+	if (!IsValid(Box) || LiveDebris.ContainsByPredicate([Box](const FCombatDebrisEntry& Entry) { return Entry.Box.Get() == Box; }))
+	{
+		return;
+	}
+
+	FCombatDebrisEntry& NewEntry = LiveDebris.AddDefaulted_GetRef();
+	NewEntry.Box = Box;
+	NewEntry.ExpireTime = NewEntry.FadeStartTime = GetWorld()->GetTimeSeconds();
+}
+
+void UCombatDebrisSubsystem::RemoveDebris(const ACombatDamageableBox* Box)
+{
+	// keep the oldest first order
+	LiveDebris.RemoveAll([Box](const FCombatDebrisEntry& Entry) { return Entry.Box.Get() == Box; });
+
+	// clear queued destroys in place, so the queue head stays valid
+	for (TWeakObjectPtr<ACombatDamageableBox>& Entry : PendingDestroy)
+	{
+		if (Entry.Get() == Box)
+		{
+			Entry.Reset();
+		}
+	}
+}
+
+void UCombatDebrisSubsystem::Tick(float DeltaTime)
+{
+	const double CurrentTime = GetWorld()->GetTimeSeconds();
+	int32 FadeStarts = 0;
+
+	for (int32 i = 0; i < LiveDebris.Num(); ++i)
+	{
+		FCombatDebrisEntry& Entry = LiveDebris[i];
+		ACombatDamageableBox* Box = Entry.Box.Get();
+
+		// drop debris that has gone away without unregistering
+		if (!IsValid(Box))
+		{
+			LiveDebris.RemoveAt(i--, EAllowShrinking::No);
+			continue;
+		}
+
+		// start fading expired debris, a few per frame
+		if (!Entry.IsFading())
+		{
+			if (CurrentTime < Entry.ExpireTime || FadeStarts >= MaxFadeStartsPerFrame)
+			{
+				continue;
+			}
+
+			StartFade(i);
+			++FadeStarts;
+		}
+
+		// shrink the debris away
+		const float FadeAlpha = FadeOutTime > 0.0f ? FMath::Clamp(1.0f - static_cast<float>(CurrentTime - Entry.FadeStartTime) / FadeOutTime, 0.0f, 1.0f) : 0.0f;
+		Box->SetDebrisFade(FadeAlpha);
+
+		// is the fade over? Clients hold the shrunk box until the server's destroy replicates
+		if (FadeAlpha <= 0.0f)
+		{
+			LiveDebris.RemoveAt(i--, EAllowShrinking::No);
+
+			if (Box->HasAuthority())
+			{
+				PendingDestroy.Add(Box);
+			}
+		}
+	}
+
+	// destroy finished debris, a few per frame. Advance the head before destroying, since destroying a box unregisters it from us
+	int32 Destroys = 0;
+
+	while (Destroys < FMath::Max(MaxDestroysPerFrame, 1) && PendingDestroyHead < PendingDestroy.Num())
+	{
+		ACombatDamageableBox* Box = PendingDestroy[PendingDestroyHead++].Get();
+
+		// skip boxes that have already gone away
+		if (IsValid(Box))
+		{
+			Box->Destroy();
+			++Destroys;
+		}
+	}
+
+	// drop the handled entries once they make up half the queue, so the shift cost is amortized
+	if (PendingDestroyHead >= PendingDestroy.Num())
+	{
+		PendingDestroy.Reset();
+		PendingDestroyHead = 0;
+	}
+	else if (PendingDestroyHead * 2 >= PendingDestroy.Num())
+	{
+		PendingDestroy.RemoveAt(0, PendingDestroyHead, EAllowShrinking::No);
+		PendingDestroyHead = 0;
+	}
+}
+
+TStatId UCombatDebrisSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCombatDebrisSubsystem, STATGROUP_Tickables);
+}
+
+void UCombatDebrisSubsystem::Deinitialize()
+{
+	LiveDebris.Empty();
+	PendingDestroy.Empty();
+	PendingDestroyHead = 0;
+
+	Super::Deinitialize();
+}
+
+void UCombatDebrisSubsystem::StartFade(int32 EntryIndex)
+{
+	FCombatDebrisEntry& Entry = LiveDebris[EntryIndex];
+	Entry.FadeStartTime = GetWorld()->GetTimeSeconds();
+
+	if (ACombatDamageableBox* Box = Entry.Box.Get())
+	{
+		Box->BeginDebrisFade();
+	}
+}
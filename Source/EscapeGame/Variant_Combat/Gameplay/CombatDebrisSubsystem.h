@@ -0,0 +1,96 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CombatDebrisSubsystem.generated.h"
+
+class ACombatDamageableBox;
+
+/** A destroyed box waiting to fade out */
+struct FCombatDebrisEntry
+{
+	/** Debris box */
+	TWeakObjectPtr<ACombatDamageableBox> Box;
+
+	/** World time when the debris starts fading out */
+	double ExpireTime = 0.0;
+
+	/** World time when the debris started fading out. Negative while it's still waiting */
+	double FadeStartTime = -1.0;
+
+	/** Returns true if the debris is fading out */
+	bool IsFading() const { return FadeStartTime >= 0.0; }
+};
+
+/**
+ *  Manages the lifetime of destroyed damageable boxes.
+ *  Debris simulates until its lifetime runs out, then shrinks away over a short fade and is destroyed.
+ *  The number of simulating debris boxes is capped. When over the cap, the oldest debris starts fading right away.
+ *  Fade starts and destroys are spread across frames, so chains of destruction don't all clean up at once.
+ *  Clients run the fade visuals for debris the server tells them about, but only the server destroys it.
+ */
+UCLASS(config=Game)
+class UCombatDebrisSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Maximum number of debris boxes simulating at the same time */
+	UPROPERTY(Config)
+	int32 MaxLiveDebris = 12;
+
+	/** Time it takes debris to shrink away */
+	UPROPERTY(Config)
+	float FadeOutTime = 0.5f;
+
+	/** Maximum number of debris boxes that may start fading out on the same frame, when not forced by the cap */
+	UPROPERTY(Config)
+	int32 MaxFadeStartsPerFrame = 2;
+
+	/** Maximum number of faded out debris boxes that may be destroyed on the same frame */
+	UPROPERTY(Config)
+	int32 MaxDestroysPerFrame = 2;
+
+	/** Debris boxes, oldest first */
+	TArray<FCombatDebrisEntry> LiveDebris;
+
+	/** Faded out debris boxes waiting to be destroyed, oldest first. Entries before the head have already been handled */
+	TArray<TWeakObjectPtr<ACombatDamageableBox>> PendingDestroy;
+
+	/** Index of the next box to destroy */
+	int32 PendingDestroyHead = 0;
+
+public:
+
+	/** Starts tracking a destroyed box. It will start fading out after the provided lifetime. Server only */
+	void AddDebris(ACombatDamageableBox* Box, float Lifetime);
+
+	/** Starts fading out a box right away. Used by clients to follow the server's fades */
+	void AddFadingDebris(ACombatDamageableBox* Box);
+
+	/** Stops tracking a box, e.g. because it's being removed from the level */
+	void RemoveDebris(const ACombatDamageableBox* Box);
+
+public:
+
+	// ~begin UTickableWorldSubsystem interface
+
+	/** Starts fades for expired debris, updates fading debris and destroys finished ones */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Returns the stat ID for the tickable */
+	virtual TStatId GetStatId() const override;
+
+	/** Cleanup */
+	virtual void Deinitialize() override;
+
+	// ~end UTickableWorldSubsystem interface
+
+protected:
+
+	/** Starts fading out the debris at the provided index */
+	void StartFade(int32 EntryIndex);
+};
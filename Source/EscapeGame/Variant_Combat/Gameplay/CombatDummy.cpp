@@ -5,6 +5,7 @@
 #include "Components/SceneComponent.h"
 #include "Components/StaticMeshComponent.h"
 #include "PhysicsEngine/PhysicsConstraintComponent.h"
+#include "CombatTargetGridSubsystem.h"
 
 ACombatDummy::ACombatDummy()
 {
@@ -31,6 +32,28 @@ ACombatDummy::ACombatDummy()
 	PhysicsConstraint->SetConstrainedComponents(BasePlate, NAME_None, Dummy, NAME_None);
 }
 
+void ACombatDummy::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// register the dummy mesh with the combat target grid so attacks can find us
+	if (UCombatTargetGridSubsystem* TargetGrid = GetWorld()->GetSubsystem<UCombatTargetGridSubsystem>())
+	{
+		TargetGrid->RegisterTarget(this, Dummy, ECombatTargetType::Prop);
+	}
+}
+
+void ACombatDummy::EndPlay(EEndPlayReason::Type EndPlayReason)
+{
+	Super::EndPlay(EndPlayReason);
+
+	// remove ourselves from the combat target grid
+	if (UCombatTargetGridSubsystem* TargetGrid = GetWorld()->GetSubsystem<UCombatTargetGridSubsystem>())
+	{
+		TargetGrid->UnregisterTarget(this);
+	}
+}
+
 void ACombatDummy::ApplyDamage(float Damage, AActor* DamageCauser, const FVector& DamageLocation, const FVector& DamageImpulse)
 {
 	// apply impulse to the dummy
@@ -39,6 +39,12 @@ public:
 	/** Constructor */
 	ACombatDummy();
 
+	/** Gameplay initialization */
+	virtual void BeginPlay() override;
+
+	/** EndPlay cleanup */
+	virtual void EndPlay(EEndPlayReason::Type EndPlayReason) override;
+
 	// ~Begin CombatDamageable interface
 
 		/** Handles damage and knockback events */
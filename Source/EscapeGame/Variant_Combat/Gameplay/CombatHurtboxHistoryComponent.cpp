@@ -0,0 +1,134 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatHurtboxHistoryComponent.h"
+#include "Components/PrimitiveComponent.h"
+#include "Components/CapsuleComponent.h"
+#include "GameFramework/Actor.h"
+#include "Engine/World.h"
+
+UCombatHurtboxHistoryComponent::UCombatHurtboxHistoryComponent()
+{
+	// record after movement and physics so we store the final pose for the frame
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.TickGroup = TG_PostPhysics;
+}
+
+void UCombatHurtboxHistoryComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// only the server validates hits
+	if (!GetOwner()->HasAuthority())
+	{
+		SetComponentTickEnabled(false);
+		return;
+	}
+
+	// default to the owner's root component
+	if (!Shape.IsValid())
+	{
+		Shape = Cast<UPrimitiveComponent>(GetOwner()->GetRootComponent());
+	}
+
+	// allocate the ring buffer once
+	Samples.SetNum(HistoryCapacity);
+	ClearHistory();
+}
+
+void UCombatHurtboxHistoryComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	if (!Shape.IsValid() || Samples.IsEmpty())
+	{
+		return;
+	}
+
+	// overwrite the oldest sample
+	NewestSample = (NewestSample + 1) % Samples.Num();
+	NumSamples = FMath::Min(NumSamples + 1, Samples.Num());
+
+	RecordSample(Samples[NewestSample]);
+}
+
+bool UCombatHurtboxHistoryComponent::GetHurtboxAtTime(double Time, FCombatHurtboxSample& OutSample) const
+{
+	if (NumSamples == 0)
+	{
+		return false;
+	}
+
+	const FCombatHurtboxSample& Newest = Samples[NewestSample];
+
+	// the current hurtbox is more accurate than the newest sample
+	if (Time >= Newest.Time)
+	{
+		return false;
+	}
+
+	// never rewind further than the allowed window
+	Time = FMath::Max(Time, Newest.Time - MaxRewindTime);
+
+	// walk back from the newest sample until we find the pair bracketing the time
+	const FCombatHurtboxSample* After = &Newest;
+
+	for (int32 Age = 1; Age < NumSamples; ++Age)
+	{
+		const FCombatHurtboxSample& Before = Samples[GetSampleIndex(Age)];
+
+		if (Before.Time <= Time)
+		{
+			const double Span = After->Time - Before.Time;
+			const float Alpha = Span > UE_SMALL_NUMBER ? static_cast<float>((Time - Before.Time) / Span) : 1.0f;
+
+			OutSample.Time = Time;
+			OutSample.Location = FMath::Lerp(Before.Location, After->Location, Alpha);
+			OutSample.Rotation = FQuat::Slerp(Before.Rotation, After->Rotation, Alpha);
+			OutSample.Radius = FMath::Lerp(Before.Radius, After->Radius, Alpha);
+			OutSample.HalfHeight = FMath::Lerp(Before.HalfHeight, After->HalfHeight, Alpha);
+
+			return true;
+		}
+
+		After = &Before;
+	}
+
+	// the time is older than our history, so use the oldest sample we have
+	OutSample = *After;
+
+	return true;
+}
+
+void UCombatHurtboxHistoryComponent::ClearHistory()
+{
+	NewestSample = INDEX_NONE;
+	NumSamples = 0;
+}
+
+void UCombatHurtboxHistoryComponent::RecordSample(FCombatHurtboxSample& OutSample) const
+{
+	const UPrimitiveComponent* ShapeComponent = Shape.Get();
+
+	OutSample.Time = GetWorld()->GetTimeSeconds();
+	OutSample.Location = ShapeComponent->Bounds.Origin;
+	OutSample.Rotation = ShapeComponent->GetComponentQuat();
+
+	// use the exact capsule dimensions if we can, otherwise approximate from the bounds
+	if (const UCapsuleComponent* Capsule = Cast<UCapsuleComponent>(ShapeComponent))
+	{
+		OutSample.Radius = Capsule->GetScaledCapsuleRadius();
+		OutSample.HalfHeight = Capsule->GetScaledCapsuleHalfHeight();
+	}
+	else
+	{
+		const FVector Extent = ShapeComponent->Bounds.BoxExtent;
+		OutSample.Radius = FMath::Max(Extent.X, Extent.Y);
+		OutSample.HalfHeight = FMath::Max(Extent.Z, OutSample.Radius);
+	}
+}
+
+int32 UCombatHurtboxHistoryComponent::GetSampleIndex(int32 Age) const
+{
+	return (NewestSample - Age + Samples.Num()) % Samples.Num();
+}
@@ -0,0 +1,98 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "CombatHurtboxHistoryComponent.generated.h"
+
+class UPrimitiveComponent;
+
+/** A pawn's transform and vertical capsule hurtbox at a point in server time */
+struct FCombatHurtboxSample
+{
+	/** Server time the sample was recorded at */
+	double Time = 0.0;
+
+	/** Center of the hurtbox */
+	FVector Location = FVector::ZeroVector;
+
+	/** Rotation of the hurtbox's component */
+	FQuat Rotation = FQuat::Identity;
+
+	/** Radius of the hurtbox capsule */
+	float Radius = 0.0f;
+
+	/** Half height of the hurtbox capsule, including the hemispherical caps */
+	float HalfHeight = 0.0f;
+};
+
+/**
+ *  Records the owner's hurtbox every server tick into a fixed capacity ring buffer,
+ *  so melee attacks can be validated against where the attacking client saw their targets.
+ *  The buffer is allocated once on BeginPlay and never grows. Clients don't record anything.
+ */
+UCLASS(ClassGroup=(Combat), meta=(BlueprintSpawnableComponent))
+class UCombatHurtboxHistoryComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Number of samples kept in the ring buffer. Should cover MaxRewindTime at the server's tick rate */
+	UPROPERTY(EditAnywhere, Category="Hurtbox History", meta = (ClampMin = 2, ClampMax = 256))
+	int32 HistoryCapacity = 32;
+
+	/** Furthest back in time a rewind may go. Older requests are clamped to this window */
+	UPROPERTY(EditAnywhere, Category="Hurtbox History", meta = (ClampMin = 0, ClampMax = 1, Units = "s"))
+	float MaxRewindTime = 0.25f;
+
+	/** Component whose bounds we record as the hurtbox. Defaults to the owner's root component */
+	TWeakObjectPtr<UPrimitiveComponent> Shape;
+
+	/** Ring buffer of recorded samples */
+	TArray<FCombatHurtboxSample> Samples;
+
+	/** Index of the newest sample in the ring buffer */
+	int32 NewestSample = INDEX_NONE;
+
+	/** Number of valid samples in the ring buffer */
+	int32 NumSamples = 0;
+
+public:
+
+	/** Constructor */
+	UCombatHurtboxHistoryComponent();
+
+	/** Sets the component to record as the hurtbox */
+	void SetShape(UPrimitiveComponent* InShape) { Shape = InShape; }
+
+	/**
+	 *  Finds the hurtbox at the provided server time, interpolating between the bracketing samples.
+	 *  Times older than the rewind window are clamped to it.
+	 *  Returns false if there's no history, or the time is newer than the newest sample and the current hurtbox should be used instead.
+	 */
+	bool GetHurtboxAtTime(double Time, FCombatHurtboxSample& OutSample) const;
+
+	/** Returns the max rewind time */
+	float GetMaxRewindTime() const { return MaxRewindTime; }
+
+	/** Clears all recorded samples, e.g. after a teleport */
+	void ClearHistory();
+
+protected:
+
+	/** Initialization */
+	virtual void BeginPlay() override;
+
+	/** Builds a sample from the shape's current state */
+	void RecordSample(FCombatHurtboxSample& OutSample) const;
+
+	/** Returns the ring buffer index of the nth newest sample */
+	int32 GetSampleIndex(int32 Age) const;
+
+public:
+
+	/** Records the current hurtbox */
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+};
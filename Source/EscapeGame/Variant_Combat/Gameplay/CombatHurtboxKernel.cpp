@@ -0,0 +1,200 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatHurtboxKernel.h"
+#include "Math/VectorRegister.h"
+
+void FCombatHurtboxSoA::Reset()
+{
+	CenterX.Reset();
+	CenterY.Reset();
+	CenterZ.Reset();
+	SegmentHalfLength.Reset();
+	Radius.Reset();
+
+	Num = 0;
+}
+
+int32 FCombatHurtboxSoA::Add(const FVector& Center, float InRadius, float HalfHeight)
+{
+	// grow by a full set of lanes at a time, so loads never read past the end of the arrays
+	if (Num % LaneWidth == 0)
+	{
+		CenterX.AddZeroed(LaneWidth);
+		CenterY.AddZeroed(LaneWidth);
+		CenterZ.AddZeroed(LaneWidth);
+		SegmentHalfLength.AddZeroed(LaneWidth);
+		Radius.AddZeroed(LaneWidth);
+	}
+
+	const int32 Index = Num++;
+
+	CenterX[Index] = static_cast<float>(Center.X);
+	CenterY[Index] = static_cast<float>(Center.Y);
+	CenterZ[Index] = static_cast<float>(Center.Z);
+	SegmentHalfLength[Index] = FMath::Max(HalfHeight - InRadius, 0.0f);
+	Radius[Index] = InRadius;
+
+	return Index;
+}
+
+void FCombatHurtboxKernel::SweepSphere(const FCombatHurtboxSoA& Hurtboxes, const FVector& Start, const FVector& End, float SweepRadius, TArray<FCombatHurtboxHit>& OutHits)
+{
+	constexpr float Epsilon = UE_KINDA_SMALL_NUMBER;
+
+	// sweep segment direction. Offsets below are taken relative to the sweep start, but the packed centers are absolute floats, so precision still drops far from the origin
+	const FVector3f Delta = FVector3f(End - Start);
+	const float SweepLengthSquared = Delta.SizeSquared();
+	const bool bDegenerateSweep = SweepLengthSquared <= Epsilon;
+
+	// fall back to pushing away from the sweep if the closest points coincide
+	const FVector FallbackNormal = -(End - Start).GetSafeNormal();
+
+	// broadcast the per-sweep values
+	const VectorRegister4Float StartX = VectorSetFloat1(static_cast<float>(Start.X));
+	const VectorRegister4Float StartY = VectorSetFloat1(static_cast<float>(Start.Y));
+	const VectorRegister4Float StartZ = VectorSetFloat1(static_cast<float>(Start.Z));
+	const VectorRegister4Float DeltaX = VectorSetFloat1(Delta.X);
+	const VectorRegister4Float DeltaY = VectorSetFloat1(Delta.Y);
+	const VectorRegister4Float DeltaZ = VectorSetFloat1(Delta.Z);
+	const VectorRegister4Float A = VectorSetFloat1(SweepLengthSquared);
+	const VectorRegister4Float InvA = VectorSetFloat1(bDegenerateSweep ? 0.0f : 1.0f / SweepLengthSquared);
+	const VectorRegister4Float SweepRadiusV = VectorSetFloat1(SweepRadius);
+	const VectorRegister4Float EpsilonV = VectorSetFloat1(Epsilon);
+	const VectorRegister4Float Two = VectorSetFloat1(2.0f);
+	const VectorRegister4Float Zero = VectorZeroFloat();
+	const VectorRegister4Float One = VectorOneFloat();
+
+	alignas(16) float LaneS[FCombatHurtboxSoA::LaneWidth];
+	alignas(16) float LaneT[FCombatHurtboxSoA::LaneWidth];
+
+	for (int32 BaseIndex = 0; BaseIndex < Hurtboxes.Num; BaseIndex += FCombatHurtboxSoA::LaneWidth)
+	{
+		// load a set of capsules
+		const VectorRegister4Float CenterX = VectorLoadAligned(Hurtboxes.CenterX.GetData() + BaseIndex);
+		const VectorRegister4Float CenterY = VectorLoadAligned(Hurtboxes.CenterY.GetData() + BaseIndex);
+		const VectorRegister4Float CenterZ = VectorLoadAligned(Hurtboxes.CenterZ.GetData() + BaseIndex);
+		const VectorRegister4Float HalfLength = VectorLoadAligned(Hurtboxes.SegmentHalfLength.GetData() + BaseIndex);
+		const VectorRegister4Float CapsuleRadius = VectorLoadAligned(Hurtboxes.Radius.GetData() + BaseIndex);
+
+		// capsule segment bottom relative to the sweep start, and the segment extent along Z
+		const VectorRegister4Float BottomX = VectorSubtract(CenterX, StartX);
+		const VectorRegister4Float BottomY = VectorSubtract(CenterY, StartY);
+		const VectorRegister4Float BottomZ = VectorSubtract(VectorSubtract(CenterZ, HalfLength), StartZ);
+		const VectorRegister4Float SegmentZ = VectorMultiply(HalfLength, Two);
+
+		// closest points between two segments, after Ericson's Real-Time Collision Detection 5.1.9.
+		// R = SweepStart - CapsuleBottom, and the capsule's segment only has a Z component
+		const VectorRegister4Float E = VectorMultiply(SegmentZ, SegmentZ);
+		const VectorRegister4Float F = VectorMultiply(SegmentZ, VectorNegate(BottomZ));
+		const VectorRegister4Float C = VectorNegate(VectorMultiplyAdd(DeltaX, BottomX, VectorMultiplyAdd(DeltaY, BottomY, VectorMultiply(DeltaZ, BottomZ))));
+		const VectorRegister4Float B = VectorMultiply(DeltaZ, SegmentZ);
+
+		const VectorRegister4Float SafeE = VectorMax(E, EpsilonV);
+		const VectorRegister4Float DegenerateCapsule = VectorCompareLE(E, EpsilonV);
+
+		VectorRegister4Float S;
+		VectorRegister4Float T;
+
+		if (bDegenerateSweep)
+		{
+			// the sweep is a point, so only the capsule parameter varies
+			S = Zero;
+			T = VectorMin(VectorMax(VectorDivide(F, SafeE), Zero), One);
+		}
+		else
+		{
+			// unclamped closest point on the sweep, if the segments aren't parallel
+			const VectorRegister4Float Denom = VectorSubtract(VectorMultiply(A, E), VectorMultiply(B, B));
+			const VectorRegister4Float SNumerator = VectorSubtract(VectorMultiply(B, F), VectorMultiply(C, E));
+			const VectorRegister4Float SClamped = VectorMin(VectorMax(VectorDivide(SNumerator, VectorMax(Denom, EpsilonV)), Zero), One);
+			const VectorRegister4Float S0 = VectorSelect(VectorCompareGT(Denom, EpsilonV), SClamped, Zero);
+
+			// closest point on the capsule for that sweep point
+			const VectorRegister4Float T0 = VectorDivide(VectorMultiplyAdd(B, S0, F), SafeE);
+			T = VectorMin(VectorMax(T0, Zero), One);
+
+			// if the capsule point had to be clamped, recompute the sweep point for the clamped value
+			const VectorRegister4Float SAlternate = VectorMin(VectorMax(VectorMultiply(VectorSubtract(VectorMultiply(B, T), C), InvA), Zero), One);
+			const VectorRegister4Float UseAlternate = VectorBitwiseOr(VectorBitwiseOr(VectorCompareLT(T0, Zero), VectorCompareGT(T0, One)), DegenerateCapsule);
+
+			S = VectorSelect(UseAlternate, SAlternate, S0);
+		}
+
+		// distance between the closest points
+		const VectorRegister4Float DiffX = VectorSubtract(VectorMultiply(DeltaX, S), BottomX);
+		const VectorRegister4Float DiffY = VectorSubtract(VectorMultiply(DeltaY, S), BottomY);
+		const VectorRegister4Float DiffZ = VectorSubtract(VectorMultiply(DeltaZ, S), VectorMultiplyAdd(SegmentZ, T, BottomZ));
+		const VectorRegister4Float DistanceSquared = VectorMultiplyAdd(DiffX, DiffX, VectorMultiplyAdd(DiffY, DiffY, VectorMultiply(DiffZ, DiffZ)));
+
+		// are the shapes touching?
+		const VectorRegister4Float ContactDistance = VectorAdd(SweepRadiusV, CapsuleRadius);
+		int32 HitMask = VectorMaskBits(VectorCompareLE(DistanceSquared, VectorMultiply(ContactDistance, ContactDistance)));
+
+		// discard padding lanes
+		const int32 ValidLanes = FMath::Min(Hurtboxes.Num - BaseIndex, FCombatHurtboxSoA::LaneWidth);
+		HitMask &= (1 << ValidLanes) - 1;
+
+		if (HitMask == 0)
+		{
+			continue;
+		}
+
+		// hits are rare, so build them in scalar code
+		VectorStoreAligned(S, LaneS);
+		VectorStoreAligned(T, LaneT);
+
+		for (int32 Lane = 0; Lane < FCombatHurtboxSoA::LaneWidth; ++Lane)
+		{
+			if ((HitMask & (1 << Lane)) == 0)
+			{
+				continue;
+			}
+
+			const int32 Index = BaseIndex + Lane;
+			const float CapsuleHalfLength = Hurtboxes.SegmentHalfLength[Index];
+
+			const FVector PointOnSweep = Start + (End - Start) * LaneS[Lane];
+			const FVector PointOnCapsule(Hurtboxes.CenterX[Index], Hurtboxes.CenterY[Index], Hurtboxes.CenterZ[Index] - CapsuleHalfLength + (2.0f * CapsuleHalfLength * LaneT[Lane]));
+
+			OutHits.Add(MakeHit(Index, PointOnSweep, PointOnCapsule, Hurtboxes.Radius[Index], FallbackNormal));
+		}
+	}
+}
+
+void FCombatHurtboxKernel::SweepSphereScalar(const FCombatHurtboxSoA& Hurtboxes, const FVector& Start, const FVector& End, float SweepRadius, TArray<FCombatHurtboxHit>& OutHits)
+{
+	const FVector FallbackNormal = -(End - Start).GetSafeNormal();
+
+	for (int32 Index = 0; Index < Hurtboxes.Num; ++Index)
+	{
+		const FVector Center(Hurtboxes.CenterX[Index], Hurtboxes.CenterY[Index], Hurtboxes.CenterZ[Index]);
+		const FVector HalfSegment(0.0f, 0.0f, Hurtboxes.SegmentHalfLength[Index]);
+
+		FVector PointOnSweep, PointOnCapsule;
+		FMath::SegmentDistToSegmentSafe(Start, End, Center - HalfSegment, Center + HalfSegment, PointOnSweep, PointOnCapsule);
+
+		if (FVector::DistSquared(PointOnSweep, PointOnCapsule) <= FMath::Square(SweepRadius + Hurtboxes.Radius[Index]))
+		{
+			OutHits.Add(MakeHit(Index, PointOnSweep, PointOnCapsule, Hurtboxes.Radius[Index], FallbackNormal));
+		}
+	}
+}
+
+FCombatHurtboxHit FCombatHurtboxKernel::MakeHit(int32 Index, const FVector& PointOnSweep, const FVector& PointOnCapsule, float CapsuleRadius, const FVector& FallbackNormal)
+{
+	// the normal faces from the capsule towards the sweep, same as a physics sweep's impact normal
+	FVector Normal = PointOnSweep - PointOnCapsule;
+
+	if (!Normal.Normalize())
+	{
+		Normal = FallbackNormal.IsNearlyZero() ? FVector::UpVector : FallbackNormal;
+	}
+
+	FCombatHurtboxHit Hit;
+	Hit.Index = Index;
+	Hit.ImpactNormal = Normal;
+	Hit.ImpactPoint = PointOnCapsule + (Normal * CapsuleRadius);
+
+	return Hit;
+}
@@ -0,0 +1,68 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ *  Packed structure-of-arrays storage for vertical capsule hurtboxes.
+ *  Arrays are 16-byte aligned and padded to the SIMD width so the kernel can load full lanes.
+ *  Centers are stored as absolute world-space floats, so precision drops with distance from the world origin:
+ *  roughly 0.01cm at 1km and 1cm at 100km. Results are only approximate for targets far from the origin.
+ */
+struct FCombatHurtboxSoA
+{
+	/** Number of capsules tested per kernel iteration */
+	static constexpr int32 LaneWidth = 4;
+
+	/** Capsule centers */
+	TArray<float, TAlignedHeapAllocator<16>> CenterX;
+	TArray<float, TAlignedHeapAllocator<16>> CenterY;
+	TArray<float, TAlignedHeapAllocator<16>> CenterZ;
+
+	/** Half length of each capsule's inner segment, i.e. half height minus radius */
+	TArray<float, TAlignedHeapAllocator<16>> SegmentHalfLength;
+
+	/** Capsule radii */
+	TArray<float, TAlignedHeapAllocator<16>> Radius;
+
+	/** Number of valid capsules. Lanes past this index are padding */
+	int32 Num = 0;
+
+	/** Clears all capsules, keeping the allocations */
+	void Reset();
+
+	/** Adds a vertical capsule and returns its index */
+	int32 Add(const FVector& Center, float InRadius, float HalfHeight);
+};
+
+/** A single hurtbox hit reported by the kernel */
+struct FCombatHurtboxHit
+{
+	/** Index of the capsule in the SoA arrays */
+	int32 Index = INDEX_NONE;
+
+	/** Closest point on the capsule's surface to the swept sphere */
+	FVector ImpactPoint = FVector::ZeroVector;
+
+	/** Surface normal at the impact point, facing the swept sphere */
+	FVector ImpactNormal = FVector::ZeroVector;
+};
+
+/**
+ *  Vectorized narrow phase for melee attacks.
+ *  Tests a single swept sphere against packed vertical capsules, four at a time.
+ */
+struct FCombatHurtboxKernel
+{
+	/** Tests a sphere swept from Start to End against all hurtboxes, appending any hits */
+	static void SweepSphere(const FCombatHurtboxSoA& Hurtboxes, const FVector& Start, const FVector& End, float SweepRadius, TArray<FCombatHurtboxHit>& OutHits);
+
+	/** Scalar reference implementation of SweepSphere, used to validate the vectorized path */
+	static void SweepSphereScalar(const FCombatHurtboxSoA& Hurtboxes, const FVector& Start, const FVector& End, float SweepRadius, TArray<FCombatHurtboxHit>& OutHits);
+
+private:
+
+	/** Builds a hit from the closest points between the sweep segment and a capsule's inner segment */
+	static FCombatHurtboxHit MakeHit(int32 Index, const FVector& PointOnSweep, const FVector& PointOnCapsule, float CapsuleRadius, const FVector& FallbackNormal);
+};
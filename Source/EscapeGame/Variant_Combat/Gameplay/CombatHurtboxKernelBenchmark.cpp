@@ -0,0 +1,251 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatHurtboxKernel.h"
+#include "Engine/World.h"
+#include "Components/CapsuleComponent.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+#include "EscapeGame.h"
+
+#if !UE_BUILD_SHIPPING
+
+namespace CombatHurtboxKernelBenchmark
+{
+	/** Capsule dimensions used for all benchmark targets, matching the default character capsule */
+	constexpr float TargetRadius = 35.0f;
+	constexpr float TargetHalfHeight = 90.0f;
+
+	/** Attack shape, matching the default melee trace settings */
+	constexpr float SweepRadius = 75.0f;
+	constexpr float SweepDistance = 75.0f;
+
+	/** Half extent of the area the targets are scattered across */
+	constexpr float AreaExtent = 1500.0f;
+
+	/** Number of sweeps timed for each target count */
+	constexpr int32 Iterations = 2000;
+
+	/** Collects the sorted, unique capsule indices hit by a kernel sweep */
+	void GetHitIndices(const TArray<FCombatHurtboxHit>& Hits, TArray<int32>& OutIndices)
+	{
+		OutIndices.Reset();
+
+		for (const FCombatHurtboxHit& Hit : Hits)
+		{
+			OutIndices.AddUnique(Hit.Index);
+		}
+
+		OutIndices.Sort();
+	}
+
+	/** Collects the sorted, unique capsule indices hit by a physics sweep */
+	void GetHitIndices(const TArray<FHitResult>& Hits, const TMap<const UPrimitiveComponent*, int32>& CapsuleIndices, TArray<int32>& OutIndices)
+	{
+		OutIndices.Reset();
+
+		for (const FHitResult& Hit : Hits)
+		{
+			if (const int32* Index = CapsuleIndices.Find(Hit.GetComponent()))
+			{
+				OutIndices.AddUnique(*Index);
+			}
+		}
+
+		OutIndices.Sort();
+	}
+
+	/** Runs the benchmark for a single target count and logs the results */
+	void Run(UWorld* World, int32 TargetCount)
+	{
+		// use a fixed seed so runs are comparable
+		FRandomStream Random(TargetCount);
+
+		// spawn a transient actor far away from the level to hold the physics capsules
+		const FVector Origin(0.0f, 0.0f, -100000.0f);
+
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.ObjectFlags |= RF_Transient;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+		AActor* Holder = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform(Origin), SpawnParams);
+
+		if (!Holder)
+		{
+			return;
+		}
+
+		FCombatHurtboxSoA Hurtboxes;
+		TMap<const UPrimitiveComponent*, int32> CapsuleIndices;
+
+		for (int32 i = 0; i < TargetCount; ++i)
+		{
+			const FVector Location = Origin + FVector(Random.FRandRange(-AreaExtent, AreaExtent), Random.FRandRange(-AreaExtent, AreaExtent), 0.0f);
+
+			UCapsuleComponent* Capsule = NewObject<UCapsuleComponent>(Holder);
+			Capsule->InitCapsuleSize(TargetRadius, TargetHalfHeight);
+			Capsule->SetCollisionProfileName(FName("Pawn"));
+			Capsule->SetWorldLocation(Location);
+			Capsule->RegisterComponent();
+
+			CapsuleIndices.Add(Capsule, Hurtboxes.Add(Location, TargetRadius, TargetHalfHeight));
+		}
+
+		// build a set of attack sweeps scattered across the same area
+		TArray<FVector> SweepStarts;
+		TArray<FVector> SweepEnds;
+
+		for (int32 i = 0; i < Iterations; ++i)
+		{
+			const FVector Start = Origin + FVector(Random.FRandRange(-AreaExtent, AreaExtent), Random.FRandRange(-AreaExtent, AreaExtent), Random.FRandRange(-TargetHalfHeight, TargetHalfHeight));
+			const FVector Direction = FVector(Random.FRandRange(-1.0f, 1.0f), Random.FRandRange(-1.0f, 1.0f), 0.0f).GetSafeNormal();
+
+			SweepStarts.Add(Start);
+			SweepEnds.Add(Start + Direction * SweepDistance);
+		}
+
+		// time the physics sweeps
+		FCollisionObjectQueryParams ObjectParams;
+		ObjectParams.AddObjectTypesToQuery(ECC_Pawn);
+
+		FCollisionShape CollisionSphere;
+		CollisionSphere.SetSphere(SweepRadius);
+
+		TArray<FHitResult> OutHits;
+		int32 PhysicsHits = 0;
+
+		double StartTime = FPlatformTime::Seconds();
+
+		for (int32 i = 0; i < Iterations; ++i)
+		{
+			OutHits.Reset();
+			World->SweepMultiByObjectType(OutHits, SweepStarts[i], SweepEnds[i], FQuat::Identity, ObjectParams, CollisionSphere);
+			PhysicsHits += OutHits.Num();
+		}
+
+		const double PhysicsTime = FPlatformTime::Seconds() - StartTime;
+
+		// time the scalar reference
+		TArray<FCombatHurtboxHit> KernelHits;
+		int32 ScalarHits = 0;
+
+		StartTime = FPlatformTime::Seconds();
+
+		for (int32 i = 0; i < Iterations; ++i)
+		{
+			KernelHits.Reset();
+			FCombatHurtboxKernel::SweepSphereScalar(Hurtboxes, SweepStarts[i], SweepEnds[i], SweepRadius, KernelHits);
+			ScalarHits += KernelHits.Num();
+		}
+
+		const double ScalarTime = FPlatformTime::Seconds() - StartTime;
+
+		// time the vectorized kernel
+		int32 VectorHits = 0;
+
+		StartTime = FPlatformTime::Seconds();
+
+		for (int32 i = 0; i < Iterations; ++i)
+		{
+			KernelHits.Reset();
+			FCombatHurtboxKernel::SweepSphere(Hurtboxes, SweepStarts[i], SweepEnds[i], SweepRadius, KernelHits);
+			VectorHits += KernelHits.Num();
+		}
+
+		const double VectorTime = FPlatformTime::Seconds() - StartTime;
+
+		// report the average time per sweep in microseconds
+		const double Scale = 1000000.0 / Iterations;
+
+		UE_LOG(LogEscapeGame, Log, TEXT("Hurtbox kernel benchmark, %d targets: physics %.3fus (%d hits), scalar %.3fus (%d hits), vectorized %.3fus (%d hits)"),
+			TargetCount,
+			PhysicsTime * Scale, PhysicsHits,
+			ScalarTime * Scale, ScalarHits,
+			VectorTime * Scale, VectorHits);
+
+		// check every sweep outside of the timed loops. The kernels must agree with each other and with the physics scene
+		TArray<int32> PhysicsIndices;
+		TArray<int32> ScalarIndices;
+		TArray<int32> VectorIndices;
+
+		int32 VectorMismatches = 0;
+		int32 PhysicsMismatches = 0;
+		int32 MismatchedSweeps = 0;
+		int32 FirstMismatch = INDEX_NONE;
+
+		for (int32 i = 0; i < Iterations; ++i)
+		{
+			OutHits.Reset();
+			World->SweepMultiByObjectType(OutHits, SweepStarts[i], SweepEnds[i], FQuat::Identity, ObjectParams, CollisionSphere);
+			GetHitIndices(OutHits, CapsuleIndices, PhysicsIndices);
+
+			KernelHits.Reset();
+			FCombatHurtboxKernel::SweepSphereScalar(Hurtboxes, SweepStarts[i], SweepEnds[i], SweepRadius, KernelHits);
+			GetHitIndices(KernelHits, ScalarIndices);
+
+			KernelHits.Reset();
+			FCombatHurtboxKernel::SweepSphere(Hurtboxes, SweepStarts[i], SweepEnds[i], SweepRadius, KernelHits);
+			GetHitIndices(KernelHits, VectorIndices);
+
+			const bool bVectorMismatch = VectorIndices != ScalarIndices;
+			const bool bPhysicsMismatch = ScalarIndices != PhysicsIndices;
+
+			VectorMismatches += bVectorMismatch ? 1 : 0;
+			PhysicsMismatches += bPhysicsMismatch ? 1 : 0;
+
+			if (bVectorMismatch || bPhysicsMismatch)
+			{
+				FirstMismatch = FirstMismatch == INDEX_NONE ? i : FirstMismatch;
+				++MismatchedSweeps;
+			}
+		}
+
+		if (MismatchedSweeps > 0)
+		{
+			UE_LOG(LogEscapeGame, Error, TEXT("Hurtbox kernel benchmark, %d targets: hits don't match on %d of %d sweeps (vectorized vs scalar: %d, scalar vs physics: %d). First mismatch at sweep %d"),
+				TargetCount,
+				MismatchedSweeps, Iterations,
+				VectorMismatches, PhysicsMismatches,
+				FirstMismatch);
+		}
+
+		// clean up the physics capsules
+		Holder->Destroy();
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs CombatBenchmarkHurtboxKernelCommand(
+	TEXT("Combat.BenchmarkHurtboxKernel"),
+	TEXT("Times the vectorized hurtbox kernel against SweepMultiByObjectType, and logs an error if their hits don't match. Optionally takes a list of target counts, defaults to 10 100 1000."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (!World)
+		{
+			return;
+		}
+
+		TArray<int32> TargetCounts;
+
+		for (const FString& Arg : Args)
+		{
+			const int32 Count = FCString::Atoi(*Arg);
+
+			if (Count > 0)
+			{
+				TargetCounts.Add(Count);
+			}
+		}
+
+		if (TargetCounts.IsEmpty())
+		{
+			TargetCounts = { 10, 100, 1000 };
+		}
+
+		for (int32 TargetCount : TargetCounts)
+		{
+			CombatHurtboxKernelBenchmark::Run(World, TargetCount);
+		}
+	})
+);
+
+#endif // !UE_BUILD_SHIPPING
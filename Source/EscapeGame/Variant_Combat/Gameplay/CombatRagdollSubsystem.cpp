@@ -0,0 +1,231 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatRagdollSubsystem.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Animation/AnimInstance.h"
+#include "Animation/AnimMontage.h"
+#include "GameFramework/PlayerController.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Engine/World.h"
+#include "PhysicsEngine/BodyInstance.h"
+
+bool UCombatRagdollSubsystem::RequestRagdoll(USkeletalMeshComponent* Mesh, float Significance, UAnimMontage* FallbackMontage)
+{
+	// ensure the mesh is valid
+	if (!IsValid(Mesh))
+	{
+		return false;
+	}
+
+	// make sure the active list is up to date before we count it
+	PruneRagdolls();
+
+	// is this mesh already simulating?
+	if (ActiveRagdolls.ContainsByPredicate([Mesh](const FCombatRagdollEntry& Entry) { return Entry.Mesh.Get() == Mesh; }))
+	{
+		return true;
+	}
+
+	bool bGranted = ActiveRagdolls.Num() < MaxActiveRagdolls;
+
+	// over budget, so try to evict a lower priority ragdoll
+	if (!bGranted && ActiveRagdolls.Num() > 0)
+	{
+		int32 LowestIndex = INDEX_NONE;
+		float LowestPriority = TNumericLimits<float>::Max();
+
+		for (int32 i = 0; i < ActiveRagdolls.Num(); ++i)
+		{
+			const float Priority = GetPriority(ActiveRagdolls[i].Mesh.Get(), ActiveRagdolls[i].Significance);
+
+			if (Priority < LowestPriority)
+			{
+				LowestPriority = Priority;
+				LowestIndex = i;
+			}
+		}
+
+		if (GetPriority(Mesh, Significance) > LowestPriority)
+		{
+			// freeze the evicted ragdoll where it is
+			FreezePose(ActiveRagdolls[LowestIndex].Mesh.Get());
+			ActiveRagdolls.RemoveAtSwap(LowestIndex);
+
+			bGranted = true;
+		}
+	}
+
+	if (bGranted)
+	{
+		// enable full ragdoll physics
+		FCombatRagdollEntry& NewEntry = ActiveRagdolls.AddDefaulted_GetRef();
+		NewEntry.Mesh = Mesh;
+		NewEntry.Significance = Significance;
+		NewEntry.StartTime = GetWorld()->GetTimeSeconds();
+
+		Mesh->SetSimulatePhysics(true);
+
+		return true;
+	}
+
+	// play the fallback death animation if we have one
+	if (FallbackMontage)
+	{
+		if (UAnimInstance* AnimInstance = Mesh->GetAnimInstance())
+		{
+			AnimInstance->StopAllMontages(0.0f);
+
+			if (AnimInstance->Montage_Play(FallbackMontage) > 0.0f)
+			{
+				return false;
+			}
+		}
+	}
+
+	// otherwise just hold the current pose
+	FreezePose(Mesh);
+
+	return false;
+}
+
+void UCombatRagdollSubsystem::ReleaseRagdoll(const USkeletalMeshComponent* Mesh)
+{
+	ActiveRagdolls.RemoveAllSwap([Mesh](const FCombatRagdollEntry& Entry)
+	{
+		return Entry.Mesh.Get() == Mesh;
+	});
+}
+
+void UCombatRagdollSubsystem::FreezePose(USkeletalMeshComponent* Mesh)
+{
+	if (!IsValid(Mesh))
+	{
+		return;
+	}
+
+	// stop refreshing the bones first, so the current pose is kept when physics turns off
+	Mesh->bNoSkeletonUpdate = true;
+
+	// stop simulating
+	Mesh->SetSimulatePhysics(false);
+
+	// nothing left to tick
+	Mesh->SetComponentTickEnabled(false);
+}
+
+void UCombatRagdollSubsystem::ThawPose(USkeletalMeshComponent* Mesh)
+{
+	if (!IsValid(Mesh))
+	{
+		return;
+	}
+
+	// resume bone updates and ticking
+	Mesh->bNoSkeletonUpdate = false;
+	Mesh->SetComponentTickEnabled(true);
+}
+
+void UCombatRagdollSubsystem::Tick(float DeltaTime)
+{
+	PruneRagdolls();
+
+	const double CurrentTime = GetWorld()->GetTimeSeconds();
+
+	for (int32 i = ActiveRagdolls.Num() - 1; i >= 0; --i)
+	{
+		FCombatRagdollEntry& Entry = ActiveRagdolls[i];
+
+		// give new ragdolls time to get moving
+		if (CurrentTime - Entry.StartTime < MinSimulationTime)
+		{
+			continue;
+		}
+
+		// count how long the ragdoll has been at rest
+		Entry.SettledFrames = IsAtRest(Entry.Mesh.Get()) ? Entry.SettledFrames + 1 : 0;
+
+		// has it been resting long enough?
+		if (Entry.SettledFrames >= SettleFrames)
+		{
+			// hold the final pose and free up the slot
+			FreezePose(Entry.Mesh.Get());
+			ActiveRagdolls.RemoveAtSwap(i);
+		}
+	}
+}
+
+TStatId UCombatRagdollSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCombatRagdollSubsystem, STATGROUP_Tickables);
+}
+
+void UCombatRagdollSubsystem::Deinitialize()
+{
+	// clear the active list
+	ActiveRagdolls.Empty();
+
+	Super::Deinitialize();
+}
+
+float UCombatRagdollSubsystem::GetPriority(const USkeletalMeshComponent* Mesh, float Significance) const
+{
+	if (!Mesh)
+	{
+		return 0.0f;
+	}
+
+	// find the distance to the closest player camera
+	float ClosestDistanceSquared = TNumericLimits<float>::Max();
+
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController = It->Get();
+
+		if (PlayerController && PlayerController->PlayerCameraManager)
+		{
+			ClosestDistanceSquared = FMath::Min(ClosestDistanceSquared, static_cast<float>(FVector::DistSquared(PlayerController->PlayerCameraManager->GetCameraLocation(), Mesh->GetComponentLocation())));
+		}
+	}
+
+	// no cameras, so only the significance matters
+	if (ClosestDistanceSquared == TNumericLimits<float>::Max())
+	{
+		return Significance;
+	}
+
+	// scale the significance down with distance
+	return Significance / (1.0f + (FMath::Sqrt(ClosestDistanceSquared) / FMath::Max(PriorityFalloffDistance, 1.0f)));
+}
+
+void UCombatRagdollSubsystem::PruneRagdolls()
+{
+	ActiveRagdolls.RemoveAllSwap([](const FCombatRagdollEntry& Entry)
+	{
+		const USkeletalMeshComponent* Mesh = Entry.Mesh.Get();
+		return !IsValid(Mesh) || !Mesh->IsSimulatingPhysics();
+	});
+}
+
+bool UCombatRagdollSubsystem::IsAtRest(const USkeletalMeshComponent* Mesh) const
+{
+	const float LinearSpeedSquared = FMath::Square(SettleLinearSpeed);
+	const float AngularSpeedSquared = FMath::Square(FMath::DegreesToRadians(SettleAngularSpeed));
+
+	for (const FBodyInstance* Body : Mesh->Bodies)
+	{
+		// ignore bodies that aren't simulating
+		if (!Body || !Body->IsInstanceSimulatingPhysics())
+		{
+			continue;
+		}
+
+		// any moving body keeps the whole ragdoll awake
+		if (Body->GetUnrealWorldVelocity().SizeSquared() > LinearSpeedSquared || Body->GetUnrealWorldAngularVelocityInRadians().SizeSquared() > AngularSpeedSquared)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,111 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CombatRagdollSubsystem.generated.h"
+
+class USkeletalMeshComponent;
+class UAnimMontage;
+
+/** A skeletal mesh currently granted full ragdoll physics */
+struct FCombatRagdollEntry
+{
+	/** Simulating mesh */
+	TWeakObjectPtr<USkeletalMeshComponent> Mesh;
+
+	/** Gameplay importance of this ragdoll, as provided by its owner */
+	float Significance = 1.0f;
+
+	/** Number of consecutive frames all of the mesh's bodies have been at rest */
+	int32 SettledFrames = 0;
+
+	/** World time when the ragdoll started simulating */
+	double StartTime = 0.0;
+};
+
+/**
+ *  Caps the number of skeletal meshes simulating full ragdoll physics at the same time.
+ *  Ragdolls are prioritized by significance and distance to the nearest player camera.
+ *  When over budget, the lowest priority ragdoll is frozen in place, or the new request falls back to a death montage or a frozen pose.
+ *  Ragdolls that come to rest are frozen in their final pose, freeing their slot in the budget.
+ */
+UCLASS(config=Game)
+class UCombatRagdollSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Maximum number of meshes simulating ragdoll physics at the same time */
+	UPROPERTY(Config)
+	int32 MaxActiveRagdolls = 6;
+
+	/** Distance from the camera at which a ragdoll's priority is halved */
+	UPROPERTY(Config)
+	float PriorityFalloffDistance = 1500.0f;
+
+	/** Linear speed below which a body is considered at rest */
+	UPROPERTY(Config)
+	float SettleLinearSpeed = 5.0f;
+
+	/** Angular speed, in degrees per second, below which a body is considered at rest */
+	UPROPERTY(Config)
+	float SettleAngularSpeed = 10.0f;
+
+	/** Number of consecutive frames a ragdoll must be at rest before it's frozen */
+	UPROPERTY(Config)
+	int32 SettleFrames = 10;
+
+	/** Minimum time a ragdoll simulates before it can be frozen, so it has a chance to start falling */
+	UPROPERTY(Config)
+	float MinSimulationTime = 0.5f;
+
+	/** Meshes currently simulating */
+	TArray<FCombatRagdollEntry> ActiveRagdolls;
+
+public:
+
+	/**
+	 *  Requests full ragdoll physics for a mesh. If granted, physics simulation is enabled and true is returned.
+	 *  Otherwise, the fallback montage is played, or the mesh is frozen in its current pose if there's none.
+	 *  The fallback montage should not auto blend out, so the final pose is held.
+	 */
+	bool RequestRagdoll(USkeletalMeshComponent* Mesh, float Significance, UAnimMontage* FallbackMontage);
+
+	/** Removes a mesh from the budget, without changing its physics state */
+	void ReleaseRagdoll(const USkeletalMeshComponent* Mesh);
+
+	/** Stops simulating a mesh and holds its current pose */
+	static void FreezePose(USkeletalMeshComponent* Mesh);
+
+	/** Restores bone updates on a mesh previously frozen */
+	static void ThawPose(USkeletalMeshComponent* Mesh);
+
+public:
+
+	// ~begin UTickableWorldSubsystem interface
+
+	/** Drops ragdolls that are no longer simulating and freezes any that have settled */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Returns the stat ID for the tickable */
+	virtual TStatId GetStatId() const override;
+
+	/** Cleanup */
+	virtual void Deinitialize() override;
+
+	// ~end UTickableWorldSubsystem interface
+
+protected:
+
+	/** Returns the priority of a mesh, from its significance and its distance to the nearest player camera */
+	float GetPriority(const USkeletalMeshComponent* Mesh, float Significance) const;
+
+	/** Removes entries whose meshes are gone or no longer simulating */
+	void PruneRagdolls();
+
+	/** Returns true if all of the mesh's simulated bodies are below the settle speeds */
+	bool IsAtRest(const USkeletalMeshComponent* Mesh) const;
+};
@@ -0,0 +1,338 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatTargetGridSubsystem.h"
+#include "CombatDamageable.h"
+#include "CombatHurtboxHistoryComponent.h"
+#include "Components/PrimitiveComponent.h"
+#include "Components/CapsuleComponent.h"
+#include "GameFramework/Actor.h"
+
+void UCombatTargetGridSubsystem::RegisterTarget(AActor* Actor, UPrimitiveComponent* Shape, ECombatTargetType Type)
+{
+	// ensure we have a valid actor and shape
+	if (!IsValid(Actor) || !IsValid(Shape))
+	{
+		return;
+	}
+
+	// only damageable actors can be registered
+	ICombatDamageable* Damageable = Cast<ICombatDamageable>(Actor);
+
+	if (!Damageable)
+	{
+		return;
+	}
+
+	// ignore repeated registrations
+	if (ActorEntries.Contains(Actor))
+	{
+		return;
+	}
+
+	FCombatTargetGridEntry NewEntry;
+	NewEntry.Actor = Actor;
+	NewEntry.Shape = Shape;
+	NewEntry.Damageable = Damageable;
+	NewEntry.History = Actor->FindComponentByClass<UCombatHurtboxHistoryComponent>();
+	NewEntry.Location = Shape->Bounds.Origin;
+	NewEntry.Cell = GetCell(NewEntry.Location);
+	NewEntry.Type = Type;
+
+	// use the exact capsule dimensions if we can, otherwise approximate from the bounds
+	if (const UCapsuleComponent* Capsule = Cast<UCapsuleComponent>(Shape))
+	{
+		NewEntry.Radius = Capsule->GetScaledCapsuleRadius();
+		NewEntry.HalfHeight = Capsule->GetScaledCapsuleHalfHeight();
+	}
+	else
+	{
+		const FVector Extent = Shape->Bounds.BoxExtent;
+		NewEntry.Radius = FMath::Max(Extent.X, Extent.Y);
+		NewEntry.HalfHeight = FMath::Max(Extent.Z, NewEntry.Radius);
+	}
+
+	MaxTargetRadius = FMath::Max(MaxTargetRadius, NewEntry.Radius);
+
+	// add the entry and bucket it
+	const int32 EntryIndex = Entries.Add(NewEntry);
+	ActorEntries.Add(Actor, EntryIndex);
+	AddToCell(EntryIndex, NewEntry.Cell);
+}
+
+void UCombatTargetGridSubsystem::UnregisterTarget(const AActor* Actor)
+{
+	int32 EntryIndex;
+
+	if (ActorEntries.RemoveAndCopyValue(Actor, EntryIndex))
+	{
+		RemoveFromCell(EntryIndex, Entries[EntryIndex].Cell);
+		Entries.RemoveAt(EntryIndex);
+	}
+}
+
+bool UCombatTargetGridSubsystem::IsTargetRegistered(const AActor* Actor) const
+{
+	return ActorEntries.Contains(Actor);
+}
+
+void UCombatTargetGridSubsystem::QuerySphere(const FVector& Center, float Radius, ECombatTargetType Types, const AActor* IgnoreActor, TArray<FCombatTargetCandidate>& OutCandidates) const
+{
+	// a sphere is a capsule with a zero length segment
+	QueryCapsule(Center, Center, Radius, Types, IgnoreActor, OutCandidates);
+}
+
+void UCombatTargetGridSubsystem::QueryCapsule(const FVector& Start, const FVector& End, float Radius, ECombatTargetType Types, const AActor* IgnoreActor, TArray<FCombatTargetCandidate>& OutCandidates) const
+{
+	QueryCapsuleInternal(Start, End, Radius, TOptional<double>(), Types, IgnoreActor, OutCandidates);
+}
+
+void UCombatTargetGridSubsystem::QueryCapsuleAtTime(const FVector& Start, const FVector& End, float Radius, double Time, ECombatTargetType Types, const AActor* IgnoreActor, TArray<FCombatTargetCandidate>& OutCandidates) const
+{
+	QueryCapsuleInternal(Start, End, Radius, Time, Types, IgnoreActor, OutCandidates);
+}
+
+void UCombatTargetGridSubsystem::QueryCapsuleInternal(const FVector& Start, const FVector& End, float Radius, TOptional<double> RewindTime, ECombatTargetType Types, const AActor* IgnoreActor, TArray<FCombatTargetCandidate>& OutCandidates) const
+{
+	// build the query bounds. Rewound targets may have been somewhere else, so pad them
+	FBox QueryBounds(ForceInit);
+	QueryBounds += Start;
+	QueryBounds += End;
+	QueryBounds = QueryBounds.ExpandBy(Radius + (RewindTime.IsSet() ? RewindQueryPadding : 0.0f));
+
+	// gather the candidates in the overlapped cells and pack them for the kernel
+	ScratchHurtboxes.Reset();
+	ScratchEntries.Reset();
+
+	ForEachEntryInBounds(QueryBounds, Types, IgnoreActor, [&](const FCombatTargetGridEntry& Entry)
+	{
+		// use the target's past hurtbox if we're rewinding and it has one
+		FCombatHurtboxSample Sample;
+		const UCombatHurtboxHistoryComponent* History = Entry.History.Get();
+
+		if (RewindTime.IsSet() && History && History->GetHurtboxAtTime(RewindTime.GetValue(), Sample))
+		{
+			ScratchHurtboxes.Add(Sample.Location, Sample.Radius, Sample.HalfHeight);
+		}
+		else
+		{
+			ScratchHurtboxes.Add(Entry.Location, Entry.Radius, Entry.HalfHeight);
+		}
+
+		ScratchEntries.Add(&Entry);
+	});
+
+	if (ScratchEntries.IsEmpty())
+	{
+		return;
+	}
+
+	// run the exact test on all candidates at once
+	ScratchHits.Reset();
+	FCombatHurtboxKernel::SweepSphere(ScratchHurtboxes, Start, End, Radius, ScratchHits);
+
+	for (const FCombatHurtboxHit& Hit : ScratchHits)
+	{
+		const FCombatTargetGridEntry& Entry = *ScratchEntries[Hit.Index];
+
+		FCombatTargetCandidate& Candidate = OutCandidates.AddDefaulted_GetRef();
+		Candidate.Actor = Entry.Actor.Get();
+		Candidate.Damageable = Entry.Damageable;
+		Candidate.ImpactPoint = Hit.ImpactPoint;
+		Candidate.ImpactNormal = Hit.ImpactNormal;
+	}
+}
+
+void UCombatTargetGridSubsystem::QueryCone(const FVector& Origin, const FVector& Direction, float Length, float HalfAngleDegrees, ECombatTargetType Types, const AActor* IgnoreActor, TArray<FCombatTargetCandidate>& OutCandidates) const
+{
+	const FVector ConeDirection = Direction.GetSafeNormal();
+	const float HalfAngle = FMath::DegreesToRadians(FMath::Clamp(HalfAngleDegrees, 0.0f, 180.0f));
+
+	// the cone is fully contained in a sphere of its length
+	const FBox QueryBounds = FBox(Origin, Origin).ExpandBy(Length);
+
+	ForEachEntryInBounds(QueryBounds, Types, IgnoreActor, [&](const FCombatTargetGridEntry& Entry)
+	{
+		FVector EntryBottom, EntryTop;
+		GetEntrySegment(Entry, EntryBottom, EntryTop);
+
+		// find the closest point on the target's segment to the cone apex
+		const FVector PointOnEntry = FMath::ClosestPointOnSegment(Origin, EntryBottom, EntryTop);
+		const FVector ToEntry = PointOnEntry - Origin;
+		const float Distance = ToEntry.Size();
+
+		// is the target within reach?
+		if (Distance - Entry.Radius > Length)
+		{
+			return;
+		}
+
+		// targets overlapping the apex are always inside the cone
+		if (Distance > Entry.Radius)
+		{
+			// widen the cone by the angle the target's radius subtends from the apex
+			const float AngleToEntry = FMath::Acos(FMath::Clamp(ToEntry.GetUnsafeNormal() | ConeDirection, -1.0f, 1.0f));
+			const float AngularRadius = FMath::Asin(Entry.Radius / Distance);
+
+			if (AngleToEntry - AngularRadius > HalfAngle)
+			{
+				return;
+			}
+		}
+
+		MakeCandidate(Entry, PointOnEntry, Origin, -ConeDirection, OutCandidates.AddDefaulted_GetRef());
+	});
+}
+
+void UCombatTargetGridSubsystem::Tick(float DeltaTime)
+{
+	TArray<int32, TInlineAllocator<8>> StaleEntries;
+
+	for (TSparseArray<FCombatTargetGridEntry>::TIterator It(Entries); It; ++It)
+	{
+		FCombatTargetGridEntry& Entry = *It;
+
+		// drop targets whose shape has gone away without unregistering
+		const UPrimitiveComponent* Shape = Entry.Shape.Get();
+
+		if (!Shape || !Entry.Actor.IsValid())
+		{
+			StaleEntries.Add(It.GetIndex());
+			continue;
+		}
+
+		// update the location and move to a new cell if needed
+		Entry.Location = Shape->Bounds.Origin;
+
+		const FIntPoint NewCell = GetCell(Entry.Location);
+
+		if (NewCell != Entry.Cell)
+		{
+			RemoveFromCell(It.GetIndex(), Entry.Cell);
+			AddToCell(It.GetIndex(), NewCell);
+			Entry.Cell = NewCell;
+		}
+	}
+
+	for (int32 EntryIndex : StaleEntries)
+	{
+		RemoveEntry(EntryIndex);
+	}
+}
+
+TStatId UCombatTargetGridSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCombatTargetGridSubsystem, STATGROUP_Tickables);
+}
+
+void UCombatTargetGridSubsystem::Deinitialize()
+{
+	// clear all grid data
+	Entries.Empty();
+	Cells.Empty();
+	ActorEntries.Empty();
+
+	Super::Deinitialize();
+}
+
+FIntPoint UCombatTargetGridSubsystem::GetCell(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt32(Location.X / CellSize), FMath::FloorToInt32(Location.Y / CellSize));
+}
+
+void UCombatTargetGridSubsystem::AddToCell(int32 EntryIndex, const FIntPoint& Cell)
+{
+	Cells.FindOrAdd(Cell).Add(EntryIndex);
+}
+
+void UCombatTargetGridSubsystem::RemoveFromCell(int32 EntryIndex, const FIntPoint& Cell)
+{
+	if (TArray<int32>* CellEntries = Cells.Find(Cell))
+	{
+		CellEntries->RemoveSingleSwap(EntryIndex, EAllowShrinking::No);
+
+		// release empty cells so the map doesn't grow unbounded as targets roam
+		if (CellEntries->IsEmpty())
+		{
+			Cells.Remove(Cell);
+		}
+	}
+}
+
+void UCombatTargetGridSubsystem::RemoveEntry(int32 EntryIndex)
+{
+	const FCombatTargetGridEntry& Entry = Entries[EntryIndex];
+
+	RemoveFromCell(EntryIndex, Entry.Cell);
+
+	// the actor may already be gone, so remove by value
+	for (TMap<const AActor*, int32>::TIterator It(ActorEntries); It; ++It)
+	{
+		if (It.Value() == EntryIndex)
+		{
+			It.RemoveCurrent();
+			break;
+		}
+	}
+
+	Entries.RemoveAt(EntryIndex);
+}
+
+void UCombatTargetGridSubsystem::ForEachEntryInBounds(const FBox& Bounds, ECombatTargetType Types, const AActor* IgnoreActor, TFunctionRef<void(const FCombatTargetGridEntry&)> Visitor) const
+{
+	// pad the bounds so we catch targets centered in neighboring cells
+	const FBox PaddedBounds = Bounds.ExpandBy(FVector(MaxTargetRadius, MaxTargetRadius, 0.0f));
+
+	const FIntPoint MinCell = GetCell(PaddedBounds.Min);
+	const FIntPoint MaxCell = GetCell(PaddedBounds.Max);
+
+	for (int32 CellX = MinCell.X; CellX <= MaxCell.X; ++CellX)
+	{
+		for (int32 CellY = MinCell.Y; CellY <= MaxCell.Y; ++CellY)
+		{
+			const TArray<int32>* CellEntries = Cells.Find(FIntPoint(CellX, CellY));
+
+			if (!CellEntries)
+			{
+				continue;
+			}
+
+			for (int32 EntryIndex : *CellEntries)
+			{
+				const FCombatTargetGridEntry& Entry = Entries[EntryIndex];
+
+				// filter by type and ignored actor
+				if (!EnumHasAnyFlags(Entry.Type, Types) || Entry.Actor.Get() == IgnoreActor || !Entry.Actor.IsValid())
+				{
+					continue;
+				}
+
+				Visitor(Entry);
+			}
+		}
+	}
+}
+
+void UCombatTargetGridSubsystem::GetEntrySegment(const FCombatTargetGridEntry& Entry, FVector& OutBottom, FVector& OutTop)
+{
+	const float SegmentHalfLength = FMath::Max(Entry.HalfHeight - Entry.Radius, 0.0f);
+
+	OutBottom = Entry.Location - FVector(0.0f, 0.0f, SegmentHalfLength);
+	OutTop = Entry.Location + FVector(0.0f, 0.0f, SegmentHalfLength);
+}
+
+void UCombatTargetGridSubsystem::MakeCandidate(const FCombatTargetGridEntry& Entry, const FVector& PointOnEntry, const FVector& PointOnQuery, const FVector& FallbackNormal, FCombatTargetCandidate& OutCandidate)
+{
+	// the normal faces from the target towards the query shape, same as a sweep's impact normal
+	FVector Normal = PointOnQuery - PointOnEntry;
+
+	if (!Normal.Normalize())
+	{
+		Normal = FallbackNormal.IsNearlyZero() ? FVector::UpVector : FallbackNormal;
+	}
+
+	OutCandidate.Actor = Entry.Actor.Get();
+	OutCandidate.Damageable = Entry.Damageable;
+	OutCandidate.ImpactNormal = Normal;
+	OutCandidate.ImpactPoint = PointOnEntry + (Normal * Entry.Radius);
+}
@@ -0,0 +1,181 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CombatHurtboxKernel.h"
+#include "CombatTargetGridSubsystem.generated.h"
+
+class ICombatDamageable;
+class UPrimitiveComponent;
+class UCombatHurtboxHistoryComponent;
+
+/** Broad categories of combat targets tracked by the target grid */
+enum class ECombatTargetType : uint8
+{
+	None = 0,
+	Pawn = 1 << 0,
+	Prop = 1 << 1,
+	All = Pawn | Prop
+};
+ENUM_CLASS_FLAGS(ECombatTargetType);
+
+/**
+ *  A damageable target returned by a target grid query,
+ *  along with the contact point and normal against the query shape
+ */
+struct FCombatTargetCandidate
+{
+	/** Actor that owns the target */
+	AActor* Actor = nullptr;
+
+	/** Damageable interface of the target actor */
+	ICombatDamageable* Damageable = nullptr;
+
+	/** Closest point on the target's surface to the query shape */
+	FVector ImpactPoint = FVector::ZeroVector;
+
+	/** Surface normal at the impact point, facing the query shape */
+	FVector ImpactNormal = FVector::ZeroVector;
+};
+
+/**
+ *  A single target registered on the grid.
+ *  Targets are approximated as vertical capsules built from their tracked component's bounds
+ */
+struct FCombatTargetGridEntry
+{
+	/** Actor that owns the target */
+	TWeakObjectPtr<AActor> Actor;
+
+	/** Component whose bounds we track as the target moves */
+	TWeakObjectPtr<UPrimitiveComponent> Shape;
+
+	/** Damageable interface of the target actor */
+	ICombatDamageable* Damageable = nullptr;
+
+	/** Optional hurtbox history, used to test the target where it was in the past */
+	TWeakObjectPtr<const UCombatHurtboxHistoryComponent> History;
+
+	/** Last known center of the target */
+	FVector Location = FVector::ZeroVector;
+
+	/** Radius of the target capsule */
+	float Radius = 0.0f;
+
+	/** Half height of the target capsule, including the hemispherical caps */
+	float HalfHeight = 0.0f;
+
+	/** Grid cell the target is currently stored in */
+	FIntPoint Cell = FIntPoint::ZeroValue;
+
+	/** Category of this target */
+	ECombatTargetType Type = ECombatTargetType::None;
+};
+
+/**
+ *  Uniform 2D grid spatial hash for combat targets.
+ *  ICombatDamageable actors register themselves on BeginPlay and are re-bucketed incrementally as they move.
+ *  Attack traces can query it for candidates with a cheap shape test instead of sweeping the physics scene.
+ */
+UCLASS(config=Game)
+class UCombatTargetGridSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Size of each grid cell. Should be comfortably larger than the typical target radius */
+	UPROPERTY(Config)
+	float CellSize = 400.0f;
+
+	/** Extra query bounds padding for rewound queries, to catch targets that have since moved away. Should cover the max rewind distance */
+	UPROPERTY(Config)
+	float RewindQueryPadding = 200.0f;
+
+	/** Registered targets */
+	TSparseArray<FCombatTargetGridEntry> Entries;
+
+	/** Entry indices bucketed by grid cell */
+	TMap<FIntPoint, TArray<int32>> Cells;
+
+	/** Maps registered actors to their entry index */
+	TMap<const AActor*, int32> ActorEntries;
+
+	/** Largest radius of any registered target, used to pad query bounds */
+	float MaxTargetRadius = 0.0f;
+
+	/** Scratch storage for capsule query candidates, packed for the hurtbox kernel */
+	mutable FCombatHurtboxSoA ScratchHurtboxes;
+
+	/** Scratch storage for the entries matching each packed hurtbox */
+	mutable TArray<const FCombatTargetGridEntry*> ScratchEntries;
+
+	/** Scratch storage for hurtbox kernel hits */
+	mutable TArray<FCombatHurtboxHit> ScratchHits;
+
+public:
+
+	/** Registers a damageable actor on the grid, tracking the provided component as its shape */
+	void RegisterTarget(AActor* Actor, UPrimitiveComponent* Shape, ECombatTargetType Type);
+
+	/** Removes an actor from the grid */
+	void UnregisterTarget(const AActor* Actor);
+
+	/** Returns true if the actor is currently registered on the grid */
+	bool IsTargetRegistered(const AActor* Actor) const;
+
+	/** Finds all targets touching a sphere */
+	void QuerySphere(const FVector& Center, float Radius, ECombatTargetType Types, const AActor* IgnoreActor, TArray<FCombatTargetCandidate>& OutCandidates) const;
+
+	/** Finds all targets touching a capsule between two points. Equivalent to a swept sphere, tested with the vectorized hurtbox kernel */
+	void QueryCapsule(const FVector& Start, const FVector& End, float Radius, ECombatTargetType Types, const AActor* IgnoreActor, TArray<FCombatTargetCandidate>& OutCandidates) const;
+
+	/** Same as QueryCapsule, but tests targets with a hurtbox history where they were at the provided server time */
+	void QueryCapsuleAtTime(const FVector& Start, const FVector& End, float Radius, double Time, ECombatTargetType Types, const AActor* IgnoreActor, TArray<FCombatTargetCandidate>& OutCandidates) const;
+
+	/** Finds all targets touching a cone, given its apex, direction, length and half angle */
+	void QueryCone(const FVector& Origin, const FVector& Direction, float Length, float HalfAngleDegrees, ECombatTargetType Types, const AActor* IgnoreActor, TArray<FCombatTargetCandidate>& OutCandidates) const;
+
+public:
+
+	// ~begin UTickableWorldSubsystem interface
+
+	/** Re-buckets any targets that have moved to a different cell */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Returns the stat ID for the tickable */
+	virtual TStatId GetStatId() const override;
+
+	/** Cleanup */
+	virtual void Deinitialize() override;
+
+	// ~end UTickableWorldSubsystem interface
+
+protected:
+
+	/** Returns the grid cell containing a world location */
+	FIntPoint GetCell(const FVector& Location) const;
+
+	/** Adds an entry index to a grid cell */
+	void AddToCell(int32 EntryIndex, const FIntPoint& Cell);
+
+	/** Removes an entry index from a grid cell */
+	void RemoveFromCell(int32 EntryIndex, const FIntPoint& Cell);
+
+	/** Removes an entry from the grid */
+	void RemoveEntry(int32 EntryIndex);
+
+	/** Shared capsule query implementation. Rewinds targets to the provided time if it's set */
+	void QueryCapsuleInternal(const FVector& Start, const FVector& End, float Radius, TOptional<double> RewindTime, ECombatTargetType Types, const AActor* IgnoreActor, TArray<FCombatTargetCandidate>& OutCandidates) const;
+
+	/** Calls the visitor for every entry of the given types in the cells overlapped by the provided bounds */
+	void ForEachEntryInBounds(const FBox& Bounds, ECombatTargetType Types, const AActor* IgnoreActor, TFunctionRef<void(const FCombatTargetGridEntry&)> Visitor) const;
+
+	/** Returns the bottom and top points of the inner segment of an entry's capsule */
+	static void GetEntrySegment(const FCombatTargetGridEntry& Entry, FVector& OutBottom, FVector& OutTop);
+
+	/** Fills out a candidate from an entry and the closest points between the entry and the query shape */
+	static void MakeCandidate(const FCombatTargetGridEntry& Entry, const FVector& PointOnEntry, const FVector& PointOnQuery, const FVector& FallbackNormal, FCombatTargetCandidate& OutCandidate);
+};
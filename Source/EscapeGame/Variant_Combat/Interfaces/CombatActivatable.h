@@ -33,4 +33,7 @@ public:
 	/** Deactivates the Interactable Actor */
 	UFUNCTION(BlueprintCallable, Category="Activatable")
 	virtual void DeactivateInteraction(AActor* ActivationInstigator) = 0;
+
+	/** Notifies the Interactable Actor that it's likely to be activated soon, so it can start loading any assets it needs */
+	virtual void PrepareInteraction(AActor* ActivationInstigator) {}
 };
@@ -0,0 +1,131 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatDuelCommandlet.h"
+#include "CombatSimulation.h"
+#include "CombatEnemyArchetype.h"
+#include "CombatEnemyArchetypeSubsystem.h"
+#include "CombatCharacter.h"
+#include "CombatEnemy.h"
+#include "EscapeGame.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/Parse.h"
+
+UCombatDuelCommandlet::UCombatDuelCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UCombatDuelCommandlet::Main(const FString& Params)
+{
+	int32 NumDuels = 10000;
+	int32 Seed = 1;
+
+	FParse::Value(*Params, TEXT("Duels="), NumDuels);
+	FParse::Value(*Params, TEXT("Seed="), Seed);
+
+	FString PlayerClassPath = TEXT("/Game/Variant_Combat/Blueprints/BP_CombatCharacter.BP_CombatCharacter_C");
+	FString EnemyClassPath = TEXT("/Game/Variant_Combat/Blueprints/AI/BP_CombatEnemy.BP_CombatEnemy_C");
+
+	FParse::Value(*Params, TEXT("PlayerClass="), PlayerClassPath);
+	FParse::Value(*Params, TEXT("EnemyClass="), EnemyClassPath);
+
+	UClass* PlayerClass = LoadClass<ACombatCharacter>(nullptr, *PlayerClassPath);
+	UClass* EnemyClass = LoadClass<ACombatEnemy>(nullptr, *EnemyClassPath);
+
+	// don't fall back to hardcoded values, or the results would silently drift from the game
+	if (!PlayerClass || !EnemyClass)
+	{
+		UE_LOG(LogEscapeGame, Error, TEXT("Combat duels: couldn't load the player class [%s] or the enemy class [%s]"), *PlayerClassPath, *EnemyClassPath);
+		return 1;
+	}
+
+	// fighter A uses the player's class defaults. The charged attack chance models player behavior, so it isn't part of the character's tuning
+	const ACombatCharacter* Player = GetDefault<ACombatCharacter>(PlayerClass);
+
+	FCombatDuelFighter FighterA;
+	FighterA.MaxHP = Player->GetMaxHP();
+	FighterA.MeleeDamage = Player->GetMeleeDamage();
+	FighterA.NumComboSections = Player->GetNumComboSections();
+	FighterA.ChargedAttackChance = 0.2f;
+	ParseFighter(*Params, TEXT("A."), FighterA);
+
+	// fighter B uses the enemy class archetype, or the default archetype if it doesn't have one
+	FCombatEnemyArchetypeData EnemyArchetype = UCombatEnemyArchetypeSubsystem::GetDefaultArchetype();
+
+	if (const UCombatEnemyArchetype* Archetype = GetDefault<ACombatEnemy>(EnemyClass)->GetArchetype())
+	{
+		Archetype->Compile(EnemyArchetype);
+	}
+
+	FCombatDuelFighter FighterB;
+	FighterB.MaxHP = EnemyArchetype.MaxHP;
+	FighterB.MeleeDamage = EnemyArchetype.MeleeDamage;
+	FighterB.NumComboSections = EnemyArchetype.ComboSectionNames.Num();
+	FighterB.MinChargeLoops = EnemyArchetype.MinChargeLoops;
+	FighterB.MaxChargeLoops = EnemyArchetype.MaxChargeLoops;
+	ParseFighter(*Params, TEXT("B."), FighterB);
+
+	// run every duel with its own seed derived from the base seed, so any single duel can be reproduced
+	int32 Wins[2] = { 0, 0 };
+	int32 Draws = 0;
+	int64 HitsLanded[2] = { 0, 0 };
+	double TotalDuration = 0.0;
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	for (int32 DuelIndex = 0; DuelIndex < NumDuels; ++DuelIndex)
+	{
+		const FCombatDuelResult Result = FCombatDuelSimulation::Run(FighterA, FighterB, static_cast<int32>(HashCombine(GetTypeHash(Seed), GetTypeHash(DuelIndex))));
+
+		if (Result.Winner == INDEX_NONE)
+		{
+			++Draws;
+		}
+		else
+		{
+			++Wins[Result.Winner];
+		}
+
+		HitsLanded[0] += Result.HitsLanded[0];
+		HitsLanded[1] += Result.HitsLanded[1];
+		TotalDuration += Result.Duration;
+	}
+
+	const double ElapsedTime = FPlatformTime::Seconds() - StartTime;
+	const double InvDuels = 1.0 / FMath::Max(NumDuels, 1);
+
+	UE_LOG(LogEscapeGame, Display, TEXT("Combat duels: %d duels, seed %d, %.3f s (%.0f duels/s)"), NumDuels, Seed, ElapsedTime, NumDuels / FMath::Max(ElapsedTime, UE_DOUBLE_SMALL_NUMBER));
+	UE_LOG(LogEscapeGame, Display, TEXT("  A wins: %.1f%%  B wins: %.1f%%  draws: %.1f%%"), Wins[0] * InvDuels * 100.0, Wins[1] * InvDuels * 100.0, Draws * InvDuels * 100.0);
+	UE_LOG(LogEscapeGame, Display, TEXT("  average duration: %.2f s  average hits landed: A %.2f, B %.2f"), TotalDuration * InvDuels, HitsLanded[0] * InvDuels, HitsLanded[1] * InvDuels);
+
+	return 0;
+}
+
+void UCombatDuelCommandlet::ParseFighter(const TCHAR* Params, const TCHAR* Prefix, FCombatDuelFighter& Fighter)
+{
+	auto ParseFloat = [Params, Prefix](const TCHAR* Name, float& Value)
+	{
+		FParse::Value(Params, *FString::Printf(TEXT("%s%s="), Prefix, Name), Value);
+	};
+
+	auto ParseInt = [Params, Prefix](const TCHAR* Name, int32& Value)
+	{
+		FParse::Value(Params, *FString::Printf(TEXT("%s%s="), Prefix, Name), Value);
+	};
+
+	ParseFloat(TEXT("MaxHP"), Fighter.MaxHP);
+	ParseFloat(TEXT("MeleeDamage"), Fighter.MeleeDamage);
+	ParseInt(TEXT("NumComboSections"), Fighter.NumComboSections);
+	ParseInt(TEXT("MinChargeLoops"), Fighter.MinChargeLoops);
+	ParseInt(TEXT("MaxChargeLoops"), Fighter.MaxChargeLoops);
+	ParseFloat(TEXT("ChargedAttackChance"), Fighter.ChargedAttackChance);
+	ParseFloat(TEXT("HitChance"), Fighter.HitChance);
+	ParseFloat(TEXT("ComboHitTime"), Fighter.ComboHitTime);
+	ParseFloat(TEXT("ChargeLoopTime"), Fighter.ChargeLoopTime);
+	ParseFloat(TEXT("ChargedAttackTime"), Fighter.ChargedAttackTime);
+	ParseFloat(TEXT("RecoveryTime"), Fighter.RecoveryTime);
+}
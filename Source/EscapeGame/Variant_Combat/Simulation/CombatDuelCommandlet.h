@@ -0,0 +1,33 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "CombatDuelCommandlet.generated.h"
+
+struct FCombatDuelFighter;
+
+/**
+ *  Runs batches of seeded duels through the combat simulation core without loading a map.
+ *  Usage: UnrealEditor-Cmd <Project> -run=CombatDuel [-Duels=10000] [-Seed=1] [-PlayerClass=...] [-EnemyClass=...] [-A.MaxHP=5] [-B.MeleeDamage=2] ...
+ *  Fighter A is read from the player class defaults and fighter B from the enemy class archetype, so both follow the game's tuning.
+ */
+UCLASS()
+class UCombatDuelCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Constructor */
+	UCombatDuelCommandlet();
+
+	/** Runs the duels and logs a summary */
+	virtual int32 Main(const FString& Params) override;
+
+protected:
+
+	/** Overrides fighter values from the command line, using the provided prefix */
+	static void ParseFighter(const TCHAR* Params, const TCHAR* Prefix, FCombatDuelFighter& Fighter);
+};
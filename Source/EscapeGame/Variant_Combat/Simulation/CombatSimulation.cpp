@@ -0,0 +1,133 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatSimulation.h"
+
+float FCombatRules::ApplyDamage(float& CurrentHP, float Damage)
+{
+	// only process damage if the combatant is still alive
+	if (IsDead(CurrentHP))
+	{
+		return 0.0f;
+	}
+
+	CurrentHP -= Damage;
+
+	return Damage;
+}
+
+int32 FCombatRules::RollComboCount(FRandomStream& Random, int32 NumComboSections)
+{
+	// the first section is the combo start, so the string can run up to the last section
+	return Random.RandRange(1, FMath::Max(NumComboSections - 1, 1));
+}
+
+int32 FCombatRules::RollChargeLoops(FRandomStream& Random, int32 MinChargeLoops, int32 MaxChargeLoops)
+{
+	return Random.RandRange(FMath::Min(MinChargeLoops, MaxChargeLoops), FMath::Max(MinChargeLoops, MaxChargeLoops));
+}
+
+FVector FCombatRules::ComputeKnockback(const FVector& ImpactNormal, float KnockbackImpulse, float LaunchImpulse)
+{
+	return (ImpactNormal * -KnockbackImpulse) + (FVector::UpVector * LaunchImpulse);
+}
+
+/** Runtime state of a fighter in a simulated duel */
+struct FCombatDuelFighterState
+{
+	/** Current HP */
+	float CurrentHP = 0.0f;
+
+	/** Time of the fighter's next event */
+	float NextEventTime = 0.0f;
+
+	/** Hits left in the current attack. 0 while recovering */
+	int32 RemainingHits = 0;
+
+	/** Time between hits in the current attack */
+	float HitInterval = 0.0f;
+};
+
+FCombatDuelResult FCombatDuelSimulation::Run(const FCombatDuelFighter& FighterA, const FCombatDuelFighter& FighterB, int32 Seed, float MaxDuration)
+{
+	FRandomStream Random(Seed);
+
+	const FCombatDuelFighter* Fighters[2] = { &FighterA, &FighterB };
+	FCombatDuelFighterState States[2];
+
+	for (int32 i = 0; i < 2; ++i)
+	{
+		States[i].CurrentHP = Fighters[i]->MaxHP;
+
+		// stagger the first attacks so the duel doesn't start in lockstep
+		States[i].NextEventTime = Random.FRand() * Fighters[i]->RecoveryTime;
+	}
+
+	FCombatDuelResult Result;
+
+	// guard against fighters configured with zero length attacks, which would never advance time
+	constexpr int32 MaxEvents = 1000000;
+
+	for (int32 EventCount = 0; EventCount < MaxEvents; ++EventCount)
+	{
+		// process the fighter with the earliest event. Ties go to the first fighter
+		const int32 Actor = States[1].NextEventTime < States[0].NextEventTime ? 1 : 0;
+		const int32 Opponent = 1 - Actor;
+
+		const FCombatDuelFighter& Fighter = *Fighters[Actor];
+		FCombatDuelFighterState& State = States[Actor];
+
+		Result.Duration = State.NextEventTime;
+
+		if (Result.Duration > MaxDuration)
+		{
+			Result.Duration = MaxDuration;
+			break;
+		}
+
+		if (State.RemainingHits == 0)
+		{
+			// start a new attack
+			++Result.AttacksStarted[Actor];
+
+			if (Random.FRand() < Fighter.ChargedAttackChance)
+			{
+				// a charged attack lands a single hit after charging
+				const int32 ChargeLoops = FCombatRules::RollChargeLoops(Random, Fighter.MinChargeLoops, Fighter.MaxChargeLoops);
+
+				State.RemainingHits = 1;
+				State.HitInterval = 0.0f;
+				State.NextEventTime += (ChargeLoops * Fighter.ChargeLoopTime) + Fighter.ChargedAttackTime;
+			}
+			else
+			{
+				// a combo string lands a hit per stage
+				State.RemainingHits = FCombatRules::RollComboCount(Random, Fighter.NumComboSections);
+				State.HitInterval = Fighter.ComboHitTime;
+				State.NextEventTime += Fighter.ComboHitTime;
+			}
+
+			continue;
+		}
+
+		// resolve the next hit
+		if (Random.FRand() < Fighter.HitChance)
+		{
+			++Result.HitsLanded[Actor];
+
+			FCombatRules::ApplyDamage(States[Opponent].CurrentHP, Fighter.MeleeDamage);
+
+			if (FCombatRules::IsDead(States[Opponent].CurrentHP))
+			{
+				Result.Winner = Actor;
+				break;
+			}
+		}
+
+		// continue the attack, or recover once it's done
+		--State.RemainingHits;
+		State.NextEventTime += State.RemainingHits > 0 ? State.HitInterval : Fighter.RecoveryTime;
+	}
+
+	return Result;
+}
@@ -0,0 +1,99 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Math/RandomStream.h"
+
+/**
+ *  Combat rules shared by the combat actors and the headless duel simulation.
+ *  Plain functions with no UObject or world dependencies, so they can be run and tested in isolation.
+ *  All randomness goes through a caller-provided random stream, so seeded runs are reproducible.
+ */
+struct FCombatRules
+{
+	/** Subtracts damage from the provided HP. Returns the damage actually applied, or 0 if the combatant was already dead */
+	static float ApplyDamage(float& CurrentHP, float Damage);
+
+	/** Returns true if a combatant with the provided HP is dead */
+	static bool IsDead(float CurrentHP) { return CurrentHP <= 0.0f; }
+
+	/** Rolls the number of attacks in an AI combo string, given the number of combo montage sections */
+	static int32 RollComboCount(FRandomStream& Random, int32 NumComboSections);
+
+	/** Rolls the number of charge loops for an AI charged attack */
+	static int32 RollChargeLoops(FRandomStream& Random, int32 MinChargeLoops, int32 MaxChargeLoops);
+
+	/** Returns true if a combo string should continue to its next attack */
+	static bool ShouldContinueCombo(int32 CurrentComboAttack, int32 TargetComboCount) { return CurrentComboAttack < TargetComboCount; }
+
+	/** Returns true if a charged attack should keep looping its charge */
+	static bool ShouldLoopCharge(int32 CurrentChargeLoop, int32 TargetChargeLoops) { return CurrentChargeLoop < TargetChargeLoops; }
+
+	/** Computes the knockback impulse for a melee hit, pushing up and away from the impact normal */
+	static FVector ComputeKnockback(const FVector& ImpactNormal, float KnockbackImpulse, float LaunchImpulse);
+};
+
+/** Tuning for one side of a simulated duel */
+struct FCombatDuelFighter
+{
+	/** Starting HP */
+	float MaxHP = 3.0f;
+
+	/** Damage dealt by each landed hit */
+	float MeleeDamage = 1.0f;
+
+	/** Number of combo montage sections, used to roll combo lengths */
+	int32 NumComboSections = 4;
+
+	/** Minimum number of charge loops for charged attacks */
+	int32 MinChargeLoops = 2;
+
+	/** Maximum number of charge loops for charged attacks */
+	int32 MaxChargeLoops = 5;
+
+	/** Chance to pick a charged attack over a combo, from 0 to 1 */
+	float ChargedAttackChance = 0.3f;
+
+	/** Chance for each attack to land, from 0 to 1 */
+	float HitChance = 0.6f;
+
+	/** Time between combo hits */
+	float ComboHitTime = 0.5f;
+
+	/** Duration of each charge loop */
+	float ChargeLoopTime = 0.4f;
+
+	/** Time from the end of the charge to the charged hit */
+	float ChargedAttackTime = 0.5f;
+
+	/** Time between the end of an attack and the start of the next one */
+	float RecoveryTime = 1.0f;
+};
+
+/** Outcome of a simulated duel */
+struct FCombatDuelResult
+{
+	/** Index of the winning fighter, or INDEX_NONE if nobody died before the time limit */
+	int32 Winner = INDEX_NONE;
+
+	/** Simulated duration of the duel */
+	float Duration = 0.0f;
+
+	/** Number of hits landed by each fighter */
+	int32 HitsLanded[2] = { 0, 0 };
+
+	/** Number of attacks started by each fighter */
+	int32 AttacksStarted[2] = { 0, 0 };
+};
+
+/**
+ *  Event-driven simulation of a melee duel between two fighters, using FCombatRules.
+ *  Each fighter alternates between attacking and recovering. Hits are resolved at the time they would land.
+ *  Results only depend on the fighters and the seed.
+ */
+struct FCombatDuelSimulation
+{
+	/** Runs a single duel to completion or until the time limit */
+	static FCombatDuelResult Run(const FCombatDuelFighter& FighterA, const FCombatDuelFighter& FighterB, int32 Seed, float MaxDuration = 300.0f);
+};
@@ -0,0 +1,46 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatSimulation.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCombatDuelDeterminismTest, "EscapeGame.Combat.Simulation.DuelDeterminism", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ServerContext | EAutomationTestFlags::EngineFilter)
+
+bool FCombatDuelDeterminismTest::RunTest(const FString& Parameters)
+{
+	// use uneven fighters so duels can end either way
+	FCombatDuelFighter FighterA;
+	FighterA.MaxHP = 5.0f;
+	FighterA.ChargedAttackChance = 0.2f;
+
+	const FCombatDuelFighter FighterB;
+
+	const int32 Seeds[] = { 1, 1337 };
+
+	for (const int32 Seed : Seeds)
+	{
+		// run each seed twice, every result must match
+		const FCombatDuelResult First = FCombatDuelSimulation::Run(FighterA, FighterB, Seed);
+		const FCombatDuelResult Second = FCombatDuelSimulation::Run(FighterA, FighterB, Seed);
+
+		const FString Context = FString::Printf(TEXT("seed %d"), Seed);
+
+		TestEqual(*(Context + TEXT(" winner")), Second.Winner, First.Winner);
+		TestEqual(*(Context + TEXT(" duration")), Second.Duration, First.Duration);
+
+		for (int32 FighterIndex = 0; FighterIndex < 2; ++FighterIndex)
+		{
+			TestEqual(*FString::Printf(TEXT("%s hits landed by fighter %d"), *Context, FighterIndex), Second.HitsLanded[FighterIndex], First.HitsLanded[FighterIndex]);
+			TestEqual(*FString::Printf(TEXT("%s attacks started by fighter %d"), *Context, FighterIndex), Second.AttacksStarted[FighterIndex], First.AttacksStarted[FighterIndex]);
+		}
+
+		// make sure the duel actually ran
+		TestTrue(*(Context + TEXT(" started attacks")), First.AttacksStarted[0] + First.AttacksStarted[1] > 0);
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
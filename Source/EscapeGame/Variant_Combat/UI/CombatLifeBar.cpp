@@ -2,4 +2,48 @@
 
 
 #include "CombatLifeBar.h"
+#include "Components/ProgressBar.h"
 
+bool UCombatLifeBar::UpdateLifePercentage(float Percent)
+{
+	// skip if nothing changed
+	if (FMath::IsNearlyEqual(Percent, CurrentPercentage))
+	{
+		return false;
+	}
+
+	CurrentPercentage = Percent;
+
+	// fill the progress bar if we have one
+	if (LifeProgressBar)
+	{
+		LifeProgressBar->SetPercent(Percent);
+	}
+
+	// call the BP handler
+	SetLifePercentage(Percent);
+
+	return true;
+}
+
+bool UCombatLifeBar::UpdateBarColor(const FLinearColor& Color)
+{
+	// skip if nothing changed
+	if (Color.Equals(CurrentColor))
+	{
+		return false;
+	}
+
+	CurrentColor = Color;
+
+	// color the progress bar if we have one
+	if (LifeProgressBar)
+	{
+		LifeProgressBar->SetFillColorAndOpacity(Color);
+	}
+
+	// call the BP handler
+	SetBarColor(Color);
+
+	return true;
+}
@@ -6,16 +6,38 @@
 #include "Blueprint/UserWidget.h"
 #include "CombatLifeBar.generated.h"
 
+class UProgressBar;
+
 /**
  *  A basic life bar user widget.
+ *  Values pushed through the Update functions are only applied when they actually change, so the hosting widget component can redraw on demand
+ *  A bound progress bar is filled natively, and the Blueprint events are still raised for custom visuals
  */
 UCLASS(abstract)
 class UCombatLifeBar : public UUserWidget
 {
 	GENERATED_BODY()
 
+protected:
+
+	/** Optional progress bar. If bound, it will be filled and colored natively */
+	UPROPERTY(BlueprintReadOnly, Category="Life Bar", meta = (BindWidgetOptional))
+	UProgressBar* LifeProgressBar;
+
+	/** Last applied fill percentage */
+	float CurrentPercentage = -1.0f;
+
+	/** Last applied fill color */
+	FLinearColor CurrentColor = FLinearColor::Transparent;
+
 public:
 
+	/** Applies the fill percentage if it changed. Returns true if the widget needs to be redrawn */
+	bool UpdateLifePercentage(float Percent);
+
+	/** Applies the fill color if it changed. Returns true if the widget needs to be redrawn */
+	bool UpdateBarColor(const FLinearColor& Color);
+
 	/** Sets the life bar to the provided 0-1 percentage value*/
 	UFUNCTION(BlueprintImplementableEvent, Category="Life Bar")
 	void SetLifePercentage(float Percent);
@@ -0,0 +1,144 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatLifeBarComponent.h"
+#include "CombatLifeBar.h"
+#include "CombatLifeBarSubsystem.h"
+#include "Engine/World.h"
+
+UCombatLifeBarComponent::UCombatLifeBarComponent()
+{
+	// only redraw the widget when its values change
+	bManuallyRedraw = true;
+}
+
+void UCombatLifeBarComponent::SetLifePercentage(float Percent)
+{
+	LifePercentage = FMath::Clamp(Percent, 0.0f, 1.0f);
+
+	// push the new value to wherever the bar is drawn
+	if (bBatched)
+	{
+		if (UCombatLifeBarSubsystem* LifeBars = GetWorld()->GetSubsystem<UCombatLifeBarSubsystem>())
+		{
+			LifeBars->UpdateBar(this);
+		}
+	}
+	else
+	{
+		UpdateWidget();
+	}
+}
+
+void UCombatLifeBarComponent::SetBarColor(FLinearColor Color)
+{
+	BarColor = Color;
+
+	// push the new value to wherever the bar is drawn
+	if (bBatched)
+	{
+		if (UCombatLifeBarSubsystem* LifeBars = GetWorld()->GetSubsystem<UCombatLifeBarSubsystem>())
+		{
+			LifeBars->UpdateBar(this);
+		}
+	}
+	else
+	{
+		UpdateWidget();
+	}
+}
+
+void UCombatLifeBarComponent::SetBarVisible(bool bVisible)
+{
+	bBarVisible = bVisible;
+
+	// push the new value to wherever the bar is drawn
+	if (bBatched)
+	{
+		if (UCombatLifeBarSubsystem* LifeBars = GetWorld()->GetSubsystem<UCombatLifeBarSubsystem>())
+		{
+			LifeBars->UpdateBar(this);
+		}
+	}
+	else
+	{
+		SetHiddenInGame(!bVisible);
+
+		// make sure we don't show a stale render target
+		if (bVisible)
+		{
+			RequestRedraw();
+		}
+	}
+}
+
+void UCombatLifeBarComponent::BeginPlay()
+{
+	// decide how we're drawn before the widget is initialized
+	UCombatLifeBarSubsystem* LifeBars = GetWorld()->GetSubsystem<UCombatLifeBarSubsystem>();
+	bBatched = LifeBars && LifeBars->IsBatchingEnabled();
+
+	Super::BeginPlay();
+
+	if (bBatched)
+	{
+		// we don't draw anything ourselves
+		Super::SetComponentTickEnabled(false);
+		SetHiddenInGame(true);
+
+		LifeBars->RegisterBar(this);
+	}
+	else
+	{
+		// let the renderer cull far away bars
+		SetCullDistance(MaxDrawDistance);
+
+		UpdateWidget();
+	}
+}
+
+void UCombatLifeBarComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// remove ourselves from the batched bars
+	if (bBatched)
+	{
+		if (UCombatLifeBarSubsystem* LifeBars = GetWorld()->GetSubsystem<UCombatLifeBarSubsystem>())
+		{
+			LifeBars->UnregisterBar(this);
+		}
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UCombatLifeBarComponent::InitWidget()
+{
+	// batched bars don't need a widget
+	if (bBatched)
+	{
+		return;
+	}
+
+	Super::InitWidget();
+}
+
+void UCombatLifeBarComponent::SetComponentTickEnabled(bool bEnabled)
+{
+	Super::SetComponentTickEnabled(bEnabled && !bBatched);
+}
+
+void UCombatLifeBarComponent::UpdateWidget()
+{
+	if (UCombatLifeBar* LifeBarWidget = Cast<UCombatLifeBar>(GetUserWidgetObject()))
+	{
+		// the widget skips values that haven't changed
+		const bool bPercentageChanged = LifeBarWidget->UpdateLifePercentage(LifePercentage);
+		const bool bColorChanged = LifeBarWidget->UpdateBarColor(BarColor);
+
+		// only re-render when something changed
+		if (bPercentageChanged || bColorChanged)
+		{
+			RequestRedraw();
+		}
+	}
+}
@@ -0,0 +1,95 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/WidgetComponent.h"
+#include "CombatLifeBarComponent.generated.h"
+
+/**
+ *  A life bar attached to a combat character.
+ *  When batched life bars are enabled, this component only holds the bar's data and
+ *  the bar is drawn by the HUD-level UCombatLifeBarLayer. No widget or render target is created.
+ *  Otherwise it behaves as a regular widget component hosting a UCombatLifeBar, which is only redrawn when its values change.
+ */
+UCLASS(ClassGroup=(Combat), meta=(BlueprintSpawnableComponent))
+class UCombatLifeBarComponent : public UWidgetComponent
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Current fill percentage, from 0 to 1 */
+	float LifePercentage = 1.0f;
+
+	/** Current fill color */
+	UPROPERTY(EditAnywhere, Category="Life Bar")
+	FLinearColor BarColor = FLinearColor(0.8f, 0.05f, 0.05f);
+
+	/** Bars further than this distance from the player's camera are not drawn. 0 disables culling */
+	UPROPERTY(EditAnywhere, Category="Life Bar", meta = (ClampMin = 0, Units = "cm"))
+	float MaxDrawDistance = 3000.0f;
+
+	/** If true, the bar should currently be displayed */
+	bool bBarVisible = true;
+
+	/** If true, this bar is drawn by the batched life bar layer */
+	bool bBatched = false;
+
+	/** Index of this bar in the batched life bar arrays */
+	int32 BatchIndex = INDEX_NONE;
+
+public:
+
+	/** Sets the life bar to the provided 0-1 percentage value */
+	void SetLifePercentage(float Percent);
+
+	/** Sets the life bar fill color */
+	void SetBarColor(FLinearColor Color);
+
+	/** Shows or hides the life bar */
+	void SetBarVisible(bool bVisible);
+
+	/** Returns true if this bar is drawn by the batched life bar layer */
+	bool IsBatched() const { return bBatched; }
+
+	/** Updates the index of this bar in the batched arrays. Used by the life bar subsystem */
+	void SetBatchIndex(int32 NewIndex) { BatchIndex = NewIndex; }
+
+	/** Returns the index of this bar in the batched arrays */
+	int32 GetBatchIndex() const { return BatchIndex; }
+
+	/** Returns the current fill percentage */
+	float GetLifePercentage() const { return LifePercentage; }
+
+	/** Returns the current fill color */
+	const FLinearColor& GetBarColor() const { return BarColor; }
+
+	/** Returns true if the bar should currently be displayed */
+	bool IsBarVisible() const { return bBarVisible; }
+
+	/** Returns the distance past which the bar is culled. 0 means no culling */
+	float GetMaxDrawDistance() const { return MaxDrawDistance; }
+
+public:
+
+	/** Constructor */
+	UCombatLifeBarComponent();
+
+	/** Initialization */
+	virtual void BeginPlay() override;
+
+	/** Cleanup */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/** Skips creating the widget when batched */
+	virtual void InitWidget() override;
+
+	/** Keeps the component from ticking when batched */
+	virtual void SetComponentTickEnabled(bool bEnabled) override;
+
+protected:
+
+	/** Pushes the current values to the hosted widget and requests a redraw if anything changed, when not batched */
+	void UpdateWidget();
+};
@@ -0,0 +1,105 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatLifeBarLayer.h"
+#include "CombatLifeBarSubsystem.h"
+#include "Blueprint/WidgetLayoutLibrary.h"
+#include "GameFramework/PlayerController.h"
+#include "Rendering/DrawElements.h"
+
+void UCombatLifeBarLayer::NativeConstruct()
+{
+	Super::NativeConstruct();
+
+	// never block input
+	SetVisibility(ESlateVisibility::HitTestInvisible);
+}
+
+void UCombatLifeBarLayer::NativeTick(const FGeometry& MyGeometry, float InDeltaTime)
+{
+	Super::NativeTick(MyGeometry, InDeltaTime);
+
+	ScreenPositions.Reset();
+	ProjectedBars.Reset();
+
+	APlayerController* PlayerController = GetOwningPlayer();
+	const UCombatLifeBarSubsystem* LifeBars = GetWorld() ? GetWorld()->GetSubsystem<UCombatLifeBarSubsystem>() : nullptr;
+
+	if (!PlayerController || !LifeBars)
+	{
+		return;
+	}
+
+	const TArray<FVector>& Locations = LifeBars->GetLocations();
+	const TArray<bool>& Visibility = LifeBars->GetVisibility();
+
+	const FVector2D LayerSize = MyGeometry.GetLocalSize();
+
+	for (int32 i = 0; i < LifeBars->GetNumBars(); ++i)
+	{
+		if (!Visibility[i])
+		{
+			continue;
+		}
+
+		// project the bar and skip it if it's behind the camera or off screen
+		FVector2D ScreenPosition;
+
+		if (!UWidgetLayoutLibrary::ProjectWorldLocationToWidgetPosition(PlayerController, Locations[i], ScreenPosition, true))
+		{
+			continue;
+		}
+
+		if (ScreenPosition.X < -BarSize.X || ScreenPosition.Y < -BarSize.Y || ScreenPosition.X > LayerSize.X + BarSize.X || ScreenPosition.Y > LayerSize.Y + BarSize.Y)
+		{
+			continue;
+		}
+
+		ScreenPositions.Add(ScreenPosition);
+		ProjectedBars.Add(i);
+	}
+}
+
+int32 UCombatLifeBarLayer::NativePaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const
+{
+	LayerId = Super::NativePaint(Args, AllottedGeometry, MyCullingRect, OutDrawElements, LayerId, InWidgetStyle, bParentEnabled);
+
+	const UCombatLifeBarSubsystem* LifeBars = GetWorld() ? GetWorld()->GetSubsystem<UCombatLifeBarSubsystem>() : nullptr;
+
+	if (!LifeBars)
+	{
+		return LayerId;
+	}
+
+	const TArray<float>& Percentages = LifeBars->GetPercentages();
+	const TArray<FLinearColor>& Colors = LifeBars->GetColors();
+
+	const FVector2D FillSize = BarSize - FVector2D(BorderSize * 2.0f);
+
+	for (int32 i = 0; i < ProjectedBars.Num(); ++i)
+	{
+		const int32 BarIndex = ProjectedBars[i];
+
+		// the bar may have been removed since we projected it
+		if (!Percentages.IsValidIndex(BarIndex))
+		{
+			continue;
+		}
+
+		// center the bar on its projected location
+		const FVector2D BarOrigin = ScreenPositions[i] - (BarSize * 0.5f);
+
+		// draw the background
+		FSlateDrawElement::MakeBox(OutDrawElements, LayerId, AllottedGeometry.ToPaintGeometry(BarSize, FSlateLayoutTransform(BarOrigin)), &BarBrush, ESlateDrawEffect::None, BackgroundColor * InWidgetStyle.GetColorAndOpacityTint());
+
+		// draw the fill on top
+		const FVector2D BarFill(FillSize.X * Percentages[BarIndex], FillSize.Y);
+
+		if (BarFill.X > 0.0f)
+		{
+			FSlateDrawElement::MakeBox(OutDrawElements, LayerId + 1, AllottedGeometry.ToPaintGeometry(BarFill, FSlateLayoutTransform(BarOrigin + FVector2D(BorderSize))), &BarBrush, ESlateDrawEffect::None, Colors[BarIndex] * InWidgetStyle.GetColorAndOpacityTint());
+		}
+	}
+
+	return LayerId + 1;
+}
@@ -0,0 +1,53 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "Styling/SlateBrush.h"
+#include "CombatLifeBarLayer.generated.h"
+
+/**
+ *  A full screen HUD layer that draws every batched life bar in a single paint pass.
+ *  Bars are read from the packed arrays in UCombatLifeBarSubsystem and projected to the owning player's screen.
+ */
+UCLASS()
+class UCombatLifeBarLayer : public UUserWidget
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Size of each life bar on screen */
+	UPROPERTY(EditAnywhere, Category="Life Bars")
+	FVector2D BarSize = FVector2D(80.0f, 8.0f);
+
+	/** Thickness of the background border around the fill */
+	UPROPERTY(EditAnywhere, Category="Life Bars", meta = (ClampMin = 0, ClampMax = 10))
+	float BorderSize = 1.0f;
+
+	/** Color of the bar background */
+	UPROPERTY(EditAnywhere, Category="Life Bars")
+	FLinearColor BackgroundColor = FLinearColor(0.0f, 0.0f, 0.0f, 0.6f);
+
+	/** Brush used for both the background and the fill */
+	UPROPERTY(EditAnywhere, Category="Life Bars")
+	FSlateBrush BarBrush;
+
+	/** Screen positions of the bars projected this frame */
+	TArray<FVector2D> ScreenPositions;
+
+	/** Batched bar index of each projected bar */
+	TArray<int32> ProjectedBars;
+
+protected:
+
+	/** Initialization */
+	virtual void NativeConstruct() override;
+
+	/** Projects the visible bars to the screen */
+	virtual void NativeTick(const FGeometry& MyGeometry, float InDeltaTime) override;
+
+	/** Draws all projected bars */
+	virtual int32 NativePaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const override;
+};
@@ -0,0 +1,141 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatLifeBarSubsystem.h"
+#include "CombatLifeBarComponent.h"
+#include "GameFramework/Actor.h"
+#include "GameFramework/PlayerController.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Engine/World.h"
+
+void UCombatLifeBarSubsystem::RegisterBar(UCombatLifeBarComponent* Bar)
+{
+	// ensure the bar is valid and not registered yet
+	if (!IsValid(Bar) || Bar->GetBatchIndex() != INDEX_NONE)
+	{
+		return;
+	}
+
+	// append the bar to the packed arrays
+	Bar->SetBatchIndex(Bars.Add(Bar));
+	Locations.Add(Bar->GetComponentLocation());
+	Percentages.Add(Bar->GetLifePercentage());
+	Colors.Add(Bar->GetBarColor());
+	Visibility.Add(ShouldDrawBar(Bar));
+}
+
+void UCombatLifeBarSubsystem::UnregisterBar(UCombatLifeBarComponent* Bar)
+{
+	const int32 Index = Bar->GetBatchIndex();
+
+	if (!Bars.IsValidIndex(Index) || Bars[Index].Get() != Bar)
+	{
+		return;
+	}
+
+	RemoveBarAt(Index);
+
+	Bar->SetBatchIndex(INDEX_NONE);
+}
+
+void UCombatLifeBarSubsystem::RemoveBarAt(int32 Index)
+{
+	// swap the last bar into the removed slot to keep the arrays packed
+	Bars.RemoveAtSwap(Index, EAllowShrinking::No);
+	Locations.RemoveAtSwap(Index, EAllowShrinking::No);
+	Percentages.RemoveAtSwap(Index, EAllowShrinking::No);
+	Colors.RemoveAtSwap(Index, EAllowShrinking::No);
+	Visibility.RemoveAtSwap(Index, EAllowShrinking::No);
+
+	if (UCombatLifeBarComponent* MovedBar = Bars.IsValidIndex(Index) ? Bars[Index].Get() : nullptr)
+	{
+		MovedBar->SetBatchIndex(Index);
+	}
+}
+
+void UCombatLifeBarSubsystem::UpdateBar(const UCombatLifeBarComponent* Bar)
+{
+	const int32 Index = Bar->GetBatchIndex();
+
+	if (!Bars.IsValidIndex(Index) || Bars[Index].Get() != Bar)
+	{
+		return;
+	}
+
+	Percentages[Index] = Bar->GetLifePercentage();
+	Colors[Index] = Bar->GetBarColor();
+	Visibility[Index] = ShouldDrawBar(Bar);
+}
+
+void UCombatLifeBarSubsystem::Tick(float DeltaTime)
+{
+	// find the first local player's camera so we can cull far away bars. Split-screen players share its cull distances
+	const APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+	bHasViewLocation = PlayerController && PlayerController->PlayerCameraManager;
+
+	if (bHasViewLocation)
+	{
+		ViewLocation = PlayerController->PlayerCameraManager->GetCameraLocation();
+	}
+
+	// the bars follow their owners around, so refresh their locations and visibility
+	for (int32 i = Bars.Num() - 1; i >= 0; --i)
+	{
+		const UCombatLifeBarComponent* Bar = Bars[i].Get();
+
+		// drop bars that were destroyed without unregistering. Iterating backwards keeps the swapped in bar already processed
+		if (!IsValid(Bar))
+		{
+			RemoveBarAt(i);
+			continue;
+		}
+
+		Locations[i] = Bar->GetComponentLocation();
+		Visibility[i] = ShouldDrawBar(Bar);
+	}
+}
+
+TStatId UCombatLifeBarSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCombatLifeBarSubsystem, STATGROUP_Tickables);
+}
+
+void UCombatLifeBarSubsystem::Deinitialize()
+{
+	// release all bars
+	for (const TWeakObjectPtr<UCombatLifeBarComponent>& Bar : Bars)
+	{
+		if (Bar.IsValid())
+		{
+			Bar->SetBatchIndex(INDEX_NONE);
+		}
+	}
+
+	Bars.Empty();
+	Locations.Empty();
+	Percentages.Empty();
+	Colors.Empty();
+	Visibility.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UCombatLifeBarSubsystem::ShouldDrawBar(const UCombatLifeBarComponent* Bar) const
+{
+	const AActor* Owner = Bar->GetOwner();
+
+	if (!Bar->IsBarVisible() || (Owner && Owner->IsHidden()))
+	{
+		return false;
+	}
+
+	// cull the bar if it's too far away from the camera
+	const float MaxDrawDistance = Bar->GetMaxDrawDistance();
+
+	if (bHasViewLocation && MaxDrawDistance > 0.0f)
+	{
+		return FVector::DistSquared(ViewLocation, Bar->GetComponentLocation()) <= FMath::Square(MaxDrawDistance);
+	}
+
+	return true;
+}
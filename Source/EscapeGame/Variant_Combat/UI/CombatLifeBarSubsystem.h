@@ -0,0 +1,99 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CombatLifeBarSubsystem.generated.h"
+
+class UCombatLifeBarComponent;
+
+/**
+ *  Keeps packed arrays of every batched life bar in the world, so they can be drawn in a single pass by UCombatLifeBarLayer.
+ *  Bar values are pushed by their components when they change. World locations are refreshed once per frame.
+ *  Distance culling uses the first local player's camera only, so split-screen players share its cull distances.
+ */
+UCLASS(config=Game)
+class UCombatLifeBarSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** If true, life bar components register here instead of creating their own widgets */
+	UPROPERTY(Config)
+	bool bBatchedLifeBars = true;
+
+	/** Registered life bar components. Bars destroyed without unregistering are pruned on the next tick */
+	TArray<TWeakObjectPtr<UCombatLifeBarComponent>> Bars;
+
+	/** World location of each bar */
+	TArray<FVector> Locations;
+
+	/** Fill percentage of each bar */
+	TArray<float> Percentages;
+
+	/** Fill color of each bar */
+	TArray<FLinearColor> Colors;
+
+	/** Whether each bar should be drawn this frame */
+	TArray<bool> Visibility;
+
+	/** Location of the first local player's camera, used to cull far away bars */
+	FVector ViewLocation = FVector::ZeroVector;
+
+	/** If true, ViewLocation is valid and bars can be culled by distance */
+	bool bHasViewLocation = false;
+
+public:
+
+	/** Returns true if life bars should be batched */
+	bool IsBatchingEnabled() const { return bBatchedLifeBars; }
+
+	/** Adds a life bar to the batched arrays */
+	void RegisterBar(UCombatLifeBarComponent* Bar);
+
+	/** Removes a life bar from the batched arrays */
+	void UnregisterBar(UCombatLifeBarComponent* Bar);
+
+	/** Copies the latest values from a life bar component */
+	void UpdateBar(const UCombatLifeBarComponent* Bar);
+
+	/** Returns the number of batched bars */
+	int32 GetNumBars() const { return Bars.Num(); }
+
+	/** Returns the world location of each bar */
+	const TArray<FVector>& GetLocations() const { return Locations; }
+
+	/** Returns the fill percentage of each bar */
+	const TArray<float>& GetPercentages() const { return Percentages; }
+
+	/** Returns the fill color of each bar */
+	const TArray<FLinearColor>& GetColors() const { return Colors; }
+
+	/** Returns whether each bar should be drawn this frame */
+	const TArray<bool>& GetVisibility() const { return Visibility; }
+
+public:
+
+	// ~begin UTickableWorldSubsystem interface
+
+	/** Prunes stale bars, then refreshes bar locations and visibility */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Returns the stat ID for the tickable */
+	virtual TStatId GetStatId() const override;
+
+	/** Cleanup */
+	virtual void Deinitialize() override;
+
+	// ~end UTickableWorldSubsystem interface
+
+protected:
+
+	/** Returns true if the bar should be drawn, taking its owner's visibility and its cull distance into account */
+	bool ShouldDrawBar(const UCombatLifeBarComponent* Bar) const;
+
+	/** Removes the bar at the provided index from the packed arrays, swapping the last bar into its slot */
+	void RemoveBarAt(int32 Index);
+};
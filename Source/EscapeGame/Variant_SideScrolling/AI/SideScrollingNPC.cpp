@@ -4,8 +4,12 @@
 #include "SideScrollingNPC.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "TimerManager.h"
+#include "AIStateTreeEvents.h"
+#include "StateTreeLODAIComponent.h"
+#include "Net/UnrealNetwork.h"
 
-ASideScrollingNPC::ASideScrollingNPC()
+ASideScrollingNPC::ASideScrollingNPC(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer.SetDefaultSubobjectClass<USideScrollingCharacterMovementComponent>(ACharacter::CharacterMovementComponentName))
 {
  	PrimaryActorTick.bCanEverTick = true;
 
@@ -20,6 +24,43 @@ void ASideScrollingNPC::EndPlay(EEndPlayReason::Type EndPlayReason)
 	GetWorld()->GetTimerManager().ClearTimer(DeactivationTimer);
 }
 
+void ASideScrollingNPC::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	// replace the full movement with the compact version
+	DISABLE_REPLICATED_PRIVATE_PROPERTY(AActor, ReplicatedMovement);
+	DOREPLIFETIME_CONDITION(ASideScrollingNPC, SideScrollingMovement, COND_SimulatedOnly);
+}
+
+void ASideScrollingNPC::GatherCurrentMovement()
+{
+	Super::GatherCurrentMovement();
+
+	if (const USideScrollingCharacterMovementComponent* Movement = Cast<USideScrollingCharacterMovementComponent>(GetCharacterMovement()))
+	{
+		Movement->PackReplicatedMovement(GetReplicatedMovement(), SideScrollingMovement);
+	}
+}
+
+void ASideScrollingNPC::OnRep_SideScrollingMovement()
+{
+	if (const USideScrollingCharacterMovementComponent* Movement = Cast<USideScrollingCharacterMovementComponent>(GetCharacterMovement()))
+	{
+		// rebuild the full movement and run it through the regular simulated proxy update
+		Movement->UnpackReplicatedMovement(SideScrollingMovement, GetReplicatedMovement_Mutable());
+		OnRep_ReplicatedMovement();
+	}
+}
+
+void ASideScrollingNPC::OnMovementModeChanged(EMovementMode PrevMovementMode, uint8 PreviousCustomMode)
+{
+	Super::OnMovementModeChanged(PrevMovementMode, PreviousCustomMode);
+
+	// send a movement event to the StateTree
+	FAIStateTreeEvents::SendMovementModeEvent(this, PrevMovementMode);
+}
+
 void ASideScrollingNPC::Interaction(AActor* Interactor)
 {
 	// ignore if this NPC has already been deactivated
@@ -31,6 +72,12 @@ void ASideScrollingNPC::Interaction(AActor* Interactor)
 	// reset the deactivation flag
 	bDeactivated = true;
 
+	// react at full rate while we're being interacted with
+	if (UStateTreeLODAIComponent* StateTreeLOD = UStateTreeLODAIComponent::FindForPawn(this))
+	{
+		StateTreeLOD->NotifyCombatActivity();
+	}
+
 	// stop character movement immediately
 	GetCharacterMovement()->StopMovementImmediately();
 
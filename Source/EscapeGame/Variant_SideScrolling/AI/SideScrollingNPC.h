@@ -5,12 +5,14 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
 #include "SideScrollingInteractable.h"
+#include "SideScrollingCharacterMovementComponent.h"
 #include "SideScrollingNPC.generated.h"
 
 /**
  *  Simple platforming NPC
  *  Its behaviors will be dictated by a possessing AI Controller
  *  It can be temporarily deactivated through Actor interactions
+ *  Uses a plane constrained movement component with compact movement replication
  */
 UCLASS(abstract)
 class ASideScrollingNPC : public ACharacter, public ISideScrollingInteractable
@@ -40,16 +42,35 @@ public:
 	/** Timer to reactivate the NPC */
 	FTimerHandle DeactivationTimer;
 
+protected:
+
+	/** Compact replicated movement, sent instead of the full ReplicatedMovement */
+	UPROPERTY(ReplicatedUsing=OnRep_SideScrollingMovement)
+	FSideScrollingRepMovement SideScrollingMovement;
+
 public:
 
 	/** Constructor */
-	ASideScrollingNPC();
+	ASideScrollingNPC(const FObjectInitializer& ObjectInitializer);
 
 public:
 
 	/** Cleanup */
 	virtual void EndPlay(EEndPlayReason::Type EndPlayReason) override;
 
+	/** Sets up replicated properties */
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	/** Packs the gathered movement into the compact replicated format */
+	virtual void GatherCurrentMovement() override;
+
+	/** Rebuilds the full replicated movement and applies it */
+	UFUNCTION()
+	void OnRep_SideScrollingMovement();
+
+	/** Notifies the StateTree when we become grounded or airborne */
+	virtual void OnMovementModeChanged(EMovementMode PrevMovementMode, uint8 PreviousCustomMode = 0) override;
+
 public:
 
 //	~begin IInteractable interface 
@@ -6,24 +6,77 @@
 #include "StateTreeExecutionTypes.h"
 #include "AIController.h"
 #include "Kismet/GameplayStatics.h"
+#include "StateTreeAsyncExecutionContext.h"
+#include "AIPlayerInfoSubsystem.h"
+#include "AIStateTreeEvents.h"
 
-EStateTreeRunStatus FStateTreeGetPlayerTask::Tick(FStateTreeExecutionContext& Context, const float DeltaTime) const
+FStateTreeGetPlayerTask::FStateTreeGetPlayerTask()
 {
-	// get the instance data
-	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
-
-	// set the player pawn as the target
-	InstanceData.TargetPlayer = UGameplayStatics::GetPlayerPawn(InstanceData.Controller.Get(), 0);
+	// the outputs are pushed by the player info subsystem, so we never need to tick
+	bShouldCallTick = false;
+}
 
-	// are the NPC and target valid?
-	if (IsValid(InstanceData.TargetPlayer) && IsValid(InstanceData.NPC))
+EStateTreeRunStatus FStateTreeGetPlayerTask::EnterState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const
+{
+	// have we transitioned from another state?
+	if (Transition.ChangeType == EStateTreeStateChangeType::Changed)
 	{
-		InstanceData.bValidTarget = FVector::Distance(InstanceData.NPC->GetActorLocation(), InstanceData.TargetPlayer->GetActorLocation()) < InstanceData.RangeMax;
+		// get the instance data
+		FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
+
+		// register with the player info subsystem so our distance gets computed every frame
+		if (UAIPlayerInfoSubsystem* PlayerInfo = Context.GetWorld()->GetSubsystem<UAIPlayerInfoSubsystem>())
+		{
+			InstanceData.PlayerInfoHandle = PlayerInfo->RegisterAgent(InstanceData.NPC);
+			InstanceData.TargetPlayer = PlayerInfo->GetPlayerPawn(PlayerInfo->GetNearestPlayer(InstanceData.PlayerInfoHandle));
+
+			// update the outputs and notify the tree only when the target becomes valid or invalid, so nobody needs to poll
+			InstanceData.bValidTarget = PlayerInfo->WatchRange(InstanceData.PlayerInfoHandle, InstanceData.RangeMax, InstanceData.RangeHysteresis, FOnPlayerRangeChanged::CreateLambda(
+				[WeakContext = Context.MakeWeakExecutionContext(), InstanceDataRef = Context.GetInstanceDataStructRef(*this), WeakPlayerInfo = TWeakObjectPtr<UAIPlayerInfoSubsystem>(PlayerInfo), Handle = InstanceData.PlayerInfoHandle](bool bInRange) mutable
+				{
+					if (FInstanceDataType* InstanceDataPtr = InstanceDataRef.GetPtr())
+					{
+						InstanceDataPtr->bValidTarget = bInRange;
+						InstanceDataPtr->TargetPlayer = WeakPlayerInfo.IsValid() ? WeakPlayerInfo->GetPlayerPawn(WeakPlayerInfo->GetNearestPlayer(Handle)) : nullptr;
+					}
+
+					WeakContext.SendEvent(bInRange ? TAG_AI_Event_PlayerEnteredRange : TAG_AI_Event_PlayerLeftRange);
+				}
+			));
+		}
+		else
+		{
+			// no subsystem, so evaluate the target once
+			InstanceData.TargetPlayer = UGameplayStatics::GetPlayerPawn(InstanceData.Controller.Get(), 0);
+
+			if (IsValid(InstanceData.TargetPlayer) && IsValid(InstanceData.NPC))
+			{
+				InstanceData.bValidTarget = FVector::Distance(InstanceData.NPC->GetActorLocation(), InstanceData.TargetPlayer->GetActorLocation()) < InstanceData.RangeMax;
+			}
+		}
 	}
 
 	return EStateTreeRunStatus::Running;
 }
 
+void FStateTreeGetPlayerTask::ExitState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const
+{
+	// have we transitioned to another state?
+	if (Transition.ChangeType == EStateTreeStateChangeType::Changed)
+	{
+		// get the instance data
+		FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
+
+		// unregister from the player info subsystem
+		if (UAIPlayerInfoSubsystem* PlayerInfo = Context.GetWorld()->GetSubsystem<UAIPlayerInfoSubsystem>())
+		{
+			PlayerInfo->UnregisterAgent(InstanceData.PlayerInfoHandle);
+		}
+
+		InstanceData.PlayerInfoHandle = INDEX_NONE;
+	}
+}
+
 #if WITH_EDITOR
 FText FStateTreeGetPlayerTask::GetDescription(const FGuid& ID, FStateTreeDataView InstanceDataView, const IStateTreeBindingLookup& BindingLookup, EStateTreeNodeFormatting Formatting /*= EStateTreeNodeFormatting::Text*/) const
 {
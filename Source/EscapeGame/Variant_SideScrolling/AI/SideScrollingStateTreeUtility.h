@@ -36,10 +36,19 @@ struct FStateTreeGetPlayerInstanceData
 	/** Max distance to be considered a valid target */
 	UPROPERTY(EditAnywhere, Category="Parameter", meta = (ClampMin = 0, ClampMax = 10000, Units = "cm"))
 	float RangeMax = 1000.0f;
+
+	/** Extra distance the target needs to move away before it stops being valid */
+	UPROPERTY(EditAnywhere, Category="Parameter", meta = (ClampMin = 0, ClampMax = 1000, Units = "cm"))
+	float RangeHysteresis = 50.0f;
+
+	/** Handle of the NPC in the AI player info subsystem */
+	int32 PlayerInfoHandle = INDEX_NONE;
 };
 
 /**
  *  StateTree task to get the player-controlled character
+ *  Doesn't tick. The outputs are updated by UAIPlayerInfoSubsystem only when the player crosses the range
+ *  Also sends AI.Event.PlayerEnteredRange and AI.Event.PlayerLeftRange when the target becomes valid or invalid
  */
 USTRUCT(meta=(DisplayName="Get Player", Category="Side Scrolling"))
 struct FStateTreeGetPlayerTask : public FStateTreeTaskCommonBase
@@ -50,8 +59,14 @@ struct FStateTreeGetPlayerTask : public FStateTreeTaskCommonBase
 	using FInstanceDataType = FStateTreeGetPlayerInstanceData;
 	virtual const UStruct* GetInstanceDataType() const override { return FInstanceDataType::StaticStruct(); }
 
-	/** Runs while the owning state is active */
-	virtual EStateTreeRunStatus Tick(FStateTreeExecutionContext& Context, const float DeltaTime) const override;
+	/** Constructor */
+	FStateTreeGetPlayerTask();
+
+	/** Runs when the owning state is entered */
+	virtual EStateTreeRunStatus EnterState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const override;
+
+	/** Runs when the owning state is ended */
+	virtual void ExitState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const override;
 
 #if WITH_EDITOR
 	virtual FText GetDescription(const FGuid& ID, FStateTreeDataView InstanceDataView, const IStateTreeBindingLookup& BindingLookup, EStateTreeNodeFormatting Formatting = EStateTreeNodeFormatting::Text) const override;
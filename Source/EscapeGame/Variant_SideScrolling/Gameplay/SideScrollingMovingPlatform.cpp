@@ -8,6 +8,11 @@ ASideScrollingMovingPlatform::ASideScrollingMovingPlatform()
 {
 	PrimaryActorTick.bCanEverTick = false;
 
+	// replicate movement, but stay dormant until we start moving
+	bReplicates = true;
+	SetReplicatingMovement(true);
+	NetDormancy = DORM_Initial;
+
 	// create the root comp
 	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
 }
@@ -23,12 +28,24 @@ void ASideScrollingMovingPlatform::Interaction(AActor* Interactor)
 	// raise the movement flag
 	bMoving = true;
 
+	// stay awake while moving so clients see the movement
+	if (HasAuthority())
+	{
+		SetNetDormancy(DORM_Awake);
+	}
+
 	// pass control to BP for the actual movement
 	BP_MoveToTarget();
 }
 
 void ASideScrollingMovingPlatform::ResetInteraction()
 {
+	// the movement is finished, so go back to sleep. Flushes the final position to clients
+	if (HasAuthority())
+	{
+		SetNetDormancy(DORM_DormantAll);
+	}
+
 	// ignore if this is a one-shot platform
 	if (bOneShot)
 	{
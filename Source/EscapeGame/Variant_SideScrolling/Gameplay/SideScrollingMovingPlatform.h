@@ -10,6 +10,7 @@
 /**
  *  Simple moving platform that can be triggered through interactions by other actors.
  *  The actual movement is performed by Blueprint code through latent execution nodes.
+ *  The platform is net dormant while idle, and only wakes to replicate its movement.
  */
 UCLASS(abstract)
 class ASideScrollingMovingPlatform : public AActor, public ISideScrollingInteractable
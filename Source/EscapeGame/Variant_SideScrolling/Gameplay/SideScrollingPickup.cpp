@@ -12,6 +12,10 @@ ASideScrollingPickup::ASideScrollingPickup()
 {
 	PrimaryActorTick.bCanEverTick = false;
 
+	// replicate so clients receive our destruction, but otherwise stay dormant
+	bReplicates = true;
+	NetDormancy = DORM_Initial;
+
 	// create the root comp
 	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
 
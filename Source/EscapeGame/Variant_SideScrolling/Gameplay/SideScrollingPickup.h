@@ -11,6 +11,7 @@ class USphereComponent;
 /**
  *  A simple side scrolling game pickup
  *  Increments a counter on the GameMode
+ *  The pickup stays net dormant. It has no replicated state, so clients only receive its destruction
  */
 UCLASS(abstract)
 class ASideScrollingPickup : public AActor
@@ -13,8 +13,10 @@
 #include "SideScrollingInteractable.h"
 #include "Kismet/KismetMathLibrary.h"
 #include "TimerManager.h"
+#include "Net/UnrealNetwork.h"
 
-ASideScrollingCharacter::ASideScrollingCharacter()
+ASideScrollingCharacter::ASideScrollingCharacter(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer.SetDefaultSubobjectClass<USideScrollingCharacterMovementComponent>(ACharacter::CharacterMovementComponentName))
 {
 	PrimaryActorTick.bCanEverTick = true;
 
@@ -52,9 +54,6 @@ ASideScrollingCharacter::ASideScrollingCharacter()
 	GetCharacterMovement()->RotationRate = FRotator(0.0f, 750.0f, 0.0f);
 	GetCharacterMovement()->bOrientRotationToMovement = true;
 
-	GetCharacterMovement()->SetPlaneConstraintNormal(FVector(0.0f, 1.0f, 0.0f));
-	GetCharacterMovement()->bConstrainToPlane = true;
-
 	// enable double jump and coyote time
 	JumpMaxCount = 3;
 }
@@ -67,6 +66,35 @@ void ASideScrollingCharacter::EndPlay(EEndPlayReason::Type EndPlayReason)
 	GetWorld()->GetTimerManager().ClearTimer(WallJumpTimer);
 }
 
+void ASideScrollingCharacter::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	// replace the full movement with the compact version
+	DISABLE_REPLICATED_PRIVATE_PROPERTY(AActor, ReplicatedMovement);
+	DOREPLIFETIME_CONDITION(ASideScrollingCharacter, SideScrollingMovement, COND_SimulatedOnly);
+}
+
+void ASideScrollingCharacter::GatherCurrentMovement()
+{
+	Super::GatherCurrentMovement();
+
+	if (const USideScrollingCharacterMovementComponent* Movement = Cast<USideScrollingCharacterMovementComponent>(GetCharacterMovement()))
+	{
+		Movement->PackReplicatedMovement(GetReplicatedMovement(), SideScrollingMovement);
+	}
+}
+
+void ASideScrollingCharacter::OnRep_SideScrollingMovement()
+{
+	if (const USideScrollingCharacterMovementComponent* Movement = Cast<USideScrollingCharacterMovementComponent>(GetCharacterMovement()))
+	{
+		// rebuild the full movement and run it through the regular simulated proxy update
+		Movement->UnpackReplicatedMovement(SideScrollingMovement, GetReplicatedMovement_Mutable());
+		OnRep_ReplicatedMovement();
+	}
+}
+
 void ASideScrollingCharacter::SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent)
 {
 	Super::SetupPlayerInputComponent(PlayerInputComponent);
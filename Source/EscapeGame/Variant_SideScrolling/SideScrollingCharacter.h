@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
+#include "SideScrollingCharacterMovementComponent.h"
 #include "SideScrollingCharacter.generated.h"
 
 class UCameraComponent;
@@ -12,6 +13,7 @@ struct FInputActionValue;
 
 /**
  *  A player-controllable character side scrolling game
+ *  Uses a plane constrained movement component with compact movement replication
  */
 UCLASS(abstract)
 class ASideScrollingCharacter : public ACharacter
@@ -97,16 +99,30 @@ protected:
 	/** If true, this character is moving along the side scrolling axis */
 	bool bMovingHorizontally = false;
 
+	/** Compact replicated movement, sent instead of the full ReplicatedMovement */
+	UPROPERTY(ReplicatedUsing=OnRep_SideScrollingMovement)
+	FSideScrollingRepMovement SideScrollingMovement;
+
 public:
 	
 	/** Constructor */
-	ASideScrollingCharacter();
+	ASideScrollingCharacter(const FObjectInitializer& ObjectInitializer);
 
 protected:
 
 	/** Gameplay cleanup */
 	virtual void EndPlay(EEndPlayReason::Type EndPlayReason) override;
 
+	/** Sets up replicated properties */
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	/** Packs the gathered movement into the compact replicated format */
+	virtual void GatherCurrentMovement() override;
+
+	/** Rebuilds the full replicated movement and applies it */
+	UFUNCTION()
+	void OnRep_SideScrollingMovement();
+
 	/** Initialize input action bindings */
 	virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
 
@@ -0,0 +1,210 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "SideScrollingCharacterMovementComponent.h"
+#include "Engine/ReplicatedState.h"
+
+namespace SideScrollingMovement
+{
+	/** Quantization scale for replicated locations. 10 rounds to the nearest millimeter */
+	constexpr double RepLocationScale = 10.0;
+
+	/** Quantization scale for replicated velocities. 1 rounds to whole numbers */
+	constexpr double RepVelocityScale = 1.0;
+
+	/** Quantization scale for client move locations. Matches the default FVector_NetQuantize100 so server error checks behave the same */
+	constexpr double MoveLocationScale = 100.0;
+
+	/** Quantization scale for client move accelerations. Matches the default FVector_NetQuantize10 */
+	constexpr double MoveAccelerationScale = 10.0;
+
+	/** Returns true if a yaw faces down the negative X axis */
+	bool IsFacingBackward(double Yaw)
+	{
+		return FMath::Abs(FRotator::NormalizeAxis(Yaw)) > 90.0;
+	}
+
+	/** Returns the rotation for a facing bit */
+	FRotator GetFacingRotation(bool bFacingBackward)
+	{
+		return FRotator(0.0f, bFacingBackward ? 180.0f : 0.0f, 0.0f);
+	}
+}
+
+bool FSideScrollingRepMovement::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	// pack both flags into the first two bits
+	uint8 Flags = (bOnPlane ? 1 : 0) | (bFacingBackward ? 2 : 0);
+	Ar.SerializeBits(&Flags, 2);
+
+	bOnPlane = (Flags & 1) != 0;
+	bFacingBackward = (Flags & 2) != 0;
+
+	// Y is only sent if we've left the plane
+	USideScrollingCharacterMovementComponent::SerializeQuantizedAxis(Ar, Location.X, SideScrollingMovement::RepLocationScale);
+	USideScrollingCharacterMovementComponent::SerializeQuantizedAxis(Ar, Location.Z, SideScrollingMovement::RepLocationScale);
+	USideScrollingCharacterMovementComponent::SerializeQuantizedAxis(Ar, LinearVelocity.X, SideScrollingMovement::RepVelocityScale);
+	USideScrollingCharacterMovementComponent::SerializeQuantizedAxis(Ar, LinearVelocity.Z, SideScrollingMovement::RepVelocityScale);
+
+	if (!bOnPlane)
+	{
+		USideScrollingCharacterMovementComponent::SerializeQuantizedAxis(Ar, Location.Y, SideScrollingMovement::RepLocationScale);
+		USideScrollingCharacterMovementComponent::SerializeQuantizedAxis(Ar, LinearVelocity.Y, SideScrollingMovement::RepVelocityScale);
+	}
+	else if (Ar.IsLoading())
+	{
+		Location.Y = 0.0;
+		LinearVelocity.Y = 0.0;
+	}
+
+	bOutSuccess = !Ar.IsError();
+	return true;
+}
+
+void FSideScrollingNetworkMoveData::ClientFillNetworkMoveData(const FSavedMove_Character& ClientMove, ENetworkMoveType MoveType)
+{
+	FCharacterNetworkMoveData::ClientFillNetworkMoveData(ClientMove, MoveType);
+
+	// side-scrolling pawns don't rotate with the controller, so send the pawn's own facing instead
+	bFacingBackward = SideScrollingMovement::IsFacingBackward(ClientMove.SavedRotation.Yaw);
+}
+
+bool FSideScrollingNetworkMoveData::Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap, ENetworkMoveType MoveType)
+{
+	NetworkMoveType = MoveType;
+
+	const bool bIsSaving = Ar.IsSaving();
+
+	Ar << TimeStamp;
+
+	// acceleration is constrained to the plane, so its Y is normally zero
+	USideScrollingCharacterMovementComponent::SerializePlanarVector(Ar, Acceleration, 0.0, SideScrollingMovement::MoveAccelerationScale);
+
+	// location only needs its Y sent when it's relative to a movement base or off the plane
+	USideScrollingCharacterMovementComponent::SerializePlanarVector(Ar, Location, CharacterMovement.GetPlaneConstraintOrigin().Y, SideScrollingMovement::MoveLocationScale);
+
+	// only send which way the pawn is facing. The server points the control rotation the same way
+	uint8 FacingBit = bIsSaving && bFacingBackward;
+	Ar.SerializeBits(&FacingBit, 1);
+
+	if (!bIsSaving)
+	{
+		bFacingBackward = FacingBit != 0;
+		ControlRotation = SideScrollingMovement::GetFacingRotation(bFacingBackward);
+	}
+
+	SerializeOptionalValue<uint8>(bIsSaving, Ar, CompressedMoveFlags, 0);
+
+	if (MoveType == ENetworkMoveType::NewMove)
+	{
+		// movement base and ending movement mode are only used for error checking, so only send them with the final move
+		SerializeOptionalValue<UPrimitiveComponent*>(bIsSaving, Ar, MovementBase, nullptr);
+		SerializeOptionalValue<FName>(bIsSaving, Ar, MovementBaseBoneName, NAME_None);
+		SerializeOptionalValue<uint8>(bIsSaving, Ar, MovementMode, MOVE_Walking);
+	}
+
+	return !Ar.IsError();
+}
+
+FSideScrollingNetworkMoveDataContainer::FSideScrollingNetworkMoveDataContainer()
+{
+	NewMoveData = &MoveData[0];
+	PendingMoveData = &MoveData[1];
+	OldMoveData = &MoveData[2];
+}
+
+USideScrollingCharacterMovementComponent::USideScrollingCharacterMovementComponent()
+{
+	// lock movement to the XZ plane
+	SetPlaneConstraintNormal(FVector(0.0f, 1.0f, 0.0f));
+	bConstrainToPlane = true;
+
+	// we need InitializeComponent to set up the plane origin
+	bWantsInitializeComponent = true;
+
+	// use our packed move data
+	SetNetworkMoveDataContainer(MoveDataContainer);
+}
+
+void USideScrollingCharacterMovementComponent::InitializeComponent()
+{
+	Super::InitializeComponent();
+
+	// use the configured plane instead of anything local, like our spawn location, which may differ between machines
+	SetPlaneConstraintOrigin(FVector(0.0f, MovementPlaneY, 0.0f));
+}
+
+void USideScrollingCharacterMovementComponent::PackReplicatedMovement(const FRepMovement& RepMovement, FSideScrollingRepMovement& OutMovement) const
+{
+	// check if we're still on the plane, within quantization error
+	const double PlaneY = GetPlaneConstraintOrigin().Y;
+
+	OutMovement.bOnPlane = FMath::IsNearlyEqual(RepMovement.Location.Y, PlaneY, 0.5 / SideScrollingMovement::RepLocationScale)
+		&& FMath::IsNearlyZero(RepMovement.LinearVelocity.Y, 0.5 / SideScrollingMovement::RepVelocityScale);
+
+	// quantize ahead of serialization, so sub-millimeter jitter doesn't count as a replicated change
+	OutMovement.Location = (RepMovement.Location * SideScrollingMovement::RepLocationScale).GridSnap(1.0) / SideScrollingMovement::RepLocationScale;
+	OutMovement.LinearVelocity = (RepMovement.LinearVelocity * SideScrollingMovement::RepVelocityScale).GridSnap(1.0) / SideScrollingMovement::RepVelocityScale;
+
+	if (OutMovement.bOnPlane)
+	{
+		OutMovement.Location.Y = 0.0;
+		OutMovement.LinearVelocity.Y = 0.0;
+	}
+
+	OutMovement.bFacingBackward = SideScrollingMovement::IsFacingBackward(RepMovement.Rotation.Yaw);
+}
+
+void USideScrollingCharacterMovementComponent::UnpackReplicatedMovement(const FSideScrollingRepMovement& Movement, FRepMovement& OutRepMovement) const
+{
+	OutRepMovement.Location = Movement.Location;
+	OutRepMovement.LinearVelocity = Movement.LinearVelocity;
+	OutRepMovement.Rotation = SideScrollingMovement::GetFacingRotation(Movement.bFacingBackward);
+	OutRepMovement.AngularVelocity = FVector::ZeroVector;
+
+	// rebuild Y from the plane
+	if (Movement.bOnPlane)
+	{
+		OutRepMovement.Location.Y = GetPlaneConstraintOrigin().Y;
+		OutRepMovement.LinearVelocity.Y = 0.0;
+	}
+}
+
+void USideScrollingCharacterMovementComponent::SerializeQuantizedAxis(FArchive& Ar, double& Value, double Scale)
+{
+	// zigzag encode the quantized value so small negative numbers also pack into few bytes
+	uint32 Packed = 0;
+
+	if (Ar.IsSaving())
+	{
+		const int32 Quantized = FMath::RoundToInt32(Value * Scale);
+		Packed = (static_cast<uint32>(Quantized) << 1) ^ static_cast<uint32>(Quantized >> 31);
+	}
+
+	Ar.SerializeIntPacked(Packed);
+
+	if (Ar.IsLoading())
+	{
+		const int32 Quantized = static_cast<int32>(Packed >> 1) ^ -static_cast<int32>(Packed & 1);
+		Value = Quantized / Scale;
+	}
+}
+
+void USideScrollingCharacterMovementComponent::SerializePlanarVector(FArchive& Ar, FVector& Vector, double PlaneY, double Scale)
+{
+	// one bit tells whether the vector lies on the plane. If it doesn't, Y is sent as well
+	uint8 bOnPlane = Ar.IsSaving() && FMath::IsNearlyEqual(Vector.Y, PlaneY, 0.5 / Scale);
+	Ar.SerializeBits(&bOnPlane, 1);
+
+	SerializeQuantizedAxis(Ar, Vector.X, Scale);
+	SerializeQuantizedAxis(Ar, Vector.Z, Scale);
+
+	if (!bOnPlane)
+	{
+		SerializeQuantizedAxis(Ar, Vector.Y, Scale);
+	}
+	else if (Ar.IsLoading())
+	{
+		Vector.Y = PlaneY;
+	}
+}
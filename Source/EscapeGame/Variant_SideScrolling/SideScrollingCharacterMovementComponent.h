@@ -0,0 +1,117 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/CharacterMovementReplication.h"
+#include "SideScrollingCharacterMovementComponent.generated.h"
+
+/**
+ *  Compact replicated movement for pawns locked to the side-scrolling plane.
+ *  Only X and Z are sent for location and velocity. Y is rebuilt from the movement plane on the receiving end,
+ *  unless the pawn has been pushed off the plane, in which case it's sent as well.
+ *  Rotation is reduced to a single facing bit.
+ */
+USTRUCT()
+struct FSideScrollingRepMovement
+{
+	GENERATED_BODY()
+
+	/** Quantized location. Y is zero while on the plane */
+	UPROPERTY()
+	FVector Location = FVector::ZeroVector;
+
+	/** Quantized velocity. Y is zero while on the plane */
+	UPROPERTY()
+	FVector LinearVelocity = FVector::ZeroVector;
+
+	/** If true, the pawn is on the movement plane and Y isn't sent */
+	UPROPERTY()
+	bool bOnPlane = true;
+
+	/** If true, the pawn is facing down the negative X axis */
+	UPROPERTY()
+	bool bFacingBackward = false;
+
+	/** Custom net serialization */
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FSideScrollingRepMovement> : public TStructOpsTypeTraitsBase2<FSideScrollingRepMovement>
+{
+	enum
+	{
+		WithNetSerializer = true
+	};
+};
+
+/**
+ *  Packed client move data that only sends the X and Z components of acceleration and location,
+ *  and replaces the control rotation with the pawn's facing bit
+ */
+struct FSideScrollingNetworkMoveData : public FCharacterNetworkMoveData
+{
+	/** If true, the pawn ended the move facing down the negative X axis */
+	bool bFacingBackward = false;
+
+	/** Fills in the move, taking the facing from the pawn's rotation at the end of the move */
+	virtual void ClientFillNetworkMoveData(const FSavedMove_Character& ClientMove, ENetworkMoveType MoveType) override;
+
+	/** Serializes the move for the packed movement RPCs */
+	virtual bool Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap, ENetworkMoveType MoveType) override;
+};
+
+/** Holds the new, pending and old side-scrolling move data */
+struct FSideScrollingNetworkMoveDataContainer : public FCharacterNetworkMoveDataContainer
+{
+	/** Constructor */
+	FSideScrollingNetworkMoveDataContainer();
+
+	/** Storage for the new, pending and old moves */
+	FSideScrollingNetworkMoveData MoveData[3];
+};
+
+/**
+ *  Character movement for pawns locked to the XZ plane.
+ *  Both the client's saved moves and the server's replicated movement for simulated proxies
+ *  drop the Y axis and full rotations, roughly halving movement bandwidth.
+ */
+UCLASS(config=Game)
+class USideScrollingCharacterMovementComponent : public UCharacterMovementComponent
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Packed move data storage */
+	FSideScrollingNetworkMoveDataContainer MoveDataContainer;
+
+	/**
+	 *  Y of the movement plane. Comes from config or the class defaults, so server and clients always agree on it.
+	 *  Pawns away from this plane still replicate correctly, but need to send Y as well
+	 */
+	UPROPERTY(EditAnywhere, Config, Category="Side Scrolling", meta = (Units = "cm"))
+	float MovementPlaneY = 0.0f;
+
+public:
+
+	/** Constructor */
+	USideScrollingCharacterMovementComponent();
+
+	/** Sets the plane origin to the configured plane Y, so both server and clients rebuild the same Y */
+	virtual void InitializeComponent() override;
+
+	/** Packs the owner's replicated movement into the compact side-scrolling format. Server only */
+	void PackReplicatedMovement(const FRepMovement& RepMovement, FSideScrollingRepMovement& OutMovement) const;
+
+	/** Rebuilds the owner's full replicated movement from the compact side-scrolling format. Clients only */
+	void UnpackReplicatedMovement(const FSideScrollingRepMovement& Movement, FRepMovement& OutRepMovement) const;
+
+	/** Serializes a single quantized axis as a zigzag encoded packed integer */
+	static void SerializeQuantizedAxis(FArchive& Ar, double& Value, double Scale);
+
+	/** Serializes a vector's X and Z components. Y is only sent when it's not on the plane at PlaneY */
+	static void SerializePlanarVector(FArchive& Ar, FVector& Vector, double PlaneY, double Scale);
+};